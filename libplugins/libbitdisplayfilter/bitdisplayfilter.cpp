@@ -14,10 +14,8 @@ bool BitDisplayFilter::init(FilterContext* pcContext)
     if(pcSeq == NULL)
         return true;
 
-    foreach( ComFrame* pcFrame, pcSeq->getFramesInDisOrder())
-        foreach( ComCU* pcCU, pcFrame->getLCUs() )
-            m_dLCUAvgBit += pcCU->getBitCount();
-    m_dLCUAvgBit /= pcSeq->getFramesInDisOrder().size()*(pcSeq->getFramesInDisOrder().at(0)->getLCUs().size());
+    /// frame bits are the sum of LCU bits, summarized once per sequence
+    m_dLCUAvgBit = pcSeq->getStatistics().dAvgLCUBits;
 
     return true;
 
@@ -12,6 +12,9 @@ SOURCES         = bitdisplayfilter.cpp \
                   ../../src/model/common/comsequence.cpp \
                   ../../src/model/common/comframe.cpp \
                   ../../src/model/common/comcu.cpp \
+                  ../../src/model/common/comarena.cpp \
+                  ../../src/model/common/comblockgrid.cpp \
+                  ../../src/model/common/comstatistics.cpp \
                   ../../src/model/common/comtu.cpp
 
 include(../filterconfiggui.pri)
@@ -11,6 +11,9 @@ SOURCES         = cudisplayfilter.cpp \
                   ../../src/model/common/comsequence.cpp \
                   ../../src/model/common/comframe.cpp \
                   ../../src/model/common/comcu.cpp \
+                  ../../src/model/common/comarena.cpp \
+                  ../../src/model/common/comblockgrid.cpp \
+                  ../../src/model/common/comstatistics.cpp \
                   ../../src/model/common/comtu.cpp \
                   ../../src/model/selectionmanager.cpp
 
@@ -44,6 +44,9 @@
 #include "TLibCommon/SEI.h"
 
 #include <time.h>
+#if ENABLE_ANAYSIS_OUTPUT
+#include "TLibSysuAnalyzer/TSysuAnalyzerOutput.h"
+#endif
 
 extern Bool g_md5_mismatch; ///< top level flag to signal when there is a decode problem
 
@@ -57,6 +60,7 @@ static void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash*
 TDecGop::TDecGop()
 {
   m_dDecTime = 0;
+  m_uiPicBits = 0;
   m_pcSbacDecoders = NULL;
   m_pcBinCABACs = NULL;
 }
@@ -112,6 +116,14 @@ Void TDecGop::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic)
   //-- For time output for each slice
   long iBeforeTime = clock();
   
+#if ENABLE_ANAYSIS_OUTPUT
+  if( TSysuAnalyzerOutput::isPreScan() )
+  {
+    /// the slice data is counted, not decoded
+    m_uiPicBits += pcBitstream->getNumBitsRead() + pcBitstream->getNumBitsLeft();
+    return;
+  }
+#endif
   UInt uiStartCUAddr   = pcSlice->getSliceSegmentCurStartCUAddr();
 
   UInt uiSliceStartCuAddr = pcSlice->getSliceCurStartCUAddr();
@@ -174,40 +186,51 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   //-- For time output for each slice
   long iBeforeTime = clock();
 
-  // deblocking filter
-  Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
-  m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
-  m_pcLoopFilter->loopFilterPic( rpcPic );
-
-  if(pcSlice->getSPS()->getUseSAO())
+#if ENABLE_ANAYSIS_OUTPUT
+  Bool bPreScan = TSysuAnalyzerOutput::isPreScan();     ///< nothing was reconstructed
+#else
+  Bool bPreScan = false;
+#endif
+  if( !bPreScan )
   {
-    m_sliceStartCUAddress.push_back(rpcPic->getNumCUsInFrame()* rpcPic->getNumPartInCU());
-    rpcPic->createNonDBFilterInfo(m_sliceStartCUAddress, 0, &m_LFCrossSliceBoundaryFlag, rpcPic->getPicSym()->getNumTiles(), bLFCrossTileBoundary);
-  }
+    // deblocking filter
+    Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
+    m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
+    m_pcLoopFilter->loopFilterPic( rpcPic );
 
-  if( pcSlice->getSPS()->getUseSAO() )
-  {
+    if(pcSlice->getSPS()->getUseSAO())
     {
-      SAOParam *saoParam = rpcPic->getPicSym()->getSaoParam();
-      saoParam->bSaoFlag[0] = pcSlice->getSaoEnabledFlag();
-      saoParam->bSaoFlag[1] = pcSlice->getSaoEnabledFlagChroma();
-      m_pcSAO->setSaoLcuBasedOptimization(1);
-      m_pcSAO->createPicSaoInfo(rpcPic);
-      m_pcSAO->SAOProcess(saoParam);
-      m_pcSAO->PCMLFDisableProcess(rpcPic);
-      m_pcSAO->destroyPicSaoInfo();
+      m_sliceStartCUAddress.push_back(rpcPic->getNumCUsInFrame()* rpcPic->getNumPartInCU());
+      rpcPic->createNonDBFilterInfo(m_sliceStartCUAddress, 0, &m_LFCrossSliceBoundaryFlag, rpcPic->getPicSym()->getNumTiles(), bLFCrossTileBoundary);
     }
-  }
 
-  if(pcSlice->getSPS()->getUseSAO())
-  {
-    rpcPic->destroyNonDBFilterInfo();
-  }
+    if( pcSlice->getSPS()->getUseSAO() )
+    {
+      {
+        SAOParam *saoParam = rpcPic->getPicSym()->getSaoParam();
+        saoParam->bSaoFlag[0] = pcSlice->getSaoEnabledFlag();
+        saoParam->bSaoFlag[1] = pcSlice->getSaoEnabledFlagChroma();
+        m_pcSAO->setSaoLcuBasedOptimization(1);
+        m_pcSAO->createPicSaoInfo(rpcPic);
+        m_pcSAO->SAOProcess(saoParam);
+        m_pcSAO->PCMLFDisableProcess(rpcPic);
+        m_pcSAO->destroyPicSaoInfo();
+      }
+    }
 
-  rpcPic->compressMotion(); 
+    if(pcSlice->getSPS()->getUseSAO())
+    {
+      rpcPic->destroyNonDBFilterInfo();
+    }
+
+    rpcPic->compressMotion();
+  }
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
   if (!pcSlice->isReferenced()) c += 32;
 
+#if ENABLE_ANAYSIS_OUTPUT
+  TSysuAnalyzerOutput::getInstance()->endOfPicture();
+#endif
   //-- For time output for each slice
   printf("\nPOC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
                                                     pcSlice->getTLayer(),
@@ -227,7 +250,12 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
     }
     printf ("] ");
   }
-  if (m_decodedPictureHashSEIEnabled)
+  if (bPreScan)
+  {
+    printf ("[BITS %u] ", m_uiPicBits );
+    m_uiPicBits = 0;
+  }
+  if (m_decodedPictureHashSEIEnabled && !bPreScan)
   {
     SEIMessages pictureHashes = getSeisByType(rpcPic->getSEIs(), SEI::DECODED_PICTURE_HASH );
     const SEIDecodedPictureHash *hash = ( pictureHashes.size() > 0 ) ? (SEIDecodedPictureHash*) *(pictureHashes.begin()) : NULL;
@@ -80,6 +80,7 @@ private:
   
   TComSampleAdaptiveOffset*     m_pcSAO;
   Double                m_dDecTime;
+  UInt                  m_uiPicBits;        ///< slice NAL unit bits of the current picture (pre-scan)
   Int                   m_decodedPictureHashSEIEnabled;  ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
 
   //! list that contains the CU address of each slice plus the end address 
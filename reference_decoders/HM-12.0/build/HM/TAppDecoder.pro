@@ -11,7 +11,8 @@ TARGET = HM_120
 DESTDIR = $${OUT_PWD}/../../../../decoders
 
 DEFINES += _CONSOLE _CRT_SECURE_NO_WARNINGS
-INCLUDEPATH += ../../source/Lib
+INCLUDEPATH += ../../source/Lib \
+    ../../..
 msvc: INCLUDEPATH += ../../compat/msvc
 DEPENDPATH += .
 include(TAppDecoder.pri)
@@ -24,6 +25,10 @@ CONFIG(debug, debug|release){
 CONFIG(release, debug|release){
     LIBS += -lTLibDecoder  -lTAppCommon   -lTLibSysuAnalyzer -lTLibVideoIO  -lTLibCommon
 }
+# shm_open of the analyzer shared memory output
+unix:!macx: LIBS += -lrt
+# writer thread of the analyzer output
+unix: LIBS += -lpthread
 
 DEPENDPATH += ../../source/Lib \
     ../../../TLibSysuAnalyzer
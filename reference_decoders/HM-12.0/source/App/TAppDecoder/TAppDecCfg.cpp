@@ -68,7 +68,7 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   po::Options opts;
   opts.addOptions()
   ("help", do_help, false, "this help text")
-  ("BitstreamFile,b", cfg_BitstreamFile, string(""), "bitstream input file name")
+  ("BitstreamFile,b", cfg_BitstreamFile, string(""), "bitstream input file name ('-' for stdin)")
   ("ReconFile,o",     cfg_ReconFile,     string(""), "reconstructed YUV output file name\n"
                                                      "YUV writing is skipped if omitted")
   ("SkipFrames,s", m_iSkipFrame, 0, "number of frames to skip before random access")
@@ -81,6 +81,19 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   ("SEIpictureDigest", m_decodedPictureHashSEIEnabled, 1, "deprecated alias for SEIDecodedPictureHash")
   ("TarDecLayerIdSetFile,l", cfg_TargetDecLayerIdSetFile, string(""), "targetDecLayerIdSet file name. The file should include white space separated LayerId values to be decoded. Omitting the option or a value of -1 in the file decodes all layers.")
   ("RespectDefDispWindow,w", m_respectDefDispWindow, 0, "Only output content inside the default display window\n")
+#if ENABLE_ANAYSIS_OUTPUT
+  ("AnalysisOutputFormat", m_iAnalysisOutputFormat, 0, "analyzer output format\n"
+                                              "\t0: one text file per category\n"
+                                              "\t1: binary container decoder_analysis.bin\n"
+                                              "\t2: shared memory ring buffer (AnalysisShmName), no recon. file")
+  ("AnalysisShmName", m_strAnalysisShmName, string(""), "shared memory object created by the analyzer (AnalysisOutputFormat=2)")
+  ("AnalysisCategories", m_strAnalysisCategories, string(""), "comma separated analyzer output categories, empty for all of them\n"
+                                              "\tpred,cupu,mv,merge,intra,tu,bit_lcu,bit_scu,tile")
+  ("AnalysisFirstPOC", m_iAnalysisFirstPOC, 0, "first POC whose analyzer output is written")
+  ("AnalysisLastPOC", m_iAnalysisLastPOC, -1, "last POC whose analyzer output is written, -1 for no limit")
+  ("PreScan", m_bPreScan, false, "parse parameter sets and slice headers only, no picture is reconstructed or written\n"
+                                              "\t(the POC lines get the slice bits of every picture)")
+#endif
   ;
   po::setDefaults(opts);
   const list<const Char*>& argv_unhandled = po::scanArgv(opts, argc, (const Char**) argv);
@@ -96,6 +109,12 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
     return false;
   }
 
+#if ENABLE_ANAYSIS_OUTPUT
+  if( m_bPreScan )
+  {
+    cfg_ReconFile.clear();          ///< the picture buffers hold no samples
+  }
+#endif
   /* convert std::string to c string for compatability */
   m_pchBitstreamFile = cfg_BitstreamFile.empty() ? NULL : strdup(cfg_BitstreamFile.c_str());
   m_pchReconFile = cfg_ReconFile.empty() ? NULL : strdup(cfg_ReconFile.c_str());
@@ -43,6 +43,7 @@
 #endif // _MSC_VER > 1000
 
 #include "TLibCommon/CommonDef.h"
+#include <string>
 #include <vector>
 
 //! \ingroup TAppDecoder
@@ -68,6 +69,15 @@ protected:
   std::vector<Int> m_targetDecLayerIdSet;             ///< set of LayerIds to be included in the sub-bitstream extraction process.
   Int           m_respectDefDispWindow;               ///< Only output content inside the default display window 
 
+#if ENABLE_ANAYSIS_OUTPUT
+  Int           m_iAnalysisOutputFormat;              ///< analyzer output format: text files(0), binary container(1) or shared memory(2)
+  std::string   m_strAnalysisShmName;                 ///< shared memory object created by the analyzer
+  std::string   m_strAnalysisCategories;              ///< analyzer output categories, empty for all
+  Int           m_iAnalysisFirstPOC;                  ///< POC window of the analyzer output
+  Int           m_iAnalysisLastPOC;
+  Bool          m_bPreScan;                           ///< headers only, see TSysuAnalyzerOutput::setPreScan
+#endif
+
 public:
   TAppDecCfg()
   : m_pchBitstreamFile(NULL)
@@ -78,6 +88,12 @@ public:
   , m_iMaxTemporalLayer(-1)
   , m_decodedPictureHashSEIEnabled(0)
   , m_respectDefDispWindow(0)
+#if ENABLE_ANAYSIS_OUTPUT
+  , m_iAnalysisOutputFormat(0)
+  , m_iAnalysisFirstPOC(0)
+  , m_iAnalysisLastPOC(-1)
+  , m_bPreScan(false)
+#endif
   {}
   virtual ~TAppDecCfg() {}
   
@@ -40,14 +40,126 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <assert.h>
+#include <string.h>
+#include <algorithm>
+#include <streambuf>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 #include "TAppDecTop.h"
 #include "TLibDecoder/AnnexBread.h"
 #include "TLibDecoder/NALread.h"
+#if ENABLE_ANAYSIS_OUTPUT
+#include "TLibSysuAnalyzer/TSysuAnalyzerOutput.h"
+#endif
 
 //! \ingroup TAppDecoder
 //! \{
 
+#if ENABLE_ANAYSIS_OUTPUT
+#define STDIN_READ_SIZE   (1 << 16)   ///< bytes read from stdin at once
+
+/** stdin as the bitstream ("-b -"), e.g. access units the analyzer demuxes from a TS or MP4 file into a pipe.
+ *  The decoder loop seeks back to the position it got from tellg() before the last NAL unit (minus 3 bytes),
+ *  so the bytes from there on are kept in memory, a pipe can not seek itself.
+ */
+class TAppDecStdinBuf : public std::streambuf
+{
+public:
+  TAppDecStdinBuf()
+  : m_iBase( 0 )
+  , m_iKeep( 0 )
+  {
+#ifdef _WIN32
+    _setmode( _fileno( stdin ), _O_BINARY );
+#endif
+    xSetPos( 0 );
+  }
+
+protected:
+  virtual int_type underflow()
+  {
+    if( gptr() < egptr() )
+    {
+      return traits_type::to_int_type( *gptr() );
+    }
+    Int64 iPos = xTell();
+
+    // drop the bytes in front of the last position handed out by tellg()
+    size_t uiDrop = size_t( std::max<Int64>( 0, std::min<Int64>( m_iKeep, iPos ) - m_iBase ) );
+    m_acData.erase( m_acData.begin(), m_acData.begin() + uiDrop );
+    m_iBase += uiDrop;
+
+    size_t uiSize = m_acData.size();
+    m_acData.resize( uiSize + STDIN_READ_SIZE );
+    // whatever is in the pipe now, fread() would wait for all STDIN_READ_SIZE bytes
+    // (a followed file grows slowly, its pictures must not wait for the next ones)
+#ifdef _WIN32
+    int iRead = _read( _fileno( stdin ), &m_acData[uiSize], STDIN_READ_SIZE );
+#else
+    ssize_t iRead;
+    do
+    {
+      iRead = read( fileno( stdin ), &m_acData[uiSize], STDIN_READ_SIZE );
+    } while( iRead < 0 && errno == EINTR );
+#endif
+    size_t uiRead = iRead > 0 ? size_t( iRead ) : 0;
+    m_acData.resize( uiSize + uiRead );
+    xSetPos( iPos );
+    return uiRead == 0 ? traits_type::eof() : traits_type::to_int_type( *gptr() );
+  }
+
+  virtual pos_type seekoff( off_type iOff, std::ios_base::seekdir eDir, std::ios_base::openmode eMode )
+  {
+    if( eDir == std::ios_base::cur && iOff == 0 )
+    {
+      // tellg()
+      m_iKeep = std::max<Int64>( m_iKeep, xTell() - 3 );
+      return pos_type( off_type( xTell() ) );
+    }
+    if( eDir == std::ios_base::cur )
+    {
+      return seekpos( pos_type( off_type( xTell() + iOff ) ), eMode );
+    }
+    if( eDir == std::ios_base::beg )
+    {
+      return seekpos( pos_type( iOff ), eMode );
+    }
+    return pos_type( off_type( -1 ) );
+  }
+
+  virtual pos_type seekpos( pos_type iPos, std::ios_base::openmode )
+  {
+    Int64 iTarget = Int64( off_type( iPos ) );
+    if( iTarget < m_iBase || iTarget > m_iBase + Int64( m_acData.size() ) )
+    {
+      return pos_type( off_type( -1 ) );
+    }
+    xSetPos( iTarget );
+    return iPos;
+  }
+
+  Int64 xTell() const
+  {
+    return m_iBase + Int64( gptr() - eback() );
+  }
+
+  Void xSetPos( Int64 iPos )
+  {
+    char* pchData = m_acData.empty() ? NULL : &m_acData[0];
+    setg( pchData, pchData + ( iPos - m_iBase ), pchData + m_acData.size() );
+  }
+
+  std::vector<char> m_acData;    ///< stdin from m_iBase on
+  Int64             m_iBase;     ///< stream position of m_acData[0]
+  Int64             m_iKeep;     ///< the decoder may seek back to here
+};
+#endif
+
 // ====================================================================================================================
 // Constructor / destructor / initialization / destroy
 // ====================================================================================================================
@@ -92,8 +204,21 @@ Void TAppDecTop::decode()
   Int                 poc;
   TComList<TComPic*>* pcListPic = NULL;
 
+#if ENABLE_ANAYSIS_OUTPUT
+  // "-b -" reads the bitstream from stdin
+  Bool bStdin = ( strcmp( m_pchBitstreamFile, "-" ) == 0 );
+  TAppDecStdinBuf cStdinBuf;
+  ifstream cBitstreamFile;
+  if( !bStdin )
+  {
+    cBitstreamFile.open( m_pchBitstreamFile, ifstream::in | ifstream::binary );
+  }
+  istream bitstreamFile( bStdin ? (streambuf*)&cStdinBuf : cBitstreamFile.rdbuf() );
+  if (!bStdin && !cBitstreamFile.is_open())
+#else
   ifstream bitstreamFile(m_pchBitstreamFile, ifstream::in | ifstream::binary);
   if (!bitstreamFile)
+#endif
   {
     fprintf(stderr, "\nfailed to open bitstream file `%s' for reading\n", m_pchBitstreamFile);
     exit(EXIT_FAILURE);
@@ -102,6 +227,15 @@ Void TAppDecTop::decode()
   InputByteStream bytestream(bitstreamFile);
 
   // create & initialize internal classes
+#if ENABLE_ANAYSIS_OUTPUT
+  TSysuAnalyzerOutput::setOutputFormat( (SysuAnalyzerOutputFormat)m_iAnalysisOutputFormat );
+  TSysuAnalyzerOutput::setShmName( m_strAnalysisShmName );
+  if( !TSysuAnalyzerOutput::setCategories( m_strAnalysisCategories ) )
+    exit(EXIT_FAILURE);
+  TSysuAnalyzerOutput::setPOCRange( m_iAnalysisFirstPOC, m_iAnalysisLastPOC );
+  TSysuAnalyzerOutput::setPreScan( m_bPreScan );
+  setvbuf( stdout, NULL, _IOLBF, BUFSIZ );   ///< line buffered, the analyzer follows the POC lines while decoding
+#endif
   xCreateDecLib();
   xInitDecLib  ();
   m_iPOCLastDisplay += m_iSkipFrame;      // set the last displayed POC correctly for skip forward.
@@ -167,6 +301,11 @@ Void TAppDecTop::decode()
         if (!m_outputBitDepthY) { m_outputBitDepthY = g_bitDepthY; }
         if (!m_outputBitDepthC) { m_outputBitDepthC = g_bitDepthC; }
 
+#if ENABLE_ANAYSIS_OUTPUT
+        if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+          TSysuAnalyzerOutput::getInstance()->setPictureBitDepth( g_bitDepthY, g_bitDepthC, m_outputBitDepthY, m_outputBitDepthC );
+        else
+#endif
         m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepthY, m_outputBitDepthC, g_bitDepthY, g_bitDepthC ); // write mode
         openedReconFile = true;
 #if ENABLE_ANAYSIS_OUTPUT
@@ -196,6 +335,9 @@ Void TAppDecTop::decode()
   
   // destroy internal classes
   xDestroyDecLib();
+#if ENABLE_ANAYSIS_OUTPUT
+  TSysuAnalyzerOutput::destroyInstance();   ///< finish analyzer output files
+#endif
 }
 
 // ====================================================================================================================
@@ -274,6 +416,16 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
           const Window &conf = pcPicTop->getConformanceWindow();
           const Window &defDisp = m_respectDefDispWindow ? pcPicTop->getDefDisplayWindow() : Window();
           const Bool isTff = pcPicTop->isTopField();
+#if ENABLE_ANAYSIS_OUTPUT
+          if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+            TSysuAnalyzerOutput::getInstance()->writeOutPicture( pcPicTop->getPicYuvRec(), pcPicBottom->getPicYuvRec(),
+                                                               conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
+                                                               conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
+                                                               conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
+                                                               conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset(),
+                                                               isTff );
+          else
+#endif
           m_cTVideoIOYuvReconFile.write( pcPicTop->getPicYuvRec(), pcPicBottom->getPicYuvRec(),
                                         conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
                                         conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
@@ -342,6 +494,15 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
         {
           const Window &conf = pcPic->getConformanceWindow();
           const Window &defDisp = m_respectDefDispWindow ? pcPic->getDefDisplayWindow() : Window();
+#if ENABLE_ANAYSIS_OUTPUT
+          if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+            TSysuAnalyzerOutput::getInstance()->writeOutPicture( pcPic->getPicYuvRec(), NULL,
+                                                               conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
+                                                               conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
+                                                               conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
+                                                               conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset() );
+          else
+#endif
           m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(),
                                         conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
                                         conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
@@ -416,6 +577,16 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
           const Window &conf = pcPicTop->getConformanceWindow();
           const Window &defDisp = m_respectDefDispWindow ? pcPicTop->getDefDisplayWindow() : Window();
           const Bool isTff = pcPicTop->isTopField();
+#if ENABLE_ANAYSIS_OUTPUT
+          if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+            TSysuAnalyzerOutput::getInstance()->writeOutPicture( pcPicTop->getPicYuvRec(), pcPicBottom->getPicYuvRec(),
+                                                               conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
+                                                               conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
+                                                               conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
+                                                               conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset(),
+                                                               isTff );
+          else
+#endif
           m_cTVideoIOYuvReconFile.write( pcPicTop->getPicYuvRec(), pcPicBottom->getPicYuvRec(),
                                         conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
                                         conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
@@ -498,6 +669,15 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
         {
           const Window &conf = pcPic->getConformanceWindow();
           const Window &defDisp = m_respectDefDispWindow ? pcPic->getDefDisplayWindow() : Window();
+#if ENABLE_ANAYSIS_OUTPUT
+          if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+            TSysuAnalyzerOutput::getInstance()->writeOutPicture( pcPic->getPicYuvRec(), NULL,
+                                                               conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
+                                                               conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
+                                                               conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
+                                                               conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset() );
+          else
+#endif
           m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(),
                                         conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
                                         conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
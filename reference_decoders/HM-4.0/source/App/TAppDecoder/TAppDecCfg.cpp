@@ -75,6 +75,17 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   ("SEIpictureDigest", m_pictureDigestEnabled, true, "Control handling of picture_digest SEI messages\n"
                                               "\t1: check\n"
                                               "\t0: ignore")
+#if ENABLE_ANAYSIS_OUTPUT
+  ("AnalysisOutputFormat", m_iAnalysisOutputFormat, 0, "analyzer output format\n"
+                                              "\t0: one text file per category\n"
+                                              "\t1: binary container decoder_analysis.bin\n"
+                                              "\t2: shared memory ring buffer (AnalysisShmName), no recon. file")
+  ("AnalysisShmName", m_strAnalysisShmName, string(""), "shared memory object created by the analyzer (AnalysisOutputFormat=2)")
+  ("AnalysisCategories", m_strAnalysisCategories, string(""), "comma separated analyzer output categories, empty for all of them\n"
+                                              "\tpred,cupu,mv,merge,intra,tu,bit_lcu,bit_scu,tile")
+  ("AnalysisFirstPOC", m_iAnalysisFirstPOC, 0, "first POC whose analyzer output is written")
+  ("AnalysisLastPOC", m_iAnalysisLastPOC, -1, "last POC whose analyzer output is written, -1 for no limit")
+#endif
   ;
 
   po::setDefaults(opts);
@@ -44,6 +44,9 @@
 #include "TAppDecTop.h"
 #include "TLibDecoder/AnnexBread.h"
 #include "TLibDecoder/NALread.h"
+#if ENABLE_ANAYSIS_OUTPUT
+#include "TLibSysuAnalyzer/TSysuAnalyzerOutput.h"
+#endif
 
 //! \ingroup TAppDecoder
 //! \{
@@ -93,6 +96,14 @@ Void TAppDecTop::decode()
   InputByteStream bytestream(bitstreamFile);
 
   // create & initialize internal classes
+#if ENABLE_ANAYSIS_OUTPUT
+  TSysuAnalyzerOutput::setOutputFormat( (SysuAnalyzerOutputFormat)m_iAnalysisOutputFormat );
+  TSysuAnalyzerOutput::setShmName( m_strAnalysisShmName );
+  if( !TSysuAnalyzerOutput::setCategories( m_strAnalysisCategories ) )
+    exit(EXIT_FAILURE);
+  TSysuAnalyzerOutput::setPOCRange( m_iAnalysisFirstPOC, m_iAnalysisLastPOC );
+  setvbuf( stdout, NULL, _IOLBF, BUFSIZ );   ///< line buffered, the analyzer follows the POC lines while decoding
+#endif
   xCreateDecLib();
   xInitDecLib  ();
   m_iPOCLastDisplay += m_iSkipFrame;      // set the last displayed POC correctly for skip forward.
@@ -149,6 +160,11 @@ Void TAppDecTop::decode()
         if ( m_outputBitDepth == 0 )
           m_outputBitDepth = g_uiBitDepth + g_uiBitIncrement;
 
+#if ENABLE_ANAYSIS_OUTPUT
+        if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+          TSysuAnalyzerOutput::getInstance()->setPictureBitDepth( g_uiBitDepth + g_uiBitIncrement, g_uiBitDepth + g_uiBitIncrement, m_outputBitDepth, m_outputBitDepth );
+        else
+#endif
         m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, g_uiBitDepth + g_uiBitIncrement ); // write mode
 #if ENABLE_ANAYSIS_OUTPUT
     m_cTVideoIOYuvResiFile.open( "resi_yuv.yuv", true, 16, 16 ); // residual yuv file (16bit ***8bit-8bit = 16bit**)
@@ -165,6 +181,9 @@ Void TAppDecTop::decode()
   
   // destroy internal classes
   xDestroyDecLib();
+#if ENABLE_ANAYSIS_OUTPUT
+  TSysuAnalyzerOutput::destroyInstance();   ///< finish analyzer output files
+#endif
 }
 
 // ====================================================================================================================
@@ -214,6 +233,11 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic )
       // write to file
       if ( m_pchReconFile )
       {
+#if ENABLE_ANAYSIS_OUTPUT
+        if( TSysuAnalyzerOutput::getInstance()->isShmOutput() )
+          TSysuAnalyzerOutput::getInstance()->writeOutPicture( pcPic->getPicYuvRec(), NULL, 0, pcPic->getSlice(0)->getSPS()->getPad()[0], 0, pcPic->getSlice(0)->getSPS()->getPad()[1] );
+        else
+#endif
         m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(), pcPic->getSlice(0)->getSPS()->getPad() );
 #if ENABLE_ANAYSIS_OUTPUT
         m_cTVideoIOYuvResiFile.write( pcPic->getPicYuvResi(), pcPic->getSlice(0)->getSPS()->getPad() );
@@ -1,5 +1,10 @@
 
 HEADERS += ../../../TLibSysuAnalyzer/TComSysuCuMDTools.h \
-    ../../../TLibSysuAnalyzer/TSysuAnalyzerOutput.h
+    ../../../TLibSysuAnalyzer/TSysuAnalyzerOutput.h \
+    ../../../TLibSysuAnalyzer/TSysuBufferedWriter.h \
+    ../../../TLibSysuAnalyzer/TSysuShmRing.h \
+    ../../../TLibSysuAnalyzer/TSysuAnalyzerSink.h
 SOURCES += ../../../TLibSysuAnalyzer/TComSysuCuMDTools.cpp \
-    ../../../TLibSysuAnalyzer/TSysuAnalyzerOutput.cpp
+    ../../../TLibSysuAnalyzer/TSysuAnalyzerOutput.cpp \
+    ../../../TLibSysuAnalyzer/TSysuBufferedWriter.cpp \
+    ../../../TLibSysuAnalyzer/TSysuShmRing.cpp
@@ -43,6 +43,7 @@
 #endif // _MSC_VER > 1000
 
 #include "TLibCommon/CommonDef.h"
+#include <string>
 
 //! \ingroup TAppDecoder
 //! \{
@@ -63,6 +64,14 @@ protected:
   Int           m_iMaxTemporalLayer;                  ///< maximum temporal layer to be decoded
   bool m_pictureDigestEnabled; ///< enable(1)/disable(0) acting on SEI picture_digest message
   
+#if ENABLE_ANAYSIS_OUTPUT
+  Int           m_iAnalysisOutputFormat;              ///< analyzer output format: text files(0), binary container(1) or shared memory(2)
+  std::string   m_strAnalysisShmName;                 ///< shared memory object created by the analyzer
+  std::string   m_strAnalysisCategories;              ///< analyzer output categories, empty for all
+  Int           m_iAnalysisFirstPOC;                  ///< POC window of the analyzer output
+  Int           m_iAnalysisLastPOC;
+#endif
+
 public:
   TAppDecCfg()          {}
   virtual ~TAppDecCfg() {}
@@ -44,6 +44,9 @@ extern bool g_md5_mismatch; ///< top level flag to signal when there is a decode
 #include "TDecBinCoderCABAC.h"
 #include "libmd5/MD5.h"
 #include "TLibCommon/SEI.h"
+#if ENABLE_ANAYSIS_OUTPUT
+#include "TLibSysuAnalyzer/TSysuAnalyzerOutput.h"
+#endif
 
 #include <time.h>
 
@@ -276,6 +279,9 @@ Void TDecGop::decompressGop(TComInputBitstream* pcBitstream, TComPic*& rpcPic, B
     Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
     if (!pcSlice->isReferenced()) c += 32;
     
+#if ENABLE_ANAYSIS_OUTPUT
+    TSysuAnalyzerOutput::getInstance()->endOfPicture();
+#endif
     //-- For time output for each slice
     printf("\nPOC %4d TId: %1d ( %c-SLICE, QP%3d ) ",
           pcSlice->getPOC(),
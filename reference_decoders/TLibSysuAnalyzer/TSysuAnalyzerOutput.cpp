@@ -1,24 +1,148 @@
 #include "TSysuAnalyzerOutput.h"
+#include <cstdio>
 
 TSysuAnalyzerOutput* TSysuAnalyzerOutput::m_instance = NULL;
+SysuAnalyzerOutputFormat TSysuAnalyzerOutput::m_eOutputFormat = SYSU_OUTPUT_TEXT;
+std::string TSysuAnalyzerOutput::m_strShmName;
+TSysuAnalyzerSink* TSysuAnalyzerOutput::m_pcSink = NULL;
+Bool TSysuAnalyzerOutput::m_abCategoryEnabled[SYSU_CAT_NUM] = { true, true, true, true, true, true, true, true, true, true };
+Int  TSysuAnalyzerOutput::m_iFirstPoc = 0;
+Int  TSysuAnalyzerOutput::m_iLastPoc = -1;
+Bool TSysuAnalyzerOutput::m_bPOCRange = false;
+Bool TSysuAnalyzerOutput::m_bPreScan = false;
+
+/// text file name of each category
+static const char* s_apchCategoryFile[SYSU_CAT_NUM] =
+{
+  "decoder_pred.txt",
+  "decoder_cupu.txt",
+  "decoder_mv.txt",
+  "decoder_merge.txt",
+  "decoder_intra.txt",
+  "decoder_tu.txt",
+  "decoder_bit_lcu.txt",
+  "decoder_bit_scu.txt",
+  "encoder_me.txt",
+  "decoder_tile.txt"
+};
+
+/// category names of setCategories()
+static const char* s_apchCategoryName[SYSU_CAT_NUM] =
+{
+  "pred", "cupu", "mv", "merge", "intra", "tu", "bit_lcu", "bit_scu", "me", "tile"
+};
+
+/// decimal text of iValue, no stream and no temporary string per value
+static Void xAppendInt( std::string& rstrLine, Int iValue )
+{
+  char achDigits[12];
+  char* pchEnd = achDigits + sizeof(achDigits);
+  char* pch = pchEnd;
+  UInt uiValue = iValue < 0 ? 0u - (UInt)iValue : (UInt)iValue;
+  do
+  {
+    *--pch = (char)( '0' + uiValue % 10 );
+    uiValue /= 10;
+  } while( uiValue != 0 );
+  if( iValue < 0 )
+    *--pch = '-';
+  rstrLine.append(pch, pchEnd - pch);
+}
+
+/// "<iPoc,iKey>"
+static Void xAppendHead( std::string& rstrLine, Int iPoc, Int iKey )
+{
+  rstrLine.push_back('<');
+  xAppendInt(rstrLine, iPoc);
+  rstrLine.push_back(',');
+  xAppendInt(rstrLine, iKey);
+  rstrLine.push_back('>');
+}
+
+Bool TSysuAnalyzerOutput::setCategories( const std::string& rstrCategories )
+{
+  Bool bAll = rstrCategories.empty();
+  for(Int i = 0; i < SYSU_CAT_NUM; i++)
+    m_abCategoryEnabled[i] = bAll;
+  if( bAll )
+    return true;
+
+  size_t uiStart = 0;
+  while( uiStart <= rstrCategories.size() )
+  {
+    size_t uiEnd = rstrCategories.find(',', uiStart);
+    if( uiEnd == std::string::npos )
+      uiEnd = rstrCategories.size();
+    std::string strName = rstrCategories.substr(uiStart, uiEnd-uiStart);
+    Int iCategory = 0;
+    while( iCategory < SYSU_CAT_NUM && strName != s_apchCategoryName[iCategory] )
+      iCategory++;
+    if( iCategory == SYSU_CAT_NUM )
+    {
+      fprintf(stderr, "\nunknown analyzer output category `%s'\n", strName.c_str());
+      return false;
+    }
+    m_abCategoryEnabled[iCategory] = true;
+    uiStart = uiEnd + 1;
+  }
+
+  /// every per-LCU category is attached to the CU&PU tree
+  for(Int i = 0; i < SYSU_CAT_NUM; i++)
+  {
+    if( m_abCategoryEnabled[i] && i != SYSU_CAT_ME && i != SYSU_CAT_TILE )
+      m_abCategoryEnabled[SYSU_CAT_CUPU] = true;
+  }
+  return true;
+}
 
 TSysuAnalyzerOutput::TSysuAnalyzerOutput()
+: m_bFrameOpen(false)
+, m_iFramePoc(0)
+, m_uiFrameLCUNum(0)
+, m_uiBinOffset(0)
 {
+  m_aiInternalBitDepth[0] = m_aiInternalBitDepth[1] = 8;
+  m_aiFileBitDepth[0] = m_aiFileBitDepth[1] = 8;
+
+  if( m_pcSink != NULL )
+    return;                           ///< in-process decoding, nothing on disk
 
   m_cSpsOut.open     ("decoder_sps.txt",  ios::out);
-  m_cPredOutput.open ("decoder_pred.txt", ios::out);
-  m_cCUPUOutput.open ("decoder_cupu.txt", ios::out);
-  m_cMVOutput.open   ("decoder_mv.txt",   ios::out);
-  m_cMergeOutput.open("decoder_merge.txt",ios::out);
-  m_cIntraOutput.open("decoder_intra.txt",ios::out);
-  m_cTUOutput.open   ("decoder_tu.txt",   ios::out);
-  m_cMEOutput.open   ("encoder_me.txt",   ios::out);
-  m_cBitOutputLCU.open  ("decoder_bit_lcu.txt",  ios::out);
-  m_cBitOutputSCU.open  ("decoder_bit_scu.txt",  ios::out);
 
-#if ( HM_VERSION > 40)
-  m_cTileOutPut.open("decoder_tile.txt", ios::out);
+  if( m_eOutputFormat == SYSU_OUTPUT_SHM && !m_cShmRing.attach(m_strShmName) )
+  {
+    fprintf(stderr, "\nfall back to text analyzer output\n");
+    m_eOutputFormat = SYSU_OUTPUT_TEXT;
+  }
+
+  if( m_eOutputFormat == SYSU_OUTPUT_SHM )
+  {
+    /// nothing on disk except decoder_sps.txt
+  }
+  else if( m_eOutputFormat == SYSU_OUTPUT_BINARY )
+  {
+    m_cWriter.open(0, "decoder_analysis.bin", true);
+
+    std::vector<UChar> cHeader;
+    const char* pchMagic = "SYSUANA";
+    cHeader.insert(cHeader.end(), pchMagic, pchMagic+8);   ///< including '\0'
+    xPutUInt(cHeader, SYSU_BIN_VERSION);
+    xPutUInt(cHeader, SYSU_CAT_NUM);
+    m_cWriter.write(0, (const char*)&cHeader[0], cHeader.size());
+    m_uiBinOffset += cHeader.size();
+  }
+  else
+  {
+    for(Int i = 0; i < SYSU_CAT_NUM; i++)
+    {
+#if ( HM_VERSION <= 40)
+      if( i == SYSU_CAT_TILE )
+        continue;
 #endif
+      if( m_abCategoryEnabled[i] )              ///< the parsers take a missing file for a disabled category
+        m_cWriter.open(i, s_apchCategoryFile[i]);
+    }
+  }
 
 
 }
@@ -29,6 +153,8 @@ TSysuAnalyzerOutput::TSysuAnalyzerOutput()
 void TSysuAnalyzerOutput::writeOutTileInfo(TComPic * pcPic)
 {
     int iPoc = pcPic ->getPOC();
+    if( m_pcSink == NULL && ( !m_abCategoryEnabled[SYSU_CAT_TILE] || !xIsRecorded(iPoc) ) )
+      return;
     int iTileNumRows =  pcPic ->getPicSym() ->getNumRowsMinus1()+1;
     int iTileNumCols = pcPic ->getPicSym() ->getNumColumnsMinus1()+1;
 
@@ -49,8 +175,33 @@ void TSysuAnalyzerOutput::writeOutTileInfo(TComPic * pcPic)
 
              uiFirstCUAddr = pcPic ->getPicSym()->getTComTile(uiTileIdx) ->getFirstCUAddr();
 
-             m_cTileOutPut << "<" << iPoc << "," << (iTileNumCols )* (iTileNumRows )<< ">"
-                  << " " << uiFirstCUAddr << " " << uiTileWidth << " " << uiTileHeight << endl;
+             if( m_pcSink != NULL )
+             {
+               m_pcSink->onTile(iPoc, iTileNumCols * iTileNumRows, uiFirstCUAddr, uiTileWidth, uiTileHeight);
+             }
+             else if( m_eOutputFormat == SYSU_OUTPUT_BINARY )
+             {
+               if( !m_bFrameOpen || m_iFramePoc != iPoc )
+                 xOpenFrame(iPoc);
+               std::vector<Int>& riEntries = m_aiFrameEntries[SYSU_CAT_TILE];
+               riEntries.push_back((iTileNumCols )* (iTileNumRows ));
+               riEntries.push_back(3);
+               riEntries.push_back(uiFirstCUAddr);
+               riEntries.push_back(uiTileWidth);
+               riEntries.push_back(uiTileHeight);
+             }
+             else
+             {
+               std::string& rstrLine = xBeginLine(SYSU_CAT_TILE);
+               xAppendHead(rstrLine, iPoc, (iTileNumCols )* (iTileNumRows ));
+               rstrLine.push_back(' ');
+               xAppendInt(rstrLine, uiFirstCUAddr);
+               rstrLine.push_back(' ');
+               xAppendInt(rstrLine, uiTileWidth);
+               rstrLine.push_back(' ');
+               xAppendInt(rstrLine, uiTileHeight);
+               xEndLine(SYSU_CAT_TILE);
+             }
 
 
            }
@@ -66,32 +217,261 @@ void TSysuAnalyzerOutput::writeOutCUInfo   ( TComDataCU* pcCU )
   Int iPoc = pcCU->getSlice()->getPOC();
   Int iAddr = pcCU->getAddr();
   Int iTotalNumPart = pcCU->getTotalNumPart();
+  if( m_pcSink == NULL && !xIsRecorded(iPoc) )
+    return;
 
-
-  m_cPredOutput << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out prediction info
-  m_cCUPUOutput << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out CU & PU splitting info
-  m_cMVOutput   << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out me info
-  m_cMergeOutput<< "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out merge mode info
-  m_cIntraOutput<< "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out intra mode info
-  m_cTUOutput   << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out TU mode info
-  m_cBitOutputLCU << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out bit info
-  m_cBitOutputSCU << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out bit info
-  m_cMEOutput   << "<" << iPoc << "," << iAddr << ">" << " ";  ///< Write out ME info  
+  for(Int i = 0; i < SYSU_CAT_NUM; i++)
+    m_aiLCUValues[i].clear();
 
   xWriteOutCUInfo  ( pcCU, iTotalNumPart, 0, 0 );   ///< Recursive write Prediction, CU, PU, Merge, Intra, ME
-  m_cBitOutputLCU << pcCU->getTotalBits(); ///< Bit info
+  m_aiLCUValues[SYSU_CAT_BIT_LCU].push_back(pcCU->getTotalBits()); ///< Bit info
   for(int i = 0; i < aiCUBits.size(); i++)
-    m_cBitOutputSCU << aiCUBits.at(i) << " "; ///< Bit info
-
-  m_cPredOutput << endl;
-  m_cCUPUOutput << endl;
-  m_cMVOutput   << endl;
-  m_cMergeOutput<< endl;
-  m_cIntraOutput<< endl;
-  m_cTUOutput   << endl;
-  m_cBitOutputLCU  << endl;
-  m_cBitOutputSCU  << endl;
-  m_cMEOutput   << endl;
+    m_aiLCUValues[SYSU_CAT_BIT_SCU].push_back(aiCUBits.at(i)); ///< Bit info
+
+  xWriteOutLCU(iPoc, iAddr);
+}
+
+Void TSysuAnalyzerOutput::xWriteOutLCU( Int iPoc, Int iAddr )
+{
+  if( m_pcSink != NULL )
+  {
+    m_pcSink->onLCU(iPoc, iAddr, m_aiLCUValues);
+    return;
+  }
+
+  if( m_eOutputFormat == SYSU_OUTPUT_BINARY )
+  {
+    /// LCUs of one picture are consecutive, a new POC starts a new frame chunk
+    if( !m_bFrameOpen || m_iFramePoc != iPoc )
+      xOpenFrame(iPoc);
+
+    for(Int i = 0; i < SYSU_CAT_NUM; i++)
+    {
+      if( i == SYSU_CAT_ME || i == SYSU_CAT_TILE || !m_abCategoryEnabled[i] )
+        continue;                   ///< a disabled category is an empty column
+      std::vector<Int>& riEntries = m_aiFrameEntries[i];
+      riEntries.push_back(iAddr);
+      riEntries.push_back((Int)m_aiLCUValues[i].size());
+      riEntries.insert(riEntries.end(), m_aiLCUValues[i].begin(), m_aiLCUValues[i].end());
+    }
+    m_uiFrameLCUNum++;
+    return;
+  }
+
+  for(Int i = 0; i < SYSU_CAT_NUM; i++)
+  {
+    if( i == SYSU_CAT_TILE || !m_abCategoryEnabled[i] )
+      continue;
+    const std::vector<Int>& riValues = m_aiLCUValues[i];
+    std::string& rstrLine = xBeginLine(i);
+    xAppendHead(rstrLine, iPoc, iAddr);
+    rstrLine.push_back(' ');
+    if( i == SYSU_CAT_BIT_LCU )
+    {
+      xAppendInt(rstrLine, riValues.at(0));    ///< single value, no trailing space
+    }
+    else
+    {
+      for(size_t j = 0; j < riValues.size(); j++)
+      {
+        xAppendInt(rstrLine, riValues[j]);
+        rstrLine.push_back(' ');
+      }
+    }
+    xEndLine(i);
+  }
+}
+
+std::string& TSysuAnalyzerOutput::xBeginLine( Int iCategory )
+{
+  if( m_eOutputFormat == SYSU_OUTPUT_SHM )
+  {
+    m_strLine.clear();
+    return m_strLine;
+  }
+  /// formatted right into the block of the file, no flush per line (see TSysuBufferedWriter)
+  return m_cWriter.beginAppend(iCategory);
+}
+
+Void TSysuAnalyzerOutput::xEndLine( Int iCategory )
+{
+  if( m_eOutputFormat == SYSU_OUTPUT_SHM )
+  {
+    m_strLine.push_back('\n');
+    m_cShmRing.writeRecord(iCategory, (const UChar*)m_strLine.data(), (UInt)m_strLine.size());
+    return;
+  }
+  m_cWriter.beginAppend(iCategory).push_back('\n');
+  m_cWriter.endAppend(iCategory);
+}
+
+Void TSysuAnalyzerOutput::setPictureBitDepth( Int iInternalBitDepthY, Int iInternalBitDepthC, Int iFileBitDepthY, Int iFileBitDepthC )
+{
+  m_aiInternalBitDepth[0] = iInternalBitDepthY;
+  m_aiInternalBitDepth[1] = iInternalBitDepthC;
+  m_aiFileBitDepth[0] = iFileBitDepthY;
+  m_aiFileBitDepth[1] = iFileBitDepthC;
+}
+
+Void TSysuAnalyzerOutput::writeOutPicture( TComPicYuv* pcPicTop, TComPicYuv* pcPicBottom,
+                                           Int iCropLeft, Int iCropRight, Int iCropTop, Int iCropBottom, Bool bTopFieldFirst )
+{
+  if( m_pcSink == NULL && m_eOutputFormat != SYSU_OUTPUT_SHM )
+    return;
+
+  /// same samples as TVideoIOYuv::write
+  Bool b16Bit = m_aiFileBitDepth[0] > 8 || m_aiFileBitDepth[1] > 8;
+  Int iWidth  = pcPicTop->getWidth()  - iCropLeft - iCropRight;
+  Int iHeight = pcPicTop->getHeight() - iCropTop  - iCropBottom;
+  m_aucPicture.clear();
+
+  TComPicYuv* pcFirstField  = ( pcPicBottom != NULL && !bTopFieldFirst ) ? pcPicBottom : pcPicTop;
+  TComPicYuv* pcSecondField = ( pcPicBottom != NULL && !bTopFieldFirst ) ? pcPicTop : pcPicBottom;
+  for(Int iComp = 0; iComp < 3; iComp++)
+  {
+    Int iChroma = ( iComp == 0 ) ? 0 : 1;
+    Int iStride = ( iComp == 0 ) ? pcPicTop->getStride() : pcPicTop->getCStride();
+    Int iOffset = ( iCropLeft >> iChroma ) + ( iCropTop >> iChroma ) * iStride;
+    Pel* pcSecond = NULL;
+    Pel* pcPlane = NULL;
+    switch( iComp )
+    {
+    case 0:  pcPlane = pcFirstField->getLumaAddr(); if( pcSecondField ) pcSecond = pcSecondField->getLumaAddr(); break;
+    case 1:  pcPlane = pcFirstField->getCbAddr();   if( pcSecondField ) pcSecond = pcSecondField->getCbAddr();   break;
+    default: pcPlane = pcFirstField->getCrAddr();   if( pcSecondField ) pcSecond = pcSecondField->getCrAddr();   break;
+    }
+    xPackPlane( m_aucPicture, pcPlane + iOffset, pcSecond ? pcSecond + iOffset : NULL, iStride,
+                iWidth >> iChroma, iHeight >> iChroma,
+                m_aiInternalBitDepth[iChroma] - m_aiFileBitDepth[iChroma], (1 << m_aiFileBitDepth[iChroma]) - 1, b16Bit );
+  }
+  if( m_pcSink != NULL )
+    m_pcSink->onPicture(&m_aucPicture[0], (UInt)m_aucPicture.size());
+  else
+    m_cShmRing.writeRecord(SYSU_SHM_REC_PICTURE, &m_aucPicture[0], (UInt)m_aucPicture.size());
+}
+
+Void TSysuAnalyzerOutput::endOfPicture()
+{
+  /// the binary container is read after decoding, the shared memory and a sink get every record at once
+  if( m_pcSink == NULL && m_eOutputFormat == SYSU_OUTPUT_TEXT )
+    m_cWriter.flush();
+}
+
+Void TSysuAnalyzerOutput::writeOutFrameInfo( TComSlice* pcSlice, Double dDecTime )
+{
+  if( m_pcSink == NULL )
+    return;                           ///< the decoder log has this line already
+
+  std::vector<Int> aiRefPOC[2];
+  for(Int iRefList = 0; iRefList < 2; iRefList++)
+  {
+    for(Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
+      aiRefPOC[iRefList].push_back(pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+  }
+  m_pcSink->onFrame(pcSlice->getPOC(), dDecTime, aiRefPOC[0], aiRefPOC[1]);
+}
+
+Void TSysuAnalyzerOutput::xPackPlane( std::vector<UChar>& rBuffer, Pel* pcTop, Pel* pcBottom, Int iStride,
+                                      Int iWidth, Int iHeight, Int iShift, Int iMaxVal, Bool b16Bit )
+{
+  /// a field pair is interleaved line by line
+  Int iFieldNum = ( pcBottom != NULL ) ? 2 : 1;
+  for(Int y = 0; y < iHeight * iFieldNum; y++)
+  {
+    Pel* pcLine = ( y % iFieldNum == 0 ? pcTop : pcBottom ) + ( y / iFieldNum ) * iStride;
+    for(Int x = 0; x < iWidth; x++)
+    {
+      Int iVal = pcLine[x];
+      if( iShift > 0 )
+        iVal = ( iVal + ( 1 << ( iShift - 1 ) ) ) >> iShift;
+      else if( iShift < 0 )
+        iVal <<= -iShift;
+      iVal = iVal < 0 ? 0 : ( iVal > iMaxVal ? iMaxVal : iVal );
+      rBuffer.push_back( (UChar)( iVal & 0xFF ) );
+      if( b16Bit )
+        rBuffer.push_back( (UChar)( ( iVal >> 8 ) & 0xFF ) );
+    }
+  }
+}
+
+Void TSysuAnalyzerOutput::xPushMV( std::vector<Int>& riValues, Int iRefPOC, TComMv& rcMV )
+{
+  riValues.push_back(iRefPOC);
+  riValues.push_back(rcMV.getHor());
+  riValues.push_back(rcMV.getVer());
+}
+
+Void TSysuAnalyzerOutput::xOpenFrame( Int iPoc )
+{
+  if( m_bFrameOpen )
+    xWriteFrameChunk();
+  m_bFrameOpen = true;
+  m_iFramePoc = iPoc;
+  m_uiFrameLCUNum = 0;
+}
+
+Void TSysuAnalyzerOutput::xWriteFrameChunk()
+{
+  UInt uiPayload = 8;
+  for(Int i = 0; i < SYSU_CAT_NUM; i++)
+    uiPayload += 8 + 4 * (UInt)m_aiFrameEntries[i].size();
+
+  std::vector<UChar> cChunk;
+  cChunk.reserve(8 + uiPayload);
+  xPutUInt(cChunk, SYSU_BIN_TAG_FRAME);
+  xPutUInt(cChunk, uiPayload);
+  xPutUInt(cChunk, (UInt)m_iFramePoc);
+  xPutUInt(cChunk, m_uiFrameLCUNum);
+  for(Int i = 0; i < SYSU_CAT_NUM; i++)
+  {
+    std::vector<Int>& riEntries = m_aiFrameEntries[i];
+    xPutUInt(cChunk, i);
+    xPutUInt(cChunk, 4 * (UInt)riEntries.size());
+    for(size_t j = 0; j < riEntries.size(); j++)
+      xPutUInt(cChunk, (UInt)riEntries[j]);
+    riEntries.clear();
+  }
+  m_cWriter.write(0, (const char*)&cChunk[0], cChunk.size());
+
+  m_aiIndexPoc.push_back(m_iFramePoc);
+  m_auiIndexLCUNum.push_back(m_uiFrameLCUNum);
+  m_auiIndexOffset.push_back(m_uiBinOffset);
+  m_uiBinOffset += cChunk.size();
+  m_bFrameOpen = false;
+}
+
+Void TSysuAnalyzerOutput::xWriteIndexChunk()
+{
+  std::vector<UChar> cChunk;
+  UInt uiFrameNum = (UInt)m_aiIndexPoc.size();
+  xPutUInt(cChunk, SYSU_BIN_TAG_INDEX);
+  xPutUInt(cChunk, 16 * uiFrameNum);
+  for(UInt i = 0; i < uiFrameNum; i++)
+  {
+    xPutUInt(cChunk, (UInt)m_aiIndexPoc[i]);
+    xPutUInt(cChunk, m_auiIndexLCUNum[i]);
+    xPutUInt64(cChunk, m_auiIndexOffset[i]);
+  }
+  /// trailer, lets a reader find the index from the end of file
+  xPutUInt64(cChunk, m_uiBinOffset);
+  const char* pchMagic = "SYSUIDX";
+  cChunk.insert(cChunk.end(), pchMagic, pchMagic+8);
+  m_cWriter.write(0, (const char*)&cChunk[0], cChunk.size());
+  m_uiBinOffset += cChunk.size();
+}
+
+Void TSysuAnalyzerOutput::xPutUInt( std::vector<UChar>& rBuffer, UInt uiValue )
+{
+  rBuffer.push_back( (UChar)( uiValue        & 0xFF) );
+  rBuffer.push_back( (UChar)((uiValue >>  8) & 0xFF) );
+  rBuffer.push_back( (UChar)((uiValue >> 16) & 0xFF) );
+  rBuffer.push_back( (UChar)((uiValue >> 24) & 0xFF) );
+}
+
+Void TSysuAnalyzerOutput::xPutUInt64( std::vector<UChar>& rBuffer, UInt64 uiValue )
+{
+  xPutUInt(rBuffer, (UInt)(uiValue & 0xFFFFFFFF));
+  xPutUInt(rBuffer, (UInt)(uiValue >> 32));
 }
 
 void TSysuAnalyzerOutput::xWriteOutCUInfo  ( TComDataCU* pcCU, Int iLength, Int iOffset, UInt iDepth )
@@ -105,7 +485,7 @@ void TSysuAnalyzerOutput::xWriteOutCUInfo  ( TComDataCU* pcCU, Int iLength, Int
   if( puhDepth[iOffset] <= iDepth )
   {
     ///< CU PU info
-    m_cCUPUOutput << (Int)(puhPartSize[iOffset]) << " "; 
+    m_aiLCUValues[SYSU_CAT_CUPU].push_back((Int)(puhPartSize[iOffset]));
 
     ///< TU info
     xWriteOutTUInfo  ( pcCU, iLength, iOffset, 0 );   ///< Recursive write TU
@@ -170,20 +550,20 @@ void TSysuAnalyzerOutput::xWriteOutCUInfo  ( TComDataCU* pcCU, Int iLength, Int
         iPred = 2;
       else if(ePred == MODE_NONE)
         iPred = 15;
-      m_cPredOutput << iPred << " ";
+      m_aiLCUValues[SYSU_CAT_PRED].push_back(iPred);
 
       /// Write merge info
       Bool bMergeFlag = pcCU->getMergeFlag(iOffset+iPartAddOffset);      
       Int iMergeIndex = pcCU->getMergeIndex(iOffset+iPartAddOffset);
       if(bMergeFlag)
-        m_cMergeOutput << iMergeIndex << " ";
+        m_aiLCUValues[SYSU_CAT_MERGE].push_back(iMergeIndex);
       else
-        m_cMergeOutput << -1 << " ";
+        m_aiLCUValues[SYSU_CAT_MERGE].push_back(-1);
 
       /// Write MV info
       Int iInterDir = pcCU->getInterDir(iOffset+iPartAddOffset);   ///< Inter direction: 0--Invalid, 1--List 0 only, 2--List 1 only, 3--List 0&1(bi-direction)
       int iRefIdx = -1;
-      m_cMVOutput << iInterDir << " ";
+      m_aiLCUValues[SYSU_CAT_MV].push_back(iInterDir);
       if( iInterDir == 0 )
       {
         // do nothing
@@ -192,28 +572,29 @@ void TSysuAnalyzerOutput::xWriteOutCUInfo  ( TComDataCU* pcCU, Int iLength, Int
       {
         rcMV= pcCU->getCUMvField(REF_PIC_LIST_0)->getMv(iOffset+iPartAddOffset);	
         iRefIdx = pcCU->getCUMvField(REF_PIC_LIST_0)->getRefIdx(iOffset+iPartAddOffset);
-        m_cMVOutput << pcCU->getSlice()->getRefPOC(REF_PIC_LIST_0, iRefIdx) << " " << rcMV.getHor() << " " << rcMV.getVer() << " ";
+        xPushMV(m_aiLCUValues[SYSU_CAT_MV], pcCU->getSlice()->getRefPOC(REF_PIC_LIST_0, iRefIdx), rcMV);
       }
       else if ( iInterDir == 2 )
       {
         rcMV= pcCU->getCUMvField(REF_PIC_LIST_1)->getMv(iOffset+iPartAddOffset);
         iRefIdx = pcCU->getCUMvField(REF_PIC_LIST_1)->getRefIdx(iOffset+iPartAddOffset);
-        m_cMVOutput << pcCU->getSlice()->getRefPOC(REF_PIC_LIST_1, iRefIdx) << " " << rcMV.getHor() << " " << rcMV.getVer() << " ";
+        xPushMV(m_aiLCUValues[SYSU_CAT_MV], pcCU->getSlice()->getRefPOC(REF_PIC_LIST_1, iRefIdx), rcMV);
       }
       else if ( iInterDir == 3 )
       {
         rcMV= pcCU->getCUMvField(REF_PIC_LIST_0)->getMv(iOffset+iPartAddOffset);	
         iRefIdx = pcCU->getCUMvField(REF_PIC_LIST_0)->getRefIdx(iOffset+iPartAddOffset);
-        m_cMVOutput << pcCU->getSlice()->getRefPOC(REF_PIC_LIST_0, iRefIdx) << " " << rcMV.getHor() << " " << rcMV.getVer() << " ";
+        xPushMV(m_aiLCUValues[SYSU_CAT_MV], pcCU->getSlice()->getRefPOC(REF_PIC_LIST_0, iRefIdx), rcMV);
         rcMV= pcCU->getCUMvField(REF_PIC_LIST_1)->getMv(iOffset+iPartAddOffset);
         iRefIdx = pcCU->getCUMvField(REF_PIC_LIST_1)->getRefIdx(iOffset+iPartAddOffset);
-        m_cMVOutput << pcCU->getSlice()->getRefPOC(REF_PIC_LIST_1, iRefIdx) << " " << rcMV.getHor() << " " << rcMV.getVer() << " ";
+        xPushMV(m_aiLCUValues[SYSU_CAT_MV], pcCU->getSlice()->getRefPOC(REF_PIC_LIST_1, iRefIdx), rcMV);
       }    
 
       /// Write Intra info
       Int iLumaIntraDir   = pcCU->getLumaIntraDir(iOffset+iPartAddOffset);
       Int iChromaIntraDir = pcCU->getChromaIntraDir(iOffset+iPartAddOffset);
-      m_cIntraOutput << iLumaIntraDir << " " << iChromaIntraDir << " ";
+      m_aiLCUValues[SYSU_CAT_INTRA].push_back(iLumaIntraDir);
+      m_aiLCUValues[SYSU_CAT_INTRA].push_back(iChromaIntraDir);
 
 
 
@@ -222,7 +603,7 @@ void TSysuAnalyzerOutput::xWriteOutCUInfo  ( TComDataCU* pcCU, Int iLength, Int
   }
   else
   {
-    m_cCUPUOutput << "99" << " ";     ///< CU info
+    m_aiLCUValues[SYSU_CAT_CUPU].push_back(99);     ///< CU info
     for( UInt i = 0; i < 4; i++ )
     {
       xWriteOutCUInfo  ( pcCU, iLength/4, iOffset+iLength/4*i, iDepth+1);
@@ -237,11 +618,11 @@ Void TSysuAnalyzerOutput::xWriteOutTUInfo  ( TComDataCU* pcCU, Int iLength, Int
   if( puhTranIdx[iOffset] <= iDepth )
   {
     /// Write TU info
-    m_cTUOutput << (Int)(puhTranIdx[iOffset]) << " ";
+    m_aiLCUValues[SYSU_CAT_TU].push_back((Int)(puhTranIdx[iOffset]));
   }
   else
   {
-    m_cTUOutput << "99" << " ";     
+    m_aiLCUValues[SYSU_CAT_TU].push_back(99);
     for( UInt i = 0; i < 4; i++ )
     {
       xWriteOutTUInfo  ( pcCU, iLength/4, iOffset+iLength/4*i, iDepth+1);
@@ -251,6 +632,20 @@ Void TSysuAnalyzerOutput::xWriteOutTUInfo  ( TComDataCU* pcCU, Int iLength, Int
 
 Void TSysuAnalyzerOutput::writeOutSps   ( TComSPS* pcSPS )
 {
+  if( m_pcSink != NULL )
+  {
+#if (HM_VERSION >= 100)
+    m_pcSink->onSps(pcSPS->getPicWidthInLumaSamples(), pcSPS->getPicHeightInLumaSamples(),
+                    pcSPS->getMaxCUHeight(), pcSPS->getMaxCUDepth(),
+                    pcSPS->getQuadtreeTUMaxDepthInter(), pcSPS->getQuadtreeTUMaxDepthIntra(), pcSPS->getBitDepthY());
+#else
+    m_pcSink->onSps(pcSPS->getWidth(), pcSPS->getHeight(),
+                    pcSPS->getMaxCUHeight(), pcSPS->getMaxCUDepth(),
+                    pcSPS->getQuadtreeTUMaxDepthInter(), pcSPS->getQuadtreeTUMaxDepthIntra(), pcSPS->getBitDepth());
+#endif
+    return;
+  }
+
 #if (HM_VERSION >= 100)
   m_cSpsOut << "Resolution:"   << pcSPS->getPicWidthInLumaSamples() << "x" << pcSPS->getPicHeightInLumaSamples() << endl;
 #else
@@ -275,17 +670,25 @@ Void TSysuAnalyzerOutput::writeOutSps   ( TComSPS* pcSPS )
 
 TSysuAnalyzerOutput::~TSysuAnalyzerOutput()
 {
-  m_cCUPUOutput.close();
-  m_cMVOutput.close();
-  m_cPredOutput.close();
   m_cSpsOut.close();
-  m_cIntraOutput.close();
-  m_cTUOutput.close();
-  m_cBitOutputLCU.close();
-  m_cBitOutputSCU.close();
-  m_cMEOutput.close();
-
-#if (HM_VERSION >40)
-   m_cTileOutPut.close();
-#endif
+
+  if( m_pcSink != NULL )
+  {
+    /// nothing to flush
+  }
+  else if( m_eOutputFormat == SYSU_OUTPUT_SHM )
+  {
+    m_cShmRing.detach();
+  }
+  else if( m_eOutputFormat == SYSU_OUTPUT_BINARY )
+  {
+    if( m_bFrameOpen )
+      xWriteFrameChunk();
+    xWriteIndexChunk();
+    m_cWriter.close();
+  }
+  else
+  {
+    m_cWriter.close();            ///< waits for the writer thread
+  }
 }
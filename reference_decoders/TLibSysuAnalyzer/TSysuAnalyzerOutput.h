@@ -7,8 +7,35 @@
 #include "TLibCommon/TComDataCU.h"
 #include "TLibCommon/TComSlice.h"
 #include "TLibDecoder/TDecCu.h"
+#include "TSysuShmRing.h"
+#include "TSysuBufferedWriter.h"
+#include "TSysuAnalyzerSink.h"
 
 
+enum SysuAnalyzerOutputFormat
+{
+  SYSU_OUTPUT_TEXT   = 0,   ///< one text file per category (default)
+  SYSU_OUTPUT_BINARY = 1,   ///< single decoder_analysis.bin container
+  SYSU_OUTPUT_SHM    = 2    ///< text records and recon. pictures in the analyzer's shared memory ring
+};
+
+/*!
+ * Binary container layout (decoder_analysis.bin, all fields little-endian)
+ *
+ *  header  : "SYSUANA\0" | UInt version | UInt category number
+ *  chunks  : UInt tag | UInt payload bytes | payload
+ *    FRAM  : Int poc | UInt lcu number | per category { UInt category | UInt bytes | entries }
+ *            entry = Int addr | UInt value number | Int values[value number]
+ *    INDX  : per frame { Int poc | UInt lcu number | UInt64 chunk offset }
+ *  trailer : UInt64 INDX chunk offset | "SYSUIDX\0"
+ *
+ *  An entry holds exactly the values of one line of the corresponding text file,
+ *  a tile entry uses the tile number as addr (same as decoder_tile.txt).
+ */
+#define SYSU_BIN_VERSION      1
+#define SYSU_BIN_TAG_FRAME    0x4D415246    ///< 'FRAM'
+#define SYSU_BIN_TAG_INDEX    0x58444E49    ///< 'INDX'
+
 
 class TSysuAnalyzerOutput
 {
@@ -20,13 +47,13 @@ public:
   /// write out residual
   Void writeOutResiYUV (TDecCu* pcDecCU, TComDataCU* pcCU, UInt uiZorderIdx, UInt uiDepth);
 #endif
- 
+
 
   /// splitting mode
   Void writeOutCUInfo   ( TComDataCU* pcCU );
   Void xWriteOutCUInfo  ( TComDataCU* pcCU, Int iLength, Int iOffset, UInt iDepth);
   Void xWriteOutTUInfo  ( TComDataCU* pcCU, Int iLength, Int iOffset, UInt iDepth);
-  
+
   /// Sequence parameter set output
   Void writeOutSps         ( TComSPS* pcSPS );
 
@@ -34,6 +61,20 @@ public:
   ///write out tile info
   Void writeOutTileInfo(TComPic * pcPic);
 
+  /// reconstructed picture (shared memory output only), pcPicBottom != NULL for a field pair
+  Void setPictureBitDepth  ( Int iInternalBitDepthY, Int iInternalBitDepthC, Int iFileBitDepthY, Int iFileBitDepthC );
+  Void writeOutPicture     ( TComPicYuv* pcPicTop, TComPicYuv* pcPicBottom,
+                             Int iCropLeft, Int iCropRight, Int iCropTop, Int iCropBottom, Bool bTopFieldFirst = true );
+  /// pictures go to the shared memory instead of the recon. file
+  Bool isShmOutput() const { return m_eOutputFormat == SYSU_OUTPUT_SHM; }
+
+  /// all LCUs of the picture are written, called right before its POC line is printed
+  /// (text output: the LCU lines are on disk when the analyzer sees the POC line)
+  Void endOfPicture        ();
+
+  /// POC line of the decoder log (sink output only), called once per picture after its LCUs
+  Void writeOutFrameInfo   ( TComSlice* pcSlice, Double dDecTime );
+
 
 
   std::vector<int> aiCUBits;
@@ -47,26 +88,91 @@ public:
 
 
 
-  /// SINGLETON 
+  /// SINGLETON
   static TSysuAnalyzerOutput* getInstance() { if( m_instance == NULL ) m_instance = new TSysuAnalyzerOutput(); return m_instance;}
+  /// flush and close all outputs (the binary index is written here)
+  static Void destroyInstance() { delete m_instance; m_instance = NULL; }
+
+  /// must be called before the first getInstance()
+  static Void setOutputFormat( SysuAnalyzerOutputFormat eFormat ) { m_eOutputFormat = eFormat; }
+  static SysuAnalyzerOutputFormat getOutputFormat() { return m_eOutputFormat; }
+  /// shared memory object created by the analyzer (SYSU_OUTPUT_SHM)
+  static Void setShmName( const std::string& rstrName ) { m_strShmName = rstrName; }
+  /// in-process decoding: everything goes to pcSink, no file is written (must be set before the first getInstance())
+  static Void setSink( TSysuAnalyzerSink* pcSink ) { m_pcSink = pcSink; }
+
+  /*!
+   * categories written to the files or the shared memory (not to a sink), comma separated names
+   * (pred,cupu,mv,merge,intra,tu,bit_lcu,bit_scu,tile), empty for all of them. cupu is added to
+   * any per-LCU category, the others are attached to its CU tree. Must be called before the first getInstance().
+   * \return false if a name is unknown
+   */
+  static Bool setCategories( const std::string& rstrCategories );
+  /*!
+   * only LCUs and tiles of the pictures with iFirstPoc <= POC <= iLastPoc are written (not to a sink),
+   * iLastPoc < 0 for no upper limit. 0 and -1 record every picture, negative POCs included.
+   */
+  static Void setPOCRange( Int iFirstPoc, Int iLastPoc )
+  { m_iFirstPoc = iFirstPoc; m_iLastPoc = iLastPoc; m_bPOCRange = ( iFirstPoc != 0 || iLastPoc >= 0 ); }
+  /*!
+   * pre-scan: the slices are parsed up to their data, no CTU is decoded and no picture is filtered or written,
+   * so the per-LCU outputs stay empty. The POC lines get the slice bits of the picture ("[BITS n]").
+   */
+  static Void setPreScan( Bool bPreScan ) { m_bPreScan = bPreScan; }
+  static Bool isPreScan() { return m_bPreScan; }
 
 private:
 
+  Bool xIsRecorded      ( Int iPoc ) const { return !m_bPOCRange || ( iPoc >= m_iFirstPoc && ( m_iLastPoc < 0 || iPoc <= m_iLastPoc ) ); }
+
+  /// write out the values collected for one LCU
+  Void xWriteOutLCU     ( Int iPoc, Int iAddr );
+  Void xPushMV          ( std::vector<Int>& riValues, Int iRefPOC, TComMv& rcMV );
+  /// one line of a text category is appended to the returned string, xEndLine() writes it to its file or to the shared memory
+  std::string& xBeginLine( Int iCategory );
+  Void xEndLine         ( Int iCategory );
+  Void xPackPlane       ( std::vector<UChar>& rBuffer, Pel* pcTop, Pel* pcBottom, Int iStride,
+                          Int iWidth, Int iHeight, Int iShift, Int iMaxVal, Bool b16Bit );
+
+  /// binary container
+  Void xOpenFrame       ( Int iPoc );
+  Void xWriteFrameChunk ();
+  Void xWriteIndexChunk ();
+  Void xPutUInt         ( std::vector<UChar>& rBuffer, UInt uiValue );
+  Void xPutUInt64       ( std::vector<UChar>& rBuffer, UInt64 uiValue );
+
   /// Decoder output ( extracted from bitstream )
   std::ofstream m_cSpsOut;          ///< SPS info
-  std::ofstream m_cPredOutput;      ///< Prediction mode info output
-  std::ofstream m_cCUPUOutput;      ///< CU info output
-  std::ofstream m_cMVOutput;        ///< MV info output
-  std::ofstream m_cMergeOutput;     ///< Merge info output
-  std::ofstream m_cIntraOutput;     ///< Intra info output
-  std::ofstream m_cTUOutput;        ///< TU info output
-  std::ofstream m_cBitOutputLCU;    ///< LCU bit consumption info output
-  std::ofstream m_cBitOutputSCU;    ///< SCU bit consumption info output
-  std::ofstream m_cTileOutPut;
-
-  /// Encoder output ( extracted in the encoding process
-  std::ofstream m_cMEOutput;    ///< ME info (search point number, SAD, cost, etc)
-
+  TSysuBufferedWriter m_cWriter;    ///< one text file per category (stream = category), or the binary container (stream 0)
+
+  /// values of the current LCU, one column per category
+  std::vector<Int> m_aiLCUValues[SYSU_CAT_NUM];
+
+  /// binary output
+  std::vector<Int> m_aiFrameEntries[SYSU_CAT_NUM];   ///< entries of the current frame
+  Bool   m_bFrameOpen;
+  Int    m_iFramePoc;
+  UInt   m_uiFrameLCUNum;
+  UInt64 m_uiBinOffset;                              ///< bytes written so far
+  std::vector<Int>    m_aiIndexPoc;
+  std::vector<UInt>   m_auiIndexLCUNum;
+  std::vector<UInt64> m_auiIndexOffset;
+
+  /// shared memory output
+  TSysuShmRing m_cShmRing;
+  std::vector<UChar> m_aucPicture;                   ///< packed picture record
+  std::string        m_strLine;                      ///< text record
+  Int    m_aiInternalBitDepth[2];                    ///< luma, chroma
+  Int    m_aiFileBitDepth[2];
+
+  static SysuAnalyzerOutputFormat m_eOutputFormat;
+  static std::string m_strShmName;
+  static TSysuAnalyzerSink* m_pcSink;
+  static Bool m_abCategoryEnabled[SYSU_CAT_NUM];
+  static Int  m_iFirstPoc;
+  static Int  m_iLastPoc;
+  static Bool m_bPOCRange;
+  static Bool m_bPreScan;
   static TSysuAnalyzerOutput* m_instance;
 
 };
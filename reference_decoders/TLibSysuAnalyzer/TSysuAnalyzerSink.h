@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+
+
+/// per-LCU record streams, each one is a text file or a column in the binary container
+enum SysuAnalyzerCategory
+{
+  SYSU_CAT_PRED = 0,    ///< decoder_pred.txt
+  SYSU_CAT_CUPU,        ///< decoder_cupu.txt
+  SYSU_CAT_MV,          ///< decoder_mv.txt
+  SYSU_CAT_MERGE,       ///< decoder_merge.txt
+  SYSU_CAT_INTRA,       ///< decoder_intra.txt
+  SYSU_CAT_TU,          ///< decoder_tu.txt
+  SYSU_CAT_BIT_LCU,     ///< decoder_bit_lcu.txt
+  SYSU_CAT_BIT_SCU,     ///< decoder_bit_scu.txt
+  SYSU_CAT_ME,          ///< encoder_me.txt (text only)
+  SYSU_CAT_TILE,        ///< decoder_tile.txt
+  SYSU_CAT_NUM
+};
+
+
+/*!
+ * Callback interface for a decoder linked into the analyzer (TSysuDecoderSession)
+ *
+ * TSysuAnalyzerOutput calls it instead of writing any file. Only standard types are used
+ * here, so the analyzer can implement it without including the HM headers.
+ * The calls come from the decoding thread, in this order for every picture:
+ * onLCU() for each LCU, onTile() for each tile, onFrame(), then onPicture() when it is output.
+ */
+class TSysuAnalyzerSink
+{
+public:
+  virtual ~TSysuAnalyzerSink() {}
+
+  /// same values as decoder_sps.txt
+  virtual void onSps     ( int iWidth, int iHeight, int iMaxCUSize, int iMaxCUDepth,
+                           int iMaxInterTUDepth, int iMaxIntraTUDepth, int iInputBitDepth ) = 0;
+  /// same values as one POC line of the decoder log, after all the LCUs of the picture
+  virtual void onFrame   ( int iPoc, double dDecTime, const std::vector<int>& raiRefPOCL0,
+                           const std::vector<int>& raiRefPOCL1 ) = 0;
+  /// one LCU, paiValues[SysuAnalyzerCategory] are the values of one line of each text file
+  virtual void onLCU     ( int iPoc, int iAddr, const std::vector<int>* paiValues ) = 0;
+  /// one line of decoder_tile.txt
+  virtual void onTile    ( int iPoc, int iTileNum, int iFirstCUAddr, int iWidth, int iHeight ) = 0;
+  /// one reconstructed picture in displaying order, same samples as a frame of the recon. YUV file
+  virtual void onPicture ( const unsigned char* pucData, unsigned int uiLength ) = 0;
+
+  /// polled between NAL units, the session stops decoding when it returns true
+  virtual bool isCancelled() { return false; }
+};
@@ -0,0 +1,234 @@
+#include "TSysuBufferedWriter.h"
+
+TSysuBufferedWriter::TSysuBufferedWriter()
+: m_uiQueuedBytes(0)
+, m_bStop(false)
+, m_bRunning(false)
+{
+#if defined(_WIN32)
+  m_hThread = NULL;
+  InitializeCriticalSection(&m_cLock);
+  m_hWork  = CreateEvent(NULL, FALSE, FALSE, NULL);
+  m_hSpace = CreateEvent(NULL, FALSE, FALSE, NULL);
+#else
+  pthread_mutex_init(&m_cLock, NULL);
+  pthread_cond_init(&m_cWork, NULL);
+  pthread_cond_init(&m_cSpace, NULL);
+#endif
+}
+
+TSysuBufferedWriter::~TSysuBufferedWriter()
+{
+  close();
+#if defined(_WIN32)
+  CloseHandle(m_hWork);
+  CloseHandle(m_hSpace);
+  DeleteCriticalSection(&m_cLock);
+#else
+  pthread_cond_destroy(&m_cSpace);
+  pthread_cond_destroy(&m_cWork);
+  pthread_mutex_destroy(&m_cLock);
+#endif
+}
+
+Bool TSysuBufferedWriter::open( UInt uiStream, const char* pchFileName, Bool bBinary )
+{
+  if( uiStream >= m_apcFile.size() )
+  {
+    m_apcFile.resize(uiStream+1, NULL);
+    m_astrBlock.resize(uiStream+1);
+  }
+  m_apcFile[uiStream] = fopen(pchFileName, bBinary ? "wb" : "w");
+  if( m_apcFile[uiStream] == NULL )
+    return false;
+  setvbuf(m_apcFile[uiStream], NULL, _IONBF, 0);     ///< a block is written by one fwrite anyway
+  m_astrBlock[uiStream].reserve(SYSU_WRITER_BLOCK_SIZE + 4096);
+
+  if( !m_bRunning )
+  {
+    m_bStop = false;
+#if defined(_WIN32)
+    m_hThread = CreateThread(NULL, 0, xThreadMain, this, 0, NULL);
+    m_bRunning = ( m_hThread != NULL );
+#else
+    m_bRunning = ( pthread_create(&m_cThread, NULL, xThreadMain, this) == 0 );
+#endif
+    if( !m_bRunning )
+      fprintf(stderr, "\nanalyzer output writer thread not started, writing synchronously\n");
+  }
+  return true;
+}
+
+Void TSysuBufferedWriter::write( UInt uiStream, const char* pchData, size_t uiLength )
+{
+  if( !isOpen(uiStream) )
+    return;
+  std::string& rstrBlock = m_astrBlock[uiStream];
+  rstrBlock.append(pchData, uiLength);
+  if( rstrBlock.size() >= SYSU_WRITER_BLOCK_SIZE )
+    xHandOver(uiStream);
+}
+
+Void TSysuBufferedWriter::endAppend( UInt uiStream )
+{
+  if( !isOpen(uiStream) )
+    m_astrBlock[uiStream].clear();          ///< same as write() to a stream which failed to open
+  else if( m_astrBlock[uiStream].size() >= SYSU_WRITER_BLOCK_SIZE )
+    xHandOver(uiStream);
+}
+
+Void TSysuBufferedWriter::flush()
+{
+  xHandOverAll();
+  if( !m_bRunning )
+    return;
+  xLock();
+  while( m_uiQueuedBytes > 0 )              ///< a block is counted until its fwrite returned
+    xWaitSpace();
+  xUnlock();
+}
+
+Void TSysuBufferedWriter::close()
+{
+  if( m_apcFile.empty() )
+    return;
+  xHandOverAll();
+
+  if( m_bRunning )
+  {
+    xLock();
+    m_bStop = true;
+    xSignalWork();
+    xUnlock();
+#if defined(_WIN32)
+    WaitForSingleObject(m_hThread, INFINITE);
+    CloseHandle(m_hThread);
+    m_hThread = NULL;
+#else
+    pthread_join(m_cThread, NULL);
+#endif
+    m_bRunning = false;
+  }
+
+  for(size_t i = 0; i < m_apcFile.size(); i++)
+  {
+    if( m_apcFile[i] != NULL )
+      fclose(m_apcFile[i]);
+  }
+  m_apcFile.clear();
+  m_astrBlock.clear();
+  for(size_t i = 0; i < m_apcFree.size(); i++)
+    delete m_apcFree[i];
+  m_apcFree.clear();
+}
+
+Void TSysuBufferedWriter::xHandOver( UInt uiStream )
+{
+  std::string& rstrBlock = m_astrBlock[uiStream];
+  if( rstrBlock.empty() )
+    return;
+
+  if( !m_bRunning )
+  {
+    fwrite(rstrBlock.data(), 1, rstrBlock.size(), m_apcFile[uiStream]);
+    rstrBlock.clear();
+    return;
+  }
+
+  xLock();
+  while( m_uiQueuedBytes >= SYSU_WRITER_MAX_QUEUED )
+    xWaitSpace();
+  Block* pcBlock = NULL;
+  if( m_apcFree.empty() )
+    pcBlock = new Block;
+  else
+  {
+    pcBlock = m_apcFree.back();
+    m_apcFree.pop_back();
+  }
+  pcBlock->uiStream = uiStream;
+  pcBlock->strData.swap(rstrBlock);        ///< rstrBlock gets the memory of a written block
+  m_uiQueuedBytes += pcBlock->strData.size();
+  m_apcQueue.push_back(pcBlock);
+  xSignalWork();
+  xUnlock();
+
+  if( rstrBlock.capacity() < SYSU_WRITER_BLOCK_SIZE )
+    rstrBlock.reserve(SYSU_WRITER_BLOCK_SIZE + 4096);
+}
+
+Void TSysuBufferedWriter::xHandOverAll()
+{
+  for(UInt i = 0; i < m_astrBlock.size(); i++)
+    xHandOver(i);
+}
+
+Void TSysuBufferedWriter::xRun()
+{
+  xLock();
+  for(;;)
+  {
+    while( m_apcQueue.empty() && !m_bStop )
+      xWaitWork();
+    if( m_apcQueue.empty() )
+      break;                                ///< stopped and everything written
+
+    Block* pcBlock = m_apcQueue.front();
+    m_apcQueue.pop_front();
+    xUnlock();
+
+    fwrite(pcBlock->strData.data(), 1, pcBlock->strData.size(), m_apcFile[pcBlock->uiStream]);
+
+    xLock();
+    m_uiQueuedBytes -= pcBlock->strData.size();
+    pcBlock->strData.clear();
+    m_apcFree.push_back(pcBlock);
+    xSignalSpace();
+  }
+  xUnlock();
+}
+
+#if defined(_WIN32)
+
+DWORD WINAPI TSysuBufferedWriter::xThreadMain( LPVOID pArg )
+{
+  ((TSysuBufferedWriter*)pArg)->xRun();
+  return 0;
+}
+
+Void TSysuBufferedWriter::xLock()        { EnterCriticalSection(&m_cLock); }
+Void TSysuBufferedWriter::xUnlock()      { LeaveCriticalSection(&m_cLock); }
+Void TSysuBufferedWriter::xSignalWork()  { SetEvent(m_hWork); }
+Void TSysuBufferedWriter::xSignalSpace() { SetEvent(m_hSpace); }
+
+/// one waiter per event, the lock is released while waiting (the caller re-checks its condition)
+Void TSysuBufferedWriter::xWaitWork()
+{
+  LeaveCriticalSection(&m_cLock);
+  WaitForSingleObject(m_hWork, INFINITE);
+  EnterCriticalSection(&m_cLock);
+}
+
+Void TSysuBufferedWriter::xWaitSpace()
+{
+  LeaveCriticalSection(&m_cLock);
+  WaitForSingleObject(m_hSpace, INFINITE);
+  EnterCriticalSection(&m_cLock);
+}
+
+#else
+
+void* TSysuBufferedWriter::xThreadMain( void* pArg )
+{
+  ((TSysuBufferedWriter*)pArg)->xRun();
+  return NULL;
+}
+
+Void TSysuBufferedWriter::xLock()        { pthread_mutex_lock(&m_cLock); }
+Void TSysuBufferedWriter::xUnlock()      { pthread_mutex_unlock(&m_cLock); }
+Void TSysuBufferedWriter::xSignalWork()  { pthread_cond_signal(&m_cWork); }
+Void TSysuBufferedWriter::xSignalSpace() { pthread_cond_signal(&m_cSpace); }
+Void TSysuBufferedWriter::xWaitWork()    { pthread_cond_wait(&m_cWork, &m_cLock); }
+Void TSysuBufferedWriter::xWaitSpace()   { pthread_cond_wait(&m_cSpace, &m_cLock); }
+
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "TLibCommon/TypeDef.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+
+#define SYSU_WRITER_BLOCK_SIZE      (1 << 20)     ///< bytes buffered per stream before a block is handed over
+#define SYSU_WRITER_MAX_QUEUED      (64 << 20)    ///< the decoder waits while the writer is this far behind
+
+
+/*!
+ * Buffered output of several files by one writer thread
+ *
+ * The decoder appends to one memory block per stream, a full block is queued and written
+ * by the writer thread with a single fwrite, so the decoder never waits for the disk
+ * (unless the queue exceeds SYSU_WRITER_MAX_QUEUED). Blocks of one stream are written in order.
+ */
+class TSysuBufferedWriter
+{
+public:
+  TSysuBufferedWriter(void);
+  ~TSysuBufferedWriter(void);
+
+  /// create file pchFileName for stream uiStream, the writer thread is started by the first open
+  Bool open         ( UInt uiStream, const char* pchFileName, Bool bBinary = false );
+  Bool isOpen       ( UInt uiStream ) const { return uiStream < m_apcFile.size() && m_apcFile[uiStream] != NULL; }
+
+  Void write        ( UInt uiStream, const char* pchData, size_t uiLength );
+  Void write        ( UInt uiStream, const std::string& rstrData ) { write(uiStream, rstrData.data(), rstrData.size()); }
+
+  /// text is formatted in place: append to the block of an open stream, then call endAppend()
+  std::string& beginAppend( UInt uiStream ) { return m_astrBlock[uiStream]; }
+  Void endAppend    ( UInt uiStream );
+
+  /// hand over all blocks and wait until everything is on disk, called at the end of every picture
+  /// before its POC line is printed, so a reader following the files (streaming analyzer) finds whole pictures
+  Void flush        ();
+
+  /// hand over all blocks, wait until everything is on disk, stop the thread and close the files
+  Void close        ();
+
+private:
+  struct Block
+  {
+    UInt        uiStream;
+    std::string strData;
+  };
+
+  Void xHandOver    ( UInt uiStream );
+  Void xHandOverAll ();
+  Void xRun         ();
+
+  std::vector<FILE*>       m_apcFile;       ///< per stream
+  std::vector<std::string> m_astrBlock;     ///< block being filled, per stream (decoder side only)
+
+  /// shared with the writer thread, guarded by the lock
+  std::deque<Block*>       m_apcQueue;
+  std::vector<Block*>      m_apcFree;       ///< written blocks, their memory is reused
+  size_t                   m_uiQueuedBytes;
+  Bool                     m_bStop;
+  Bool                     m_bRunning;
+
+  Void xLock        ();
+  Void xUnlock      ();
+  Void xWaitWork    ();                     ///< writer: wait for a block or stop
+  Void xWaitSpace   ();                     ///< decoder: wait for the writer to write a block
+  Void xSignalWork  ();
+  Void xSignalSpace ();
+
+#if defined(_WIN32)
+  static DWORD WINAPI xThreadMain( LPVOID pArg );
+  HANDLE             m_hThread;
+  CRITICAL_SECTION   m_cLock;
+  HANDLE             m_hWork;               ///< auto-reset events
+  HANDLE             m_hSpace;
+#else
+  static void* xThreadMain( void* pArg );
+  pthread_t          m_cThread;
+  pthread_mutex_t    m_cLock;
+  pthread_cond_t     m_cWork;
+  pthread_cond_t     m_cSpace;
+#endif
+};
@@ -0,0 +1,143 @@
+#include "TSysuDecoderSession.h"
+#include "TSysuAnalyzerOutput.h"
+#include "TLibDecoder/TDecTop.h"
+#include "TLibDecoder/AnnexBread.h"
+#include "TLibDecoder/NALread.h"
+#include <cstdio>
+
+#if (HM_VERSION < 120)
+#error "in-process decoding needs HM-12.0"
+#endif
+
+/// defined by decmain.cpp in TAppDecoder and by the analyzer for in-process decoding
+extern Bool g_md5_mismatch;
+
+
+/// pictures are written out in POC order once enough pictures are waiting (TAppDecTop::xWriteOutput)
+static Void xWriteOutput( TComList<TComPic*>* pcListPic, UInt uiTId, Int& riPOCLastDisplay, Bool bFlush )
+{
+  Int iNotYetDisplayed = 0;
+  for( TComList<TComPic*>::iterator it = pcListPic->begin(); it != pcListPic->end(); it++ )
+  {
+    if( (*it)->getOutputMark() && (*it)->getPOC() > riPOCLastDisplay )
+      iNotYetDisplayed++;
+  }
+
+  for( TComList<TComPic*>::iterator it = pcListPic->begin(); it != pcListPic->end(); it++ )
+  {
+    TComPic* pcPic = *it;
+    if( !pcPic->getOutputMark() )
+      continue;
+    if( !bFlush && ( iNotYetDisplayed <= pcPic->getNumReorderPics(uiTId) || pcPic->getPOC() <= riPOCLastDisplay ) )
+      continue;
+
+    iNotYetDisplayed--;
+    const Window &conf = pcPic->getConformanceWindow();
+    TSysuAnalyzerOutput::getInstance()->writeOutPicture( pcPic->getPicYuvRec(), NULL,
+                                                         conf.getWindowLeftOffset(), conf.getWindowRightOffset(),
+                                                         conf.getWindowTopOffset(), conf.getWindowBottomOffset() );
+    riPOCLastDisplay = pcPic->getPOC();
+
+    if( !pcPic->getSlice(0)->isReferenced() && pcPic->getReconMark() == true )
+    {
+      pcPic->setReconMark(false);
+      pcPic->getPicYuvRec()->setBorderExtension( false );
+    }
+    pcPic->setOutputMark(false);
+  }
+
+  if( bFlush )
+  {
+    for( TComList<TComPic*>::iterator it = pcListPic->begin(); it != pcListPic->end(); it++ )
+    {
+      (*it)->destroy();
+      delete *it;
+    }
+    pcListPic->clear();
+    riPOCLastDisplay = -MAX_INT;
+  }
+}
+
+bool TSysuDecoderSession::decode( const char* pchBitstreamFile, TSysuAnalyzerSink* pcSink )
+{
+  ifstream bitstreamFile(pchBitstreamFile, ifstream::in | ifstream::binary);
+  if( !bitstreamFile )
+  {
+    fprintf(stderr, "\nfailed to open bitstream file `%s' for reading\n", pchBitstreamFile);
+    return false;
+  }
+  InputByteStream bytestream(bitstreamFile);
+
+  TSysuAnalyzerOutput::setSink( pcSink );
+  TDecTop* pcDecTop = new TDecTop();      ///< large, keep it off the worker stack
+  pcDecTop->create();
+  pcDecTop->init();
+
+  Int iPOC;
+  Int iSkipFrame = 0;
+  Int iPOCLastDisplay = -MAX_INT;
+  Bool bCancelled = false;
+  Bool bBitDepthSet = false;
+  TComList<TComPic*>* pcListPic = NULL;
+
+  while( !!bitstreamFile )
+  {
+    if( pcSink->isCancelled() )
+    {
+      bCancelled = true;
+      break;
+    }
+
+    /// see TAppDecTop::decode, the first slice of a new picture is read again
+    streampos location = bitstreamFile.tellg();
+    AnnexBStats stats = AnnexBStats();
+    vector<uint8_t> nalUnit;
+    InputNALUnit nalu;
+    byteStreamNALUnit(bytestream, nalUnit, stats);
+
+    Bool bNewPicture = false;
+    if( !nalUnit.empty() )
+    {
+      read(nalu, nalUnit);
+      bNewPicture = pcDecTop->decode(nalu, iSkipFrame, iPOCLastDisplay);
+      if( bNewPicture )
+      {
+        bitstreamFile.clear();
+        bitstreamFile.seekg(location-streamoff(3));
+        bytestream.reset();
+      }
+    }
+    if( bNewPicture || !bitstreamFile )
+      pcDecTop->executeLoopFilters(iPOC, pcListPic);
+
+    if( pcListPic )
+    {
+      if( !bBitDepthSet )
+      {
+        TSysuAnalyzerOutput::getInstance()->setPictureBitDepth( g_bitDepthY, g_bitDepthC, g_bitDepthY, g_bitDepthC );
+        bBitDepthSet = true;
+      }
+      if( bNewPicture &&
+          (   nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_IDR_W_RADL
+           || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_IDR_N_LP
+           || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA_N_LP
+           || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA_W_RADL
+           || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA_W_LP ) )
+      {
+        xWriteOutput( pcListPic, nalu.m_temporalId, iPOCLastDisplay, true );
+      }
+      if( bNewPicture )
+        xWriteOutput( pcListPic, nalu.m_temporalId, iPOCLastDisplay, false );
+    }
+  }
+
+  if( pcListPic && !bCancelled )
+    xWriteOutput( pcListPic, 0, iPOCLastDisplay, true );
+  pcDecTop->deletePicBuffer();
+  pcDecTop->destroy();
+  delete pcDecTop;
+
+  TSysuAnalyzerOutput::destroyInstance();
+  TSysuAnalyzerOutput::setSink( NULL );
+  return !bCancelled;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "TSysuAnalyzerSink.h"
+
+
+/*!
+ * Decoding loop of TAppDecoder for a decoder linked into the analyzer
+ *
+ * The analysis output (TSysuAnalyzerOutput) and the reconstructed pictures go to the sink,
+ * no file is written. The decoder library keeps global state (ROM tables, analyzer output
+ * singleton), so only one session may run at a time in a process.
+ */
+class TSysuDecoderSession
+{
+public:
+  /*!
+   * decode the whole bitstream (Annex-B byte stream) on the calling thread
+   * \return false if the file can not be opened or pcSink cancelled the decoding
+   */
+  static bool decode( const char* pchBitstreamFile, TSysuAnalyzerSink* pcSink );
+};
@@ -0,0 +1,143 @@
+#include "TSysuShmRing.h"
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+TSysuShmRing::TSysuShmRing()
+: m_pucBase(NULL)
+, m_pucData(NULL)
+, m_uiCapacity(0)
+, m_uiMapSize(0)
+{
+}
+
+TSysuShmRing::~TSysuShmRing()
+{
+  detach();
+}
+
+#if !defined(_WIN32)
+
+Bool TSysuShmRing::attach( const std::string& rstrName )
+{
+  detach();
+
+  std::string strName = (rstrName.empty() || rstrName[0] == '/') ? rstrName : "/" + rstrName;
+  Int iFd = shm_open(strName.c_str(), O_RDWR, 0);
+  if( iFd < 0 )
+  {
+    fprintf(stderr, "\nfailed to open shared memory `%s'\n", strName.c_str());
+    return false;
+  }
+
+  struct stat cStat;
+  if( fstat(iFd, &cStat) != 0 || cStat.st_size <= SYSU_SHM_HEADER_SIZE )
+  {
+    close(iFd);
+    return false;
+  }
+  Void* pMap = mmap(NULL, cStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+  close(iFd);                         ///< the mapping keeps the object alive
+  if( pMap == MAP_FAILED )
+    return false;
+
+  m_pucBase = (UChar*)pMap;
+  m_uiMapSize = cStat.st_size;
+
+  UInt uiVersion, uiHeaderSize;
+  memcpy(&uiVersion,    m_pucBase + 8,  sizeof(UInt));
+  memcpy(&uiHeaderSize, m_pucBase + 12, sizeof(UInt));
+  memcpy(&m_uiCapacity, m_pucBase + 16, sizeof(UInt64));
+  if( memcmp(m_pucBase, "SYSUSHM", 8) != 0 || uiVersion != SYSU_SHM_VERSION ||
+      uiHeaderSize != SYSU_SHM_HEADER_SIZE || m_uiCapacity + SYSU_SHM_HEADER_SIZE > m_uiMapSize )
+  {
+    fprintf(stderr, "\nshared memory `%s' is not an analyzer ring buffer\n", strName.c_str());
+    munmap(m_pucBase, m_uiMapSize);
+    m_pucBase = NULL;
+    return false;
+  }
+
+  m_pucData = m_pucBase + SYSU_SHM_HEADER_SIZE;
+  *xWriterState() = SYSU_SHM_WRITER_ATTACHED;
+  return true;
+}
+
+Void TSysuShmRing::detach()
+{
+  if( m_pucBase == NULL )
+    return;
+  __sync_synchronize();               ///< every record is visible before the state changes
+  *xWriterState() = SYSU_SHM_WRITER_FINISHED;
+  munmap(m_pucBase, m_uiMapSize);
+  m_pucBase = NULL;
+  m_pucData = NULL;
+}
+
+Bool TSysuShmRing::writeRecord( UInt uiType, const UChar* pucPayload, UInt uiLength )
+{
+  if( m_pucBase == NULL )
+    return false;
+
+  UInt64 uiRecordSize = (8 + (UInt64)uiLength + 7) & ~(UInt64)7;
+  if( uiRecordSize > m_uiCapacity )
+  {
+    fprintf(stderr, "\nrecord of %u bytes does not fit into the shared memory\n", uiLength);
+    return false;
+  }
+
+  /// the reader only moves forward, wait until there is room
+  UInt64 uiWritePos = *xWritePos();
+  while( uiWritePos + uiRecordSize - *xReadPos() > m_uiCapacity )
+    usleep(500);
+  __sync_synchronize();
+
+  UChar aucHeader[8];
+  memcpy(aucHeader,   &uiType,   sizeof(UInt));
+  memcpy(aucHeader+4, &uiLength, sizeof(UInt));
+  xCopyIn(uiWritePos,     aucHeader,  8);
+  xCopyIn(uiWritePos + 8, pucPayload, uiLength);
+
+  /// publish the record after its content
+  __sync_synchronize();
+  *xWritePos() = uiWritePos + uiRecordSize;
+  return true;
+}
+
+Void TSysuShmRing::xCopyIn( UInt64 uiPos, const UChar* pucData, UInt64 uiLength )
+{
+  UInt64 uiOffset = uiPos % m_uiCapacity;
+  UInt64 uiFirst = m_uiCapacity - uiOffset;
+  if( uiFirst > uiLength )
+    uiFirst = uiLength;
+  memcpy(m_pucData + uiOffset, pucData, uiFirst);
+  memcpy(m_pucData, pucData + uiFirst, uiLength - uiFirst);    ///< wrap around
+}
+
+#else
+
+Bool TSysuShmRing::attach( const std::string& rstrName )
+{
+  fprintf(stderr, "\nshared memory output is not supported on this platform\n");
+  return false;
+}
+
+Void TSysuShmRing::detach()
+{
+}
+
+Bool TSysuShmRing::writeRecord( UInt uiType, const UChar* pucPayload, UInt uiLength )
+{
+  return false;
+}
+
+Void TSysuShmRing::xCopyIn( UInt64 uiPos, const UChar* pucData, UInt64 uiLength )
+{
+}
+
+#endif
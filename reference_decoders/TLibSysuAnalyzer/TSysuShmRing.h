@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+
+#include "TLibCommon/TypeDef.h"
+
+
+/*!
+ * Shared memory ring buffer between the decoder and the analyzer (POSIX shm_open/mmap)
+ *
+ * The analyzer creates and initializes the shared memory object before starting the
+ * decoder, the decoder only attaches to it (AnalysisOutputFormat=2, AnalysisShmName=<name>).
+ *
+ *  header  (SYSU_SHM_HEADER_SIZE bytes, native endian)
+ *     0 : "SYSUSHM\0"
+ *     8 : UInt   version
+ *    12 : UInt   header bytes
+ *    16 : UInt64 capacity of the data area
+ *    24 : UInt64 write position (bytes written so far, only the decoder changes it)
+ *    32 : UInt64 read position  (bytes consumed so far, only the analyzer changes it)
+ *    40 : UInt   writer state (SYSU_SHM_WRITER_*)
+ *  data    (capacity bytes, positions are taken modulo capacity)
+ *    record: UInt type | UInt payload bytes | payload | padding to 8 bytes
+ *    type  : SysuAnalyzerCategory (lines of the corresponding text file) or SYSU_SHM_REC_PICTURE
+ *            (one reconstructed picture, same samples as a frame of the recon. YUV file)
+ */
+#define SYSU_SHM_VERSION          1
+#define SYSU_SHM_HEADER_SIZE      64
+#define SYSU_SHM_REC_PICTURE      0x100
+
+#define SYSU_SHM_WRITER_NONE      0
+#define SYSU_SHM_WRITER_ATTACHED  1
+#define SYSU_SHM_WRITER_FINISHED  2
+
+
+class TSysuShmRing
+{
+public:
+  TSysuShmRing(void);
+  ~TSysuShmRing(void);
+
+  /// map the shared memory object created by the analyzer
+  Bool attach       ( const std::string& rstrName );
+  /// tell the reader no record follows and unmap
+  Void detach       ();
+  Bool isAttached   () const { return m_pucBase != NULL; }
+
+  /// append one record, wait while the reader is behind
+  Bool writeRecord  ( UInt uiType, const UChar* pucPayload, UInt uiLength );
+
+private:
+  Void xCopyIn      ( UInt64 uiPos, const UChar* pucData, UInt64 uiLength );
+  volatile UInt64* xWritePos () { return (volatile UInt64*)(m_pucBase + 24); }
+  volatile UInt64* xReadPos  () { return (volatile UInt64*)(m_pucBase + 32); }
+  volatile UInt*   xWriterState () { return (volatile UInt*)(m_pucBase + 40); }
+
+  UChar* m_pucBase;           ///< mapped header
+  UChar* m_pucData;           ///< data area
+  UInt64 m_uiCapacity;
+  UInt64 m_uiMapSize;
+};
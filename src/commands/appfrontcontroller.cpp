@@ -26,6 +26,10 @@
 #include "commands/switchthemecommand.h"
 #include "commands/cleancachecommand.h"
 #include "commands/savefilterordercommand.h"
+#include "commands/streambitstreamcommand.h"
+#include "commands/decodejobcommand.h"
+#include "commands/canceldecodecommand.h"
+#include "commands/querymemorycommand.h"
 SINGLETON_PATTERN_IMPLIMENT(AppFrontController)
 
 /// command <string,class> pair
@@ -58,6 +62,10 @@ s_sCmdTable[] =
     { "query_pref",       &QueryPreferencesCommand::staticMetaObject   },
     { "switch_theme",     &SwitchThemeCommand::staticMetaObject        },
     { "clean_cache",      &CleanCacheCommand::staticMetaObject         },
+    { "stream_bitstream", &StreamBitstreamCommand::staticMetaObject    },
+    { "decode_job",       &DecodeJobCommand::staticMetaObject          },
+    { "cancel_decode",    &CancelDecodeCommand::staticMetaObject       },
+    { "query_memory",     &QueryMemoryCommand::staticMetaObject        },
     { "",                 NULL                                         }    ///end mark
 };
 
@@ -0,0 +1,48 @@
+#include "canceldecodecommand.h"
+#include "model/modellocator.h"
+#include <QDebug>
+
+CancelDecodeCommand::CancelDecodeCommand(QObject *parent) :
+    GitlAbstractCommand(parent)
+{
+}
+
+bool CancelDecodeCommand::execute( GitlCommandParameter& rcInputArg, GitlCommandParameter& rcOutputArg )
+{
+    ModelLocator* pModel = ModelLocator::getInstance();
+    bool bAll = !rcInputArg.hasParameter("decode_job_id");
+    int iJobId = rcInputArg.getParameter("decode_job_id").toInt();
+
+    bool bFound = false;
+    foreach(DecodeJob* pcJob, pModel->getDecodeJobs())
+    {
+        if( bAll || pcJob->getId() == iJobId )
+        {
+            qDebug() << "Cancel decoding:" << pcJob->getFileName();
+            pcJob->cancel();
+            bFound = true;
+        }
+    }
+
+    /// followed bitstreams are complete, their decoders finish the files
+    if( bAll )
+    {
+        SequenceManager& rcSequenceManager = pModel->getSequenceManager();
+        foreach(ComSequence* pcSequence, rcSequenceManager.getAllSequences())
+        {
+            if( pcSequence->getFollowing() )
+            {
+                qDebug() << "Stop following:" << pcSequence->getFileName();
+                pcSequence->setFollowing(false);
+                bFound = true;
+            }
+        }
+        /// the sequence list shows which ones are live
+        if( bFound && rcSequenceManager.getCurrentSequence() != NULL )
+        {
+            rcOutputArg.setParameter("sequences", QVariant::fromValue((void*)&rcSequenceManager.getAllSequences()));
+            rcOutputArg.setParameter("current_sequence", QVariant::fromValue((void*)rcSequenceManager.getCurrentSequence()));
+        }
+    }
+    return bFound;
+}
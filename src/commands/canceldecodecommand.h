@@ -0,0 +1,28 @@
+#ifndef CANCELDECODECOMMAND_H
+#define CANCELDECODECOMMAND_H
+
+#include <QObject>
+#include "gitlabstractcommand.h"
+
+/*!
+ * \brief The CancelDecodeCommand class
+ * kills the decoder of the background decoding "decode_job_id", or of all of them without the parameter.
+ * The job is cleaned up by its next DecodeJobCommand.
+ * Without the parameter it also stops following the growing bitstreams (see ComSequence::getFollowing).
+ */
+
+class CancelDecodeCommand : public GitlAbstractCommand
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE explicit CancelDecodeCommand(QObject *parent = 0);
+
+    Q_INVOKABLE bool execute(GitlCommandParameter &rcInputArg, GitlCommandParameter &rcOutputArg);
+
+signals:
+
+public slots:
+
+};
+
+#endif // CANCELDECODECOMMAND_H
@@ -12,6 +12,9 @@ bool CloseBitstreamCommand::execute( GitlCommandParameter &rcInputArg, GitlComma
     ModelLocator* pModel = ModelLocator::getInstance();
     SequenceManager& rcSequenceManager  = pModel->getSequenceManager();
     ComSequence* pcSequence = rcSequenceManager.getSequenceByFilename(strSequencePath);
+    /// a pre-scanned bitstream and its decoded frame ranges have the same file name
+    if( rcInputArg.hasParameter("sequence") )
+        pcSequence = (ComSequence*)rcInputArg.getParameter("sequence").value<void*>();
     if( rcSequenceManager.getAllSequences().size() > 1 &&   /// TODO do not allow close if there is only one sequence
         rcSequenceManager.delSequence(pcSequence) )
     {
@@ -0,0 +1,48 @@
+#include "decodejobcommand.h"
+#include "model/modellocator.h"
+#include "model/analysiscache.h"
+#include "gitlivkcmdevt.h"
+#include <QDebug>
+
+#define DECODE_JOB_POLL_INTERVAL 100    ///< ms, longest wait for the decoder in one execution
+
+DecodeJobCommand::DecodeJobCommand(QObject *parent) :
+    GitlAbstractCommand(parent)
+{
+}
+
+bool DecodeJobCommand::execute( GitlCommandParameter& rcInputArg, GitlCommandParameter& rcOutputArg )
+{
+    DecodeJob* pcJob = (DecodeJob*)(rcInputArg.getParameter("decode_job").value<void*>());
+    ModelLocator* pModel = ModelLocator::getInstance();
+
+    bool bFinished = pcJob->poll(DECODE_JOB_POLL_INTERVAL);
+    rcOutputArg.setParameter("decode_job_id", pcJob->getId());
+    rcOutputArg.setParameter("decode_job_file", pcJob->getFileName());
+    rcOutputArg.setParameter("decode_job_progress", pcJob->getProgress());
+    if( !bFinished )
+    {
+        /// poll again later
+        GitlIvkCmdEvt cJobEvt("decode_job");
+        cJobEvt.setParameter("decode_job", QVariant::fromValue((void*)pcJob));
+        cJobEvt.dispatch();
+        return true;
+    }
+
+    pModel->getDecodeJobs().removeOne(pcJob);
+    bool bSuccess = pcJob->isSuccessful();
+    if( bSuccess )
+    {
+        ComSequence* pcSequence = pcJob->takeSequence();
+        AnalysisCache::markComplete(pcSequence->getDecodingFolder());
+        qDebug() << "Background decoding finished:" << pcJob->getFileName();
+
+        pModel->getSequenceManager().addSequence(pcSequence);
+        pcSequence->setYUVRole(YUV_RECONSTRUCTED);      /// display the recon. by default
+        GitlIvkCmdEvt cSwitchSeq("switch_sequence");
+        cSwitchSeq.setParameter("sequence", QVariant::fromValue((void*)pcSequence));
+        cSwitchSeq.dispatch();
+    }
+    delete pcJob;
+    return bSuccess;
+}
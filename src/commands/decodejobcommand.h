@@ -0,0 +1,28 @@
+#ifndef DECODEJOBCOMMAND_H
+#define DECODEJOBCOMMAND_H
+
+#include <QObject>
+#include "gitlabstractcommand.h"
+
+/*!
+ * \brief The DecodeJobCommand class
+ * keeps a background decoding (DecodeJob) going: each execution polls the decoder once and reports
+ * the progress, then the command invokes itself again (other commands run in between).
+ * Once the job is finished its sequence is opened, or dropped if the decoding failed or was cancelled.
+ */
+
+class DecodeJobCommand : public GitlAbstractCommand
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE explicit DecodeJobCommand(QObject *parent = 0);
+
+    Q_INVOKABLE bool execute(GitlCommandParameter &rcInputArg, GitlCommandParameter &rcOutputArg);
+
+signals:
+
+public slots:
+
+};
+
+#endif // DECODEJOBCOMMAND_H
@@ -24,6 +24,19 @@ bool ModifyPreferencesCommand::execute(GitlCommandParameter &rcInputArg, GitlCom
         qDebug() << QString("Cache directory changed to %1...").arg(strCacheFolder);
         pModel->getPreferences().setCacheFolder(strCacheFolder);
     }
+    if( rcInputArg.hasParameter("shm_transport") )
+        pModel->getPreferences().setShmTransport(rcInputArg.getParameter("shm_transport").toBool());
+    if( rcInputArg.hasParameter("cache_decoder_output") )
+        pModel->getPreferences().setCacheDecoderOutput(rcInputArg.getParameter("cache_decoder_output").toBool());
+    if( rcInputArg.hasParameter("lazy_lcu_loading") )
+        pModel->getPreferences().setLazyLCULoading(rcInputArg.getParameter("lazy_lcu_loading").toBool());
+    if( rcInputArg.hasParameter("memory_budget_mb") )
+    {
+        pModel->getPreferences().setMemoryBudget(rcInputArg.getParameter("memory_budget_mb").toInt());
+        pModel->getSequenceManager().setMemoryBudget(qint64(pModel->getPreferences().getMemoryBudget()) << 20);
+    }
+    if( rcInputArg.hasParameter("parallel_decoding") )
+        pModel->getPreferences().setParallelDecoding(rcInputArg.getParameter("parallel_decoding").toBool());
 
     return true;
 }
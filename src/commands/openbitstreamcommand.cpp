@@ -1,20 +1,23 @@
 #include "openbitstreamcommand.h"
 #include "model/modellocator.h"
-#include "parsers/bitstreamparser.h"
-#include "parsers/spsparser.h"
-#include "parsers/decodergeneralparser.h"
-#include "parsers/cupuparser.h"
-#include "parsers/tuparser.h"
-#include "parsers/predparser.h"
-#include "parsers/mvparser.h"
-#include "parsers/mergeparser.h"
-#include "parsers/intraparser.h"
-#include "parsers/bitparser.h"
-#include "parsers/tileparser.h"
+#include "parsers/decoderoutputparser.h"
+#include "parsers/decodejob.h"
+#include "parsers/streamingbitstreamparser.h"
+#include "parsers/parallelbitstreamparser.h"
+#include "parsers/containerdemuxer.h"
+#ifdef HM_INPROCESS_DECODER
+#include "views/bitstreamversionselector.h"
+#endif
+#include "model/analysiscache.h"
+#include "model/memoryfootprint.h"
 #include "exceptions/decodingfailexception.h"
 #include "gitlupdateuievt.h"
 #include "gitlivkcmdevt.h"
 #include <QDir>
+#include <QFileInfo>
+#include <QScopedPointer>
+
+#define STREAMING_POLL_INTERVAL 100     ///< ms, wait for the decoder between two parsing passes
 
 
 OpenBitstreamCommand::OpenBitstreamCommand(QObject *parent) :
@@ -34,10 +37,69 @@ bool OpenBitstreamCommand::execute( GitlCommandParameter& rcInputArg, GitlComman
     int iVersion = vValue.toInt();
     vValue = rcInputArg.getParameter("skip_decode");
     bool bSkipDecode = vValue.toBool();
+    vValue = rcInputArg.getParameter("streaming");
+    bool bStreaming = vValue.toBool();      ///< display frames while the decoder is still running
+    vValue = rcInputArg.getParameter("analysis_categories");
+    QString strAnalysisCategories = vValue.toString();      ///< see BitstreamParser::setAnalysisSelection
+    vValue = rcInputArg.getParameter("first_poc");
+    int iFirstPOC = vValue.isValid() ? vValue.toInt() : 0;
+    vValue = rcInputArg.getParameter("last_poc");
+    int iLastPOC = vValue.isValid() ? vValue.toInt() : -1;
+    vValue = rcInputArg.getParameter("first_frame");
+    int iFirstFrame = vValue.isValid() ? vValue.toInt() : 0;    ///< decoding order, see DecodeJob::setFrameRange
+    vValue = rcInputArg.getParameter("last_frame");
+    int iLastFrame = vValue.isValid() ? vValue.toInt() : -1;
+    vValue = rcInputArg.getParameter("pre_scan");
+    bool bPreScan = vValue.toBool();        ///< slice headers only, see BitstreamParser::setPreScan
+    vValue = rcInputArg.getParameter("follow");
+    bool bFollow = vValue.toBool();         ///< the file is still being written, see BitstreamParser::setFollow
+    bool bShmTransport = pModel->getPreferences().getShmTransport();
+    bool bCacheDecoderOutput = pModel->getPreferences().getCacheDecoderOutput();
+    bool bParallelDecoding = pModel->getPreferences().getParallelDecoding();
     QString strDecoderPath = "./decoders";
-    QString strDecoderOutputPath = pModel->getPreferences().getCacheFolder();
-    int iSequenceIndex = pModel->getSequenceManager().getAllSequences().size();
-    strDecoderOutputPath += QString("/%1").arg(iSequenceIndex);
+    int iSequenceIndex = pModel->getSequenceManager().getAllSequences().size() + pModel->getDecodeJobs().size();
+
+    /// a partial analysis is decoded by a single HM process in the background:
+    /// the streaming parser, the segment joining and the in-process sink expect every category of every frame
+    QString strSelection;
+    if( !strAnalysisCategories.isEmpty() )
+        strSelection = strAnalysisCategories;
+    if( iFirstPOC != 0 || iLastPOC >= 0 )
+        strSelection += QString("_poc%1-%2").arg(iFirstPOC).arg(iLastPOC);
+    if( iFirstFrame > 0 || iLastFrame >= 0 )
+        strSelection += QString("_frames%1-%2").arg(iFirstFrame).arg(iLastFrame);
+    if( bPreScan )
+    {
+        if( !AnnexBIndex::isSupported(iVersion) )
+        {
+            qCritical() << "Pre-scan is only supported for HEVC bitstreams of HM-10.0 and later";
+            return false;
+        }
+        /// the whole bitstream, there is no per-LCU info to select from
+        strSelection = ANALYSIS_CACHE_PRESCAN;
+        iFirstFrame = 0;
+        iLastFrame = -1;
+    }
+    if( !strSelection.isEmpty() )
+    {
+        bStreaming = false;
+        bParallelDecoding = false;
+    }
+    /// a TS or MP4 file is demuxed into the stdin of a decoder process, it can not be split into segments
+    bool bContainer = ContainerDemuxer::isContainer(strFilename);
+    if( bContainer )
+        bParallelDecoding = false;
+    /// a growing file is decoded by one persistent decoder, its new frames are appended while streaming
+    if( bFollow )
+    {
+        if( (iVersion != HM100 && iVersion != HM120) || bContainer || !strSelection.isEmpty() )
+        {
+            qCritical() << "Only raw Annex-B bitstreams of HM-10.0 and later can be followed, with the full analysis";
+            return false;
+        }
+        bStreaming = true;
+        bParallelDecoding = false;
+    }
 
 
 
@@ -55,210 +117,208 @@ bool OpenBitstreamCommand::execute( GitlCommandParameter& rcInputArg, GitlComman
 
 
     //TODO BUG Memory Leaking when exception happens
-    if(pModel->getSequenceManager().getSequenceByFilename(strFilename) != NULL)
+    /// the frames of a pre-scanned bitstream are decoded on demand, as a sequence of their own
+    ComSequence* pcOpenSequence = pModel->getSequenceManager().getSequenceByFilename(strFilename);
+    if( pcOpenSequence != NULL && (bPreScan || !pcOpenSequence->getPreScan()) )
     {
         qCritical() << "This bitstream is already open...";
         return false;
     }
-    ComSequence* pcSequence = new ComSequence();
-    pcSequence->init();
-    pcSequence->setFileName(strFilename);
-
-    /// *****STEP 1 : Use the special decoder to parse bitstream*****
-    /// call decoder process to decode bitstream to YUV and output text info
-    GitlUpdateUIEvt cDecodingStageInfo;
-    bool bSuccess = false;
-    if( !bSkipDecode )
-    {
-        cDecodingStageInfo.setParameter("decoding_progress", "(1/11)Start Decoding Bitstream...");
-        dispatchEvt(cDecodingStageInfo);
-        BitstreamParser cBitstreamParser;
-        bSuccess = cBitstreamParser.parseFile(strDecoderPath,
-                                              iVersion,
-                                              strFilename,
-                                              strDecoderOutputPath,
-                                              pcSequence);
-        if( !bSuccess )
-            throw DecodingFailException();
-        qDebug() << "decoding finished";
-    }
-    else
+    foreach(DecodeJob* pcJob, pModel->getDecodeJobs())
     {
-        bSuccess = true;
-        qDebug() << "decoding skipped";
+        if( pcJob->getFileName() == strFilename )
+        {
+            qCritical() << "This bitstream is being decoded...";
+            return false;
+        }
     }
 
-
-    /// *****STEP 2 : Parse the txt file generated by decoder*****
-    /// Parse decoder_sps.txt
-    QString strSPSFilename = strDecoderOutputPath + "/decoder_sps.txt";
-    if( bSuccess )
+    /// decoder output goes to the cache folder named after the bitstream content,
+    /// a complete analysis found there is opened without decoding
+    /// (a followed file has no final content yet, it is neither hashed nor looked up)
+    GitlUpdateUIEvt cDecodingStageInfo;
+    cDecodingStageInfo.setParameter("decoding_progress", "(0/5)Looking Up Analysis Cache...");
+    dispatchEvt(cDecodingStageInfo);
+    AnalysisCache cAnalysisCache(pModel->getPreferences().getCacheFolder(), strFilename, iVersion);
+    cAnalysisCache.setSelection(strSelection);
+    QString strDecoderOutputPath;
+    bool bCached = false;
+    if( !bFollow && cAnalysisCache.init() )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(2/11)Start Parsing Sequence Parameter Set...");
-        dispatchEvt(cDecodingStageInfo);
-        QFile cSPSFile(strSPSFilename);
-        cSPSFile.open(QIODevice::ReadOnly);
-        QTextStream cSPSTextStream(&cSPSFile);
-        SpsParser cSpsParser;
-        bSuccess = cSpsParser.parseFile( &cSPSTextStream, pcSequence );
-        cSPSFile.close();
-        qDebug() << "SPS file parsing finished";
+        strDecoderOutputPath = cAnalysisCache.getFolder();
+        bCached = cAnalysisCache.isComplete();
+        /// the same content may still be decoding for another open sequence
+        foreach(ComSequence* pcOpenSequence, pModel->getSequenceManager().getAllSequences())
+        {
+            if( !bCached && !bSkipDecode && pcOpenSequence->getDecodingFolder() == strDecoderOutputPath )
+                strDecoderOutputPath += QString("_%1").arg(iSequenceIndex);
+        }
+        foreach(DecodeJob* pcJob, pModel->getDecodeJobs())
+        {
+            if( !bSkipDecode && pcJob->getOutputPath() == strDecoderOutputPath )
+                strDecoderOutputPath += QString("_job%1").arg(pcJob->getId());
+        }
     }
-    /// Parse decoder_general.txt
-    QString strGeneralFilename = strDecoderOutputPath + "/decoder_general.txt";
-    if( bSuccess )
+    else if( bFollow )
     {
-        cDecodingStageInfo.setParameter("message", "(3/11)Start Parsing Decoder Std Output File...");
-        dispatchEvt(cDecodingStageInfo);
-        QFile cGeneralFile(strGeneralFilename);
-        cGeneralFile.open(QIODevice::ReadOnly);
-        QTextStream cGeneralTextStream(&cGeneralFile);
-        DecoderGeneralParser cDecoderGeneralParser;
-        bSuccess = cDecoderGeneralParser.parseFile( &cGeneralTextStream, pcSequence );
-        cGeneralFile.close();
-        qDebug() << "Decoder general file parsing finished";
+        strDecoderOutputPath = pModel->getPreferences().getCacheFolder() + QString("/follow_%1").arg(iSequenceIndex);
     }
-
-    /// Parse decoder_cupu.txt
-    QString strCUPUFilename = strDecoderOutputPath + "/decoder_cupu.txt";
-    if( bSuccess )
+    else
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(4/11)Start Parsing CU & PU Structure...");
-        dispatchEvt(cDecodingStageInfo);
-        QFile cCUPUFile(strCUPUFilename);
-        cCUPUFile.open(QIODevice::ReadOnly);
-        QTextStream cCUPUTextStream(&cCUPUFile);
-        CUPUParser cCUPUParser;
-        bSuccess = cCUPUParser.parseFile( &cCUPUTextStream, pcSequence );
-        cCUPUFile.close();
-        qDebug() << "CU&PU file parsing finished";
+        /// unreadable bitstream, the decoder reports it
+        strDecoderOutputPath = pModel->getPreferences().getCacheFolder() + QString("/%1").arg(iSequenceIndex);
     }
-    /// Parse deocder_tu.txt
-    QString strTUFilename = strDecoderOutputPath + "/decoder_tu.txt";
-    if( bSuccess )
+    if( bCached && !bSkipDecode )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(5/11)Start Parsing TU Structure...");
-        dispatchEvt(cDecodingStageInfo);
-        QFile cTUFile(strTUFilename);
-        cTUFile.open(QIODevice::ReadOnly);
-        QTextStream cTUTextStream(&cTUFile);
-        TUParser cTUParser;
-        bSuccess = cTUParser.parseFile( &cTUTextStream, pcSequence );
-        cTUFile.close();
-        qDebug() << "TU file parsing finished";
+        qDebug() << "Analysis found in cache" << strDecoderOutputPath;
+        bSkipDecode = true;
     }
-
-    /// Parse decoder_pred.txt
-    QString strPredFilename = strDecoderOutputPath + "/decoder_pred.txt";
-    if( bSuccess )
+    /// a long bitstream decoded by one background decoder anyway gets checkpoints, a decoding killed on the way
+    /// goes on from its last one (a streamed or parallel decoding is never turned into a checkpointed one)
+    bool bCheckpoints = false;
+    if( !bSkipDecode && strDecoderOutputPath == cAnalysisCache.getFolder() )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(6/11)Start Parsing Predction Mode...");
-        dispatchEvt(cDecodingStageInfo);
-        QFile cPredFile(strPredFilename);
-        cPredFile.open(QIODevice::ReadOnly);
-        QTextStream cPredTextStream(&cPredFile);
-        PredParser cPredParser;
-        bSuccess = cPredParser.parseFile( &cPredTextStream, pcSequence );
-        cPredFile.close();
-        qDebug() << "Prediction file parsing finished";
+        bool bResume = !bStreaming && !bParallelDecoding && cAnalysisCache.canResume();
+        bCheckpoints = bResume ||
+                       ( !bStreaming && !bParallelDecoding && !bPreScan && iFirstFrame == 0 && iLastFrame < 0 && !bContainer &&
+                         AnnexBIndex::isSupported(iVersion) && QFileInfo(strFilename).size() > DECODE_CHECKPOINT_BYTES );
+        cAnalysisCache.begin(bResume);
     }
+    /// the folder was found by a few sampled blocks, the whole bitstream is hashed meanwhile
+    if( !bFollow )
+        cAnalysisCache.confirmInBackground();
 
-    /// Parse decoder_mv.txt
-    QString strMVFilename = strDecoderOutputPath + "/decoder_mv.txt";
-    if( bSuccess )
-    {
-        cDecodingStageInfo.setParameter("decoding_progress", "(7/11)Start Parsing Motion Vectors...");
-        dispatchEvt(cDecodingStageInfo);
-        QFile cMVFile(strMVFilename);
-        cMVFile.open(QIODevice::ReadOnly);
-        QTextStream cMVTextStream(&cMVFile);
-        MVParser cMVParser;
-        bSuccess = cMVParser.parseFile( &cMVTextStream, pcSequence );
-        cMVFile.close();
-        qDebug() << "MV file parsing finished";
-    }
+    ComSequence* pcSequence = new ComSequence();
+    pcSequence->init();
+    pcSequence->setFileName(strFilename);
+    pcSequence->setPreScan(bPreScan);
+    pcSequence->setFollowing(bFollow);
 
-    /// Parse decoder_merge.txt
-    QString strMergeFilename = strDecoderOutputPath + "/decoder_merge.txt";
-    if( bSuccess )
+#ifdef HM_INPROCESS_DECODER
+    if( !bSkipDecode && bCheckpoints && iVersion == HM120 && strSelection.isEmpty() )
+        qDebug() << "Long bitstream decoded by the HM process with checkpoints, not in process";
+#endif
+
+    /// *****STEP 1 : Use the special decoder to parse bitstream*****
+    /// call decoder process to decode bitstream to YUV and output text info
+    bool bSuccess = false;
+    QScopedPointer<StreamingBitstreamParser> pcStreamer;
+    if( !bSkipDecode && bStreaming )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(8/11)Start Parsing Motion Merge Info...");
+        cDecodingStageInfo.setParameter("decoding_progress", "(1/2)Start Decoding Bitstream In Streaming Mode...");
         dispatchEvt(cDecodingStageInfo);
-        QFile cMergeFile(strMergeFilename);
-        cMergeFile.open(QIODevice::ReadOnly);
-        QTextStream cMergeTextStream(&cMergeFile);
-        MergeParser cMergeParser;
-        bSuccess = cMergeParser.parseFile( &cMergeTextStream, pcSequence );
-        cMergeFile.close();
-        qDebug() << "Merge file parsing finished";
+        pcStreamer.reset(new StreamingBitstreamParser());
+        pcStreamer->setSharedMemoryTransport(bShmTransport, bCacheDecoderOutput);
+        pcStreamer->setFollow(bFollow);
+        if( !pcStreamer->start(strDecoderPath,
+                               iVersion,
+                               strFilename,
+                               strDecoderOutputPath,
+                               pcSequence) )
+            pcStreamer.reset();     ///< streaming not supported by this decoder
+        if( bFollow && pcStreamer.isNull() )
+            throw DecodingFailException();
     }
-
-    /// Parse decoder_intra.txt
-    QString strIntraFilename = strDecoderOutputPath + "/decoder_intra.txt";
-    if( bSuccess )
+    if( !pcStreamer.isNull() )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(9/11)Start Parsing Intra Info...");
+        /// return as soon as the first frame can be displayed
+        bSuccess = true;
+        while( bSuccess && !pcStreamer->isSequenceReady() && !pcStreamer->isFinished() )
+            bSuccess = pcStreamer->poll(STREAMING_POLL_INTERVAL);
+        if( !bSuccess || !pcStreamer->isSequenceReady() ||
+            (pcStreamer->isFinished() && !pcStreamer->isDecodingSuccessful()) )
+            throw DecodingFailException();
+        cDecodingStageInfo.setParameter("decoding_progress", "(2/2)First Frames Ready, Decoding Continues...");
         dispatchEvt(cDecodingStageInfo);
-        QFile cIntraFile(strIntraFilename);
-        cIntraFile.open(QIODevice::ReadOnly);
-        QTextStream cIntraTextStream(&cIntraFile);
-        IntraParser cIntraParser;
-        bSuccess = cIntraParser.parseFile( &cIntraTextStream, pcSequence );
-        cIntraFile.close();
-        qDebug() << "Intra file parsing finished";
+        qDebug() << "streaming started";
     }
-
-    /// Parse decoder_bit.txt
-    QString strLCUBitFilename = strDecoderOutputPath + "/decoder_bit_lcu.txt";
-    QString strSCUBitFilename = strDecoderOutputPath + "/decoder_bit_scu.txt";
-    if( bSuccess )
+    else if( !bSkipDecode && bParallelDecoding && ParallelBitstreamParser::isSupported(iVersion) )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(10/11)Start Parsing Bits Info...");
+        cDecodingStageInfo.setParameter("decoding_progress", "(1/5)Start Decoding Bitstream Segments In Parallel...");
         dispatchEvt(cDecodingStageInfo);
-        QFile cLCUBitFile(strLCUBitFilename);
-        cLCUBitFile.open(QIODevice::ReadOnly);
-        QTextStream cLCUBitTextStream(&cLCUBitFile);
-        BitParser cBitParser;
-        bSuccess = cBitParser.parseLCUBitFile( &cLCUBitTextStream, pcSequence );
-        cLCUBitFile.close();
-
-        QFile cSCUBitFile(strSCUBitFilename);
-        cSCUBitFile.open(QIODevice::ReadOnly);
-        QTextStream cSCUBitTextStream(&cSCUBitFile);
-        bSuccess = bSuccess && cBitParser.parseSCUBitFile( &cSCUBitTextStream, pcSequence );
-        cSCUBitFile.close();
-        qDebug() << "Bit file parsing finished";
+        ParallelBitstreamParser cParallelBitstreamParser;
+        cParallelBitstreamParser.setIndexFile(cAnalysisCache.getIndexFile());
+        bSuccess = cParallelBitstreamParser.parseFile(strDecoderPath,
+                                                      iVersion,
+                                                      strFilename,
+                                                      strDecoderOutputPath,
+                                                      pcSequence);
+        if( !bSuccess )
+            throw DecodingFailException();
+        qDebug() << "parallel decoding finished";
 
+        /// *****STEP 2 : Parse the txt file generated by decoder*****
+        bSuccess = xParseDecoderOutput(strDecoderOutputPath, pcSequence);
+        if( bSuccess )
+            AnalysisCache::markComplete(strDecoderOutputPath);
     }
-
-
-    ///parse decoder_tile.txt
-    QString strTileFilename = strDecoderOutputPath + "/decoder_tile.txt";
-    if( bSuccess )
+    else if( !bSkipDecode )
     {
-        cDecodingStageInfo.setParameter("decoding_progress", "(11/11)Start Parsing Tile Info...");
+        /// decode in the background, DecodeJobCommand parses the output and opens the sequence
+        /// (other commands, e.g. switching frames or opening another bitstream, are not blocked meanwhile)
+        cDecodingStageInfo.setParameter("decoding_progress", "(1/5)Start Decoding Bitstream In Background...");
         dispatchEvt(cDecodingStageInfo);
-        QFile cTileFile(strTileFilename);
-        if(cTileFile.open(QIODevice::ReadOnly))
-        {
-            QTextStream cTileTextStream(&cTileFile);
-            TileParser cTileParser;
-            bSuccess = cTileParser.parseFile( &cTileTextStream, pcSequence );
-            qDebug() << "Tile file parsing finished";
-        }
-        cTileFile.close();
+        QScopedPointer<DecodeJob> pcJob(new DecodeJob());
+        pcJob->setSharedMemoryTransport(bShmTransport, bCacheDecoderOutput);
+        pcJob->setLazyLCULoading(pModel->getPreferences().getLazyLCULoading());
+        pcJob->setAnalysisSelection(strAnalysisCategories, iFirstPOC, iLastPOC);
+        pcJob->setFrameRange(iFirstFrame, iLastFrame);
+        pcJob->setPreScan(bPreScan);
+        pcJob->setCheckpoints(bCheckpoints);
+        pcJob->setIndexFile(cAnalysisCache.getIndexFile());
+#ifdef HM_INPROCESS_DECODER
+        /// decoder library linked in, the sequence is built while decoding (no txt file to parse)
+        pcJob->setInProcess(iVersion == HM120 && strSelection.isEmpty() && !bContainer && !bCheckpoints);
+#endif
+        if( !pcJob->start(strDecoderPath,
+                          iVersion,
+                          strFilename,
+                          strDecoderOutputPath,
+                          pcSequence) )
+            throw DecodingFailException();
 
+        rcOutputArg.setParameter("decode_job_id", pcJob->getId());
+        pModel->getDecodeJobs().push_back(pcJob.data());
+        GitlIvkCmdEvt cJobEvt("decode_job");
+        cJobEvt.setParameter("decode_job", QVariant::fromValue((void*)pcJob.take()));
+        cJobEvt.dispatch();
+        return true;
     }
-
+    else
+    {
+        qDebug() << "decoding skipped";
+        /// *****STEP 2 : Parse the txt file generated by decoder*****
+        pcSequence->setDecodingFolder(strDecoderOutputPath);
+        bSuccess = xParseDecoderOutput(strDecoderOutputPath, pcSequence);
+    }
+    /// (a streamed sequence is parsed while decoding)
 
 
     ///*****STEP 3 : Open decoded YUV sequence*****
 
+    /// the decoder output on disk, once (a streamed sequence is measured again when its decoder is done)
+    pcSequence->setDiskBytes(MemoryFootprint::measureDisk(pcSequence->getDecodingFolder()));
     pModel->getSequenceManager().addSequence(pcSequence);
     pcSequence->setYUVRole(YUV_RECONSTRUCTED);      /// display the recon. by default
     GitlIvkCmdEvt cSwitchSeq("switch_sequence");
     cSwitchSeq.setParameter("sequence", QVariant::fromValue((void*)pcSequence));
     cSwitchSeq.dispatch();
 
+    /// keep following the decoder
+    if( !pcStreamer.isNull() && !pcStreamer->isFinished() )
+    {
+        GitlIvkCmdEvt cStreamEvt("stream_bitstream");
+        cStreamEvt.setParameter("streamer", QVariant::fromValue((void*)pcStreamer.take()));
+        cStreamEvt.dispatch();
+    }
+
     return bSuccess;
 }
+
+
+bool OpenBitstreamCommand::xParseDecoderOutput(const QString& strDecoderOutputPath, ComSequence* pcSequence)
+{
+    DecoderOutputParser cDecoderOutputParser;
+    cDecoderOutputParser.setLazyLCULoading(ModelLocator::getInstance()->getPreferences().getLazyLCULoading());
+    return cDecoderOutputParser.parseFolder(strDecoderOutputPath, pcSequence);
+}
@@ -2,6 +2,7 @@
 #define DECODEBITSTREAMCOMMAND_H
 #include "gitlabstractcommand.h"
 #include "gitlmodual.h"
+#include "model/common/comsequence.h"
 class OpenBitstreamCommand : public GitlAbstractCommand, GitlModual
 {
     Q_OBJECT
@@ -9,6 +10,10 @@ public:
     Q_INVOKABLE explicit OpenBitstreamCommand(QObject *parent = 0);
 
     Q_INVOKABLE bool execute(GitlCommandParameter &rcInputArg, GitlCommandParameter &rcOutputArg);
+
+protected:
+    /// parse all the files written by a finished decoding
+    bool xParseDecoderOutput(const QString& strDecoderOutputPath, ComSequence* pcSequence);
 signals:
 
 public slots:
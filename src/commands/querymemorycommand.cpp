@@ -0,0 +1,82 @@
+#include "querymemorycommand.h"
+#include "model/modellocator.h"
+#include "model/memoryfootprint.h"
+#include <QDebug>
+
+QueryMemoryCommand::QueryMemoryCommand(QObject *parent) :
+    GitlAbstractCommand(parent)
+{
+}
+
+/// parameter name of each MemoryCategory
+static const char* s_apcCategoryKeys[MEMORY_CATEGORY_NUM] =
+{
+    "cu", "pu", "tu", "grid", "frame", "buffer", "pixmap", "disk"
+};
+
+static QVariantMap xFootprintToMap(const MemoryFootprint& rcFootprint)
+{
+    QVariantMap cMap;
+    for(int i = 0; i < MEMORY_CATEGORY_NUM; i++)
+        cMap.insert(s_apcCategoryKeys[i], rcFootprint.getBytes((MemoryCategory)i));
+    cMap.insert("resident", rcFootprint.getResident());
+    return cMap;
+}
+
+bool QueryMemoryCommand::execute(GitlCommandParameter &rcInputArg, GitlCommandParameter &rcOutputArg)
+{
+    ModelLocator* pModel = ModelLocator::getInstance();
+    SequenceManager& rcSequenceManager = pModel->getSequenceManager();
+    bool bPerFrame = rcInputArg.hasParameter("per_frame") && rcInputArg.getParameter("per_frame").toBool();
+    bool bLog = rcInputArg.hasParameter("log") && rcInputArg.getParameter("log").toBool();
+
+    QVector<ComSequence*> apcSequences = rcSequenceManager.getAllSequences();
+    if( rcInputArg.hasParameter("sequence") )
+    {
+        ComSequence* pcSequence = (ComSequence*)rcInputArg.getParameter("sequence").value<void*>();
+        if( !apcSequences.contains(pcSequence) )
+            return false;
+        apcSequences.clear();
+        apcSequences.push_back(pcSequence);
+    }
+
+    QVariantList cFootprints;
+    qint64 iTotal = 0;
+    foreach(ComSequence* pcSequence, apcSequences)
+    {
+        MemoryFootprint cFootprint;
+        cFootprint.addSequence(pcSequence);
+        /// the frame buffer and the drawing are of the displayed sequence
+        if( pcSequence == rcSequenceManager.getCurrentSequence() )
+        {
+            cFootprint.addFrameBuffer(pModel->getFrameBuffer());
+            cFootprint.addPixmap(pModel->getDrawEngine().getDrawnPixmap());
+        }
+
+        QVariantMap cMap = xFootprintToMap(cFootprint);
+        cMap.insert("sequence", QVariant::fromValue((void*)pcSequence));
+        cMap.insert("file", pcSequence->getFileName());
+        cMap.insert("text", cFootprint.toText());
+        if( bPerFrame )
+        {
+            QVariantList cFrames;
+            foreach(ComFrame* pcFrame, pcSequence->getFramesInDisOrder())
+            {
+                MemoryFootprint cFrameFootprint;
+                cFrameFootprint.addFrame(pcFrame);
+                QVariantMap cFrameMap = xFootprintToMap(cFrameFootprint);
+                cFrameMap.insert("poc", pcFrame->getPOC());
+                cFrames.push_back(cFrameMap);
+            }
+            cMap.insert("frames", cFrames);
+        }
+        cFootprints.push_back(cMap);
+        iTotal += cFootprint.getResident();
+        if( bLog )
+            qDebug() << "Memory footprint of" << pcSequence->getFileName() << ":" << qPrintable(cFootprint.toText());
+    }
+
+    rcOutputArg.setParameter("memory_footprint", cFootprints);
+    rcOutputArg.setParameter("memory_total", iTotal);
+    return true;
+}
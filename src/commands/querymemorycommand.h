@@ -0,0 +1,31 @@
+#ifndef QUERYMEMORYCOMMAND_H
+#define QUERYMEMORYCOMMAND_H
+
+#include <QObject>
+#include "gitlabstractcommand.h"
+
+/*!
+ * \brief The QueryMemoryCommand class
+ * reports the memory footprint of the open sequences ("sequence" for one of them) as "memory_footprint",
+ * a list with one map per sequence: "sequence", "file", "text", "resident" and the bytes of each
+ * MemoryCategory ("cu", "pu", "tu", "grid", "frame", "buffer", "pixmap", "disk"). With "per_frame"
+ * the maps also hold "frames", the footprint of each frame in display order (with its "poc").
+ * "memory_total" is the resident size of all of them. With "log" the footprints are also written to the log
+ * (not for the sequence list tooltip, which queries on every show).
+ */
+
+class QueryMemoryCommand : public GitlAbstractCommand
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE explicit QueryMemoryCommand(QObject *parent = 0);
+
+    Q_INVOKABLE bool execute(GitlCommandParameter &rcInputArg, GitlCommandParameter &rcOutputArg);
+
+signals:
+
+public slots:
+
+};
+
+#endif // QUERYMEMORYCOMMAND_H
@@ -17,5 +17,10 @@ bool QueryPreferencesCommand::execute(GitlCommandParameter &rcInputArg, GitlComm
     Q_ASSERT(cCacheFolder.exists());
     strCacheFolder = cCacheFolder.absolutePath();
     rcOutputArg.setParameter("cache_path",   strCacheFolder);
+    rcOutputArg.setParameter("shm_transport",        pModel->getPreferences().getShmTransport());
+    rcOutputArg.setParameter("cache_decoder_output", pModel->getPreferences().getCacheDecoderOutput());
+    rcOutputArg.setParameter("lazy_lcu_loading",     pModel->getPreferences().getLazyLCULoading());
+    rcOutputArg.setParameter("memory_budget_mb",     pModel->getPreferences().getMemoryBudget());
+    rcOutputArg.setParameter("parallel_decoding",    pModel->getPreferences().getParallelDecoding());
     return true;
 }
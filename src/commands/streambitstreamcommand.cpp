@@ -0,0 +1,72 @@
+#include "streambitstreamcommand.h"
+#include "model/modellocator.h"
+#include "parsers/streamingbitstreamparser.h"
+#include "model/analysiscache.h"
+#include "model/memoryfootprint.h"
+#include "gitlivkcmdevt.h"
+#include <QDebug>
+
+#define STREAMING_POLL_INTERVAL 100     ///< ms, longest wait for the decoder in one execution
+
+StreamBitstreamCommand::StreamBitstreamCommand(QObject *parent) :
+    GitlAbstractCommand(parent)
+{
+}
+
+bool StreamBitstreamCommand::execute( GitlCommandParameter& rcInputArg, GitlCommandParameter& rcOutputArg )
+{
+    StreamingBitstreamParser* pcStreamer = (StreamingBitstreamParser*)(rcInputArg.getParameter("streamer").value<void*>());
+    ModelLocator* pModel = ModelLocator::getInstance();
+    SequenceManager& rcSequenceManager = pModel->getSequenceManager();
+
+    /// sequence closed while decoding, stop the decoder
+    ComSequence* pcSequence = pcStreamer->getSequence();
+    if( rcSequenceManager.getSequenceByFilename(pcStreamer->getFileName()) != pcSequence )
+    {
+        qDebug() << "Streaming stopped, sequence closed";
+        delete pcStreamer;
+        return false;
+    }
+
+    /// follow mode stopped (cancel_decode), the decoder gets the rest of the file and exits
+    if( !pcSequence->getFollowing() )
+        pcStreamer->stopFollowing();
+
+    int iLastTotalFrames = pcSequence->getTotalFrames();
+    bool bSuccess = pcStreamer->poll(STREAMING_POLL_INTERVAL);
+    pcSequence->invalidateStatistics();
+    if( !bSuccess )
+        qCritical() << "Streaming FAILED, the decoder output can not be parsed";
+    else if( pcStreamer->isFinished() && !pcStreamer->isDecodingSuccessful() )
+        qCritical() << "Bitstream decoding FAILED!";
+
+    if( bSuccess && !pcStreamer->isFinished() )
+    {
+        /// poll again later
+        GitlIvkCmdEvt cStreamEvt("stream_bitstream");
+        cStreamEvt.setParameter("streamer", QVariant::fromValue((void*)pcStreamer));
+        cStreamEvt.dispatch();
+    }
+    else
+    {
+        qDebug() << "Streaming finished," << pcSequence->getTotalFrames() << "frames";
+        /// (a followed file is decoded into a folder without manifest, it is never reused)
+        if( bSuccess && pcStreamer->isDecodingSuccessful() )
+            AnalysisCache::markComplete(pcSequence->getDecodingFolder());
+        pcSequence->setDiskBytes(MemoryFootprint::measureDisk(pcSequence->getDecodingFolder()));
+        pcSequence->setFollowing(false);
+        delete pcStreamer;
+    }
+
+    /// notify UI update (time line and frame number)
+    if( pcSequence->getTotalFrames() != iLastTotalFrames &&
+        pcSequence == rcSequenceManager.getCurrentSequence() )
+    {
+        QVector<ComSequence*>* ppcSequences = &(rcSequenceManager.getAllSequences());
+        rcOutputArg.setParameter("sequences", QVariant::fromValue((void*)ppcSequences));
+        rcOutputArg.setParameter("current_sequence", QVariant::fromValue((void*)pcSequence));
+        rcOutputArg.setParameter("total_frame_num", pcSequence->getTotalFrames());
+    }
+
+    return bSuccess;
+}
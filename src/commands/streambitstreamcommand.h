@@ -0,0 +1,28 @@
+#ifndef STREAMBITSTREAMCOMMAND_H
+#define STREAMBITSTREAMCOMMAND_H
+
+#include <QObject>
+#include "gitlabstractcommand.h"
+
+/*!
+ * \brief The StreamBitstreamCommand class
+ * keeps building a sequence opened in streaming mode while its decoder is running.
+ * Each execution polls the decoder once, then the command invokes itself again
+ * (other commands run in between), until the decoder has exited.
+ */
+
+class StreamBitstreamCommand : public GitlAbstractCommand
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE explicit StreamBitstreamCommand(QObject *parent = 0);
+
+    Q_INVOKABLE bool execute(GitlCommandParameter &rcInputArg, GitlCommandParameter &rcOutputArg);
+
+signals:
+
+public slots:
+
+};
+
+#endif // STREAMBITSTREAMCOMMAND_H
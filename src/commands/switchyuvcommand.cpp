@@ -50,7 +50,10 @@ bool SwitchYUVCommand::execute( GitlCommandParameter& rcInputArg, GitlCommandPar
         //
         int iWidth = pcSequence->getWidth();
         int iHeight = pcSequence->getHeight();
-        pModel->getFrameBuffer().openYUVFile(pcSequence->getDecodingFolder()+"/"+strYUVFilename, iWidth, iHeight, bIs16Bit);
+        QString strYUVPath = pcSequence->getDecodingFolder()+"/"+strYUVFilename;
+        if( pcSequence->getPreScan() )
+            strYUVPath.clear();     ///< nothing reconstructed
+        pModel->getFrameBuffer().openYUVFile(strYUVPath, iWidth, iHeight, bIs16Bit);
 
         /// refresh
         GitlIvkCmdEvt cRefreshEvt("refresh_screen");
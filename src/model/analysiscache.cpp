@@ -0,0 +1,278 @@
+#include "analysiscache.h"
+#include <QFile>
+#include <QDir>
+#include <QSettings>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QStringList>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QDebug>
+
+#define CACHE_MANIFEST          "/manifest.ini"
+#define CACHE_MANIFEST_VERSION  2               ///< 2: the folder key hashes sampled blocks only
+#define CACHE_HASH_BLOCK        (1 << 20)       ///< bytes hashed per read, and per sampled block
+#define CACHE_FULL_HASH         "/bitstream.md5"
+#define CACHE_INDEX_SUFFIX      "_annexb.idx"
+
+/// the full hash of a bitstream, see AnalysisCache::confirmInBackground()
+class HashConfirmTask : public QRunnable
+{
+public:
+    HashConfirmTask(const QString& strFolder, const QString& strBitstreamFilePath) :
+        m_strFolder(strFolder), m_strBitstreamFilePath(strBitstreamFilePath)
+    {
+        setAutoDelete(true);
+    }
+    void run()
+    {
+        AnalysisCache::confirmHash(m_strFolder, m_strBitstreamFilePath);
+    }
+private:
+    QString m_strFolder;
+    QString m_strBitstreamFilePath;
+};
+
+/// MD5 of bytes [iStart, iEnd) of the file, added to rcHash
+static bool xHashRange(QFile& rcFile, qint64 iStart, qint64 iEnd, QCryptographicHash& rcHash)
+{
+    if( !rcFile.seek(iStart) )
+        return false;
+    for(qint64 iPos = iStart; iPos < iEnd; )
+    {
+        QByteArray cBlock = rcFile.read(qMin(iEnd - iPos, (qint64)CACHE_HASH_BLOCK));
+        if( cBlock.isEmpty() )
+            return false;
+        rcHash.addData(cBlock);
+        iPos += cBlock.size();
+    }
+    return true;
+}
+
+AnalysisCache::AnalysisCache(const QString& strCacheFolder, const QString& strBitstreamFilePath, int iDecoderVersion)
+{
+    m_strCacheFolder = strCacheFolder;
+    m_strBitstreamFilePath = strBitstreamFilePath;
+    m_iDecoderVersion = iDecoderVersion;
+    m_iBitstreamSize = 0;
+}
+
+bool AnalysisCache::init()
+{
+    QFile cBitstreamFile(m_strBitstreamFilePath);
+    if( !cBitstreamFile.open(QIODevice::ReadOnly) )
+        return false;
+
+    /// MD5 is not for security here, it only has to be fast and spread well
+    /// (the size and three blocks, so opening a big bitstream does not wait for the whole file to be read)
+    QCryptographicHash cHash(QCryptographicHash::Md5);
+    m_iBitstreamSize = cBitstreamFile.size();
+    cHash.addData(QByteArray::number(m_iBitstreamSize));
+    bool bRead;
+    if( m_iBitstreamSize <= 3 * CACHE_HASH_BLOCK )
+    {
+        bRead = xHashRange(cBitstreamFile, 0, m_iBitstreamSize, cHash);
+    }
+    else
+    {
+        qint64 iMiddle = (m_iBitstreamSize - CACHE_HASH_BLOCK) / 2;
+        bRead = xHashRange(cBitstreamFile, 0, CACHE_HASH_BLOCK, cHash) &&
+                xHashRange(cBitstreamFile, iMiddle, iMiddle + CACHE_HASH_BLOCK, cHash) &&
+                xHashRange(cBitstreamFile, m_iBitstreamSize - CACHE_HASH_BLOCK, m_iBitstreamSize, cHash);
+    }
+    if( !bRead )
+        return false;
+    m_strHash = cHash.result().toHex();
+    m_strKey = QString("%1_%2").arg(m_strHash).arg(m_iDecoderVersion);
+    if( !m_strSelection.isEmpty() )
+        m_strKey += "_" + m_strSelection;
+    m_strFolder = m_strCacheFolder + "/" + m_strKey;
+    return true;
+}
+
+void AnalysisCache::confirmInBackground() const
+{
+    if( m_strFolder.isEmpty() )
+        return;
+    QThreadPool::globalInstance()->start(new HashConfirmTask(m_strFolder, m_strBitstreamFilePath));
+}
+
+void AnalysisCache::confirmHash(const QString& strFolder, const QString& strBitstreamFilePath)
+{
+    QFile cBitstreamFile(strBitstreamFilePath);
+    if( !cBitstreamFile.open(QIODevice::ReadOnly) )
+        return;
+    QCryptographicHash cHash(QCryptographicHash::Md5);
+    if( !xHashRange(cBitstreamFile, 0, cBitstreamFile.size(), cHash) )
+        return;
+    QByteArray cFullHash = cHash.result().toHex();
+
+    /// the first bitstream decoded into the folder sets its full hash
+    QFile cHashFile(strFolder + CACHE_FULL_HASH);
+    if( !cHashFile.exists() )
+    {
+        if( cHashFile.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+            cHashFile.write(cFullHash);
+        return;
+    }
+    if( !cHashFile.open(QIODevice::ReadOnly) || cHashFile.readAll().trimmed() == cFullHash )
+        return;
+    cHashFile.close();
+
+    /// (the files stay, an open sequence may be using them)
+    qWarning() << "Analysis cache" << strFolder << "belongs to another bitstream with the same size and samples as"
+               << strBitstreamFilePath << ", it will be decoded again next time";
+    QFile::remove(strFolder + CACHE_MANIFEST);
+    QFile::remove(strFolder + CACHE_FULL_HASH);
+}
+
+bool AnalysisCache::isComplete() const
+{
+    if( !xIsSameBitstream() )
+        return false;
+    QSettings cManifest(m_strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    if( !cManifest.value("analysis/complete").toBool() )
+        return false;
+
+    /// the files may have been removed by hand
+    return xHasAnalysisFiles(m_strFolder);
+}
+
+bool AnalysisCache::canResume() const
+{
+    if( !xIsSameBitstream() )
+        return false;
+    QVector<int> aiSections;
+    QVector<qint64> aiOffsets;
+    return readCheckpoints(m_strFolder, aiSections, aiOffsets) > 0;
+}
+
+bool AnalysisCache::xIsSameBitstream() const
+{
+    if( m_strFolder.isEmpty() || !QFile::exists(m_strFolder + CACHE_MANIFEST) )
+        return false;
+
+    QSettings cManifest(m_strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    return cManifest.value("manifest_version").toInt() == CACHE_MANIFEST_VERSION &&
+           cManifest.value("bitstream/hash").toString() == m_strHash &&
+           cManifest.value("bitstream/size").toLongLong() == m_iBitstreamSize &&
+           cManifest.value("decoder/version").toInt() == m_iDecoderVersion &&
+           cManifest.value("analysis/selection").toString() == m_strSelection;
+}
+
+QString AnalysisCache::getIndexFile() const
+{
+    if( m_strHash.isEmpty() )
+        return QString();
+    return m_strCacheFolder + "/" + m_strHash + CACHE_INDEX_SUFFIX;
+}
+
+bool AnalysisCache::begin(bool bResume)
+{
+    if( m_strFolder.isEmpty() )
+        return false;
+    QDir cCurDir = QDir::current();
+    if( !cCurDir.exists(m_strFolder) )
+        cCurDir.mkpath(m_strFolder);
+
+    if( bResume && canResume() )
+    {
+        QSettings cManifest(m_strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+        cManifest.setValue("analysis/complete", false);
+        cManifest.setValue("analysis/resumed", QDateTime::currentDateTime().toString(Qt::ISODate));
+        cManifest.sync();
+        return cManifest.status() == QSettings::NoError;
+    }
+
+    QFile::remove(m_strFolder + CACHE_MANIFEST);
+    QFile::remove(m_strFolder + CACHE_FULL_HASH);       ///< of the bitstream decoded here before
+    QSettings cManifest(m_strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    cManifest.setValue("manifest_version", CACHE_MANIFEST_VERSION);
+    cManifest.setValue("bitstream/file", m_strBitstreamFilePath);
+    cManifest.setValue("bitstream/hash", m_strHash);
+    cManifest.setValue("bitstream/size", m_iBitstreamSize);
+    cManifest.setValue("decoder/version", m_iDecoderVersion);
+    cManifest.setValue("analysis/selection", m_strSelection);
+    cManifest.setValue("analysis/complete", false);
+    cManifest.setValue("analysis/created", QDateTime::currentDateTime().toString(Qt::ISODate));
+    cManifest.sync();
+    return cManifest.status() == QSettings::NoError;
+}
+
+bool AnalysisCache::markComplete(const QString& strFolder)
+{
+    if( !QFile::exists(strFolder + CACHE_MANIFEST) )
+        return false;
+    if( !xHasAnalysisFiles(strFolder) )
+    {
+        qDebug() << "Analysis is not on disk, it will not be reused:" << strFolder;
+        return false;
+    }
+    QSettings cManifest(strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    cManifest.setValue("analysis/complete", true);
+    cManifest.remove("checkpoint");
+    cManifest.sync();
+    return cManifest.status() == QSettings::NoError;
+}
+
+int AnalysisCache::readCheckpoints(const QString& strFolder, QVector<int>& raiSections, QVector<qint64>& raiOffsets)
+{
+    raiSections.clear();
+    raiOffsets.clear();
+    if( !QFile::exists(strFolder + CACHE_MANIFEST) )
+        return 0;
+    QSettings cManifest(strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    QStringList astrSections = cManifest.value("checkpoint/sections").toString().split(',', QString::SkipEmptyParts);
+    QStringList astrOffsets = cManifest.value("checkpoint/offsets").toString().split(',', QString::SkipEmptyParts);
+    if( astrSections.size() != astrOffsets.size() )
+        return 0;
+    for(int i = 0; i < astrSections.size(); i++)
+    {
+        raiSections.push_back(astrSections[i].toInt());
+        raiOffsets.push_back(astrOffsets[i].toLongLong());
+    }
+    return qBound(0, cManifest.value("checkpoint/done", 0).toInt(), raiSections.size());
+}
+
+bool AnalysisCache::writeCheckpoints(const QString& strFolder, const QVector<int>& raiSections, const QVector<qint64>& raiOffsets)
+{
+    if( !QFile::exists(strFolder + CACHE_MANIFEST) )
+        return false;
+    QStringList astrSections, astrOffsets;
+    for(int i = 0; i < raiSections.size(); i++)
+    {
+        astrSections << QString::number(raiSections[i]);
+        astrOffsets << QString::number(raiOffsets[i]);
+    }
+    QSettings cManifest(strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    cManifest.setValue("checkpoint/sections", astrSections.join(","));
+    cManifest.setValue("checkpoint/offsets", astrOffsets.join(","));
+    cManifest.setValue("checkpoint/done", 0);
+    cManifest.sync();
+    return cManifest.status() == QSettings::NoError;
+}
+
+bool AnalysisCache::markCheckpoint(const QString& strFolder, int iSectionsDone)
+{
+    if( !QFile::exists(strFolder + CACHE_MANIFEST) )
+        return false;
+    QSettings cManifest(strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    cManifest.setValue("checkpoint/done", iSectionsDone);
+    cManifest.setValue("checkpoint/time", QDateTime::currentDateTime().toString(Qt::ISODate));
+    cManifest.sync();
+    return cManifest.status() == QSettings::NoError;
+}
+
+bool AnalysisCache::xHasAnalysisFiles(const QString& strFolder)
+{
+    /// everything xParseDecoderOutput needs, per-LCU info in txt files or in the binary container
+    if( !QFile::exists(strFolder + "/decoder_sps.txt") ||
+        !QFile::exists(strFolder + "/decoder_general.txt") )
+        return false;
+    QSettings cManifest(strFolder + CACHE_MANIFEST, QSettings::IniFormat);
+    if( cManifest.value("analysis/selection").toString() == ANALYSIS_CACHE_PRESCAN )
+        return true;
+    return QFile::exists(strFolder + "/decoder_yuv.yuv") &&
+           ( QFile::exists(strFolder + "/decoder_analysis.bin") ||
+             QFile::exists(strFolder + "/decoder_cupu.txt") );
+}
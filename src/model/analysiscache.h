@@ -0,0 +1,90 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include "gitldef.h"
+#include <QString>
+#include <QVector>
+
+#define ANALYSIS_CACHE_PRESCAN  "prescan"       ///< selection of a pre-scan (frames only, no picture, no per-LCU info)
+
+/*!
+ * \brief The AnalysisCache class
+ * one folder of the cache (Preferences::getCacheFolder()) holds the decoder output of one bitstream,
+ * the folder is named after a hash of the bitstream content and the decoder version,
+ * so the same stream opened again (even after a restart or under another name) is found.
+ * Only the size and a few blocks of the bitstream are hashed when it is opened, the whole content
+ * is hashed on a worker thread afterwards (see confirmInBackground()): a folder whose full hash
+ * does not match is not reused. The manifest.ini in the folder describes the
+ * stream and tells whether the analysis in it is complete and can be opened without decoding.
+ * A partial analysis (some categories, a POC window or a frame range only) has a folder of its own.
+ * A pre-scan is a selection as well, its folder holds no YUV and no per-LCU info.
+ * The NAL unit index of the bitstream (AnnexBIndex) is kept next to the folders, shared by all analyses of it.
+ * A long decoding records checkpoints in the manifest (see DecodeJob): the cut points it is split at and how many
+ * of the sections are decoded, so an unfinished decoding of the same bitstream goes on from the last one.
+ */
+
+class AnalysisCache
+{
+public:
+    AnalysisCache(const QString& strCacheFolder, const QString& strBitstreamFilePath, int iDecoderVersion);
+
+    /// a partial analysis, e.g. "cupu,bit_lcu_poc500-600", empty for the full one (call it before init())
+    void setSelection(const QString& strSelection) { m_strSelection = strSelection; }
+
+    /// hash the size and the first, middle and last blocks of the bitstream, false if it can not be read (getFolder() is empty then)
+    bool init();
+
+    /*!
+     * \brief confirmInBackground hash the whole bitstream on a worker thread (call it once the folder is chosen):
+     * the first full hash is kept in the folder, a later one which differs means another bitstream with the same
+     * samples, the manifest is dropped then so the folder is decoded again instead of being reused
+     */
+    void confirmInBackground() const;
+    /// the body of the worker, see confirmInBackground()
+    static void confirmHash(const QString& strFolder, const QString& strBitstreamFilePath);
+
+    /// a complete analysis of this bitstream is in getFolder()
+    bool isComplete() const;
+
+    /// cache file of the AnnexBIndex of this bitstream, empty before init()
+    QString getIndexFile() const;
+
+    /// an unfinished decoding into getFolder() has reached a checkpoint, a new one can resume from there
+    bool canResume() const;
+
+    /*!
+     * \brief begin a new decoding is about to write into getFolder(): the old manifest is replaced by an incomplete one
+     * \param bResume keep the checkpoints of the manifest (see canResume())
+     */
+    bool begin(bool bResume = false);
+
+    /// sections decoded so far (0 if none), raiSections/raiOffsets are the first picture/byte of every section
+    static int readCheckpoints(const QString& strFolder, QVector<int>& raiSections, QVector<qint64>& raiOffsets);
+    /// a new plan of sections, none of them decoded yet
+    static bool writeCheckpoints(const QString& strFolder, const QVector<int>& raiSections, const QVector<qint64>& raiOffsets);
+    /// the first iSectionsDone sections are decoded
+    static bool markCheckpoint(const QString& strFolder, int iSectionsDone);
+
+    /*!
+     * \brief markComplete called once the decoding into strFolder is finished successfully
+     * \return false if the analysis can not be opened again without decoding (e.g. it was kept in memory only)
+     */
+    static bool markComplete(const QString& strFolder);
+
+    ADD_CLASS_FIELD_NOSETTER(QString, strFolder, getFolder)             ///< cache folder of this bitstream
+    ADD_CLASS_FIELD_NOSETTER(QString, strKey, getKey)                   ///< <hash>_<decoder version>[_<selection>]
+
+protected:
+    static bool xHasAnalysisFiles(const QString& strFolder);
+    /// the manifest of getFolder() describes this bitstream and decoder (complete or not)
+    bool xIsSameBitstream() const;
+
+    QString m_strCacheFolder;
+    QString m_strBitstreamFilePath;
+    int m_iDecoderVersion;
+    QString m_strHash;
+    QString m_strSelection;
+    qint64 m_iBitstreamSize;
+};
+
+#endif // ANALYSISCACHE_H
@@ -0,0 +1,37 @@
+#include "comarena.h"
+
+ComCU* ComArena::newCUs(ComFrame* pcFrame, int iNum)
+{
+    ComCU* pcCUs = m_cCUs.allocate(iNum);
+    for(int i = 0; i < iNum; i++)
+        new (pcCUs+i) ComCU(pcFrame);
+    return pcCUs;
+}
+
+ComPU* ComArena::newPUs(ComCU* pcCU, int iNum)
+{
+    ComPU* pcPUs = m_cPUs.allocate(iNum);
+    for(int i = 0; i < iNum; i++)
+        new (pcPUs+i) ComPU(pcCU);
+    return pcPUs;
+}
+
+ComTU* ComArena::newTUs(int iNum)
+{
+    ComTU* pcTUs = m_cTUs.allocate(iNum);
+    for(int i = 0; i < iNum; i++)
+        new (pcTUs+i) ComTU();
+    return pcTUs;
+}
+
+void ComArena::clear()
+{
+    m_cPUs.clear();
+    m_cTUs.clear();
+    m_cCUs.clear();
+}
+
+qint64 ComArena::getMemory() const
+{
+    return m_cCUs.getMemory() + m_cPUs.getMemory() + m_cTUs.getMemory();
+}
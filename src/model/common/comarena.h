@@ -0,0 +1,119 @@
+#ifndef COMARENA_H
+#define COMARENA_H
+
+#include "comcu.h"
+#include <QVector>
+#include <new>
+
+#define ARENA_FIRST_CHUNK   64      ///< nodes in the first chunk of a pool, doubled for each new chunk
+#define ARENA_MAX_CHUNK     4096    ///< nodes in one chunk at most
+
+/*!
+ * \brief The ComNodePool class
+ * nodes of one type in a few large chunks, handed out in parsing order.
+ * A run of siblings never straddles two chunks, addresses stay valid until clear()
+ */
+
+template <typename T>
+class ComNodePool
+{
+public:
+    ComNodePool() : m_iChunkSize(0) {}
+    ~ComNodePool() { clear(); }
+
+    /// uninitialised room for iNum nodes side by side, construct them with placement new
+    T* allocate(int iNum)
+    {
+        if( iNum == 0 )
+            return NULL;
+        if( m_apcChunks.isEmpty() || m_aiUsed.last() + iNum > m_iChunkSize )
+            xAddChunk(iNum);
+        T* pcNodes = m_apcChunks.last() + m_aiUsed.last();
+        m_aiUsed.last() += iNum;
+        return pcNodes;
+    }
+
+    /// destroy all nodes and free the chunks
+    void clear()
+    {
+        for(int i = 0; i < m_apcChunks.size(); i++)
+        {
+            for(int j = 0; j < m_aiUsed.at(i); j++)
+                m_apcChunks.at(i)[j].~T();
+            ::operator delete(m_apcChunks.at(i));
+        }
+        m_apcChunks.clear();
+        m_aiUsed.clear();
+        m_iChunkSize = 0;
+    }
+
+    /// chunk bytes in use, including the unused tail of each chunk
+    qint64 getMemory() const
+    {
+        qint64 iMemory = 0;
+        int iSize = ARENA_FIRST_CHUNK;
+        for(int i = 0; i < m_apcChunks.size(); i++)
+        {
+            iMemory += qint64(iSize)*sizeof(T);
+            iSize = qMin(iSize*2, (int)ARENA_MAX_CHUNK);
+        }
+        return iMemory + m_apcChunks.capacity()*sizeof(T*) + m_aiUsed.capacity()*sizeof(int);
+    }
+
+protected:
+    void xAddChunk(int iNum)
+    {
+        m_iChunkSize = (m_iChunkSize == 0) ? ARENA_FIRST_CHUNK : qMin(m_iChunkSize*2, (int)ARENA_MAX_CHUNK);
+        Q_ASSERT( iNum <= m_iChunkSize );
+        m_apcChunks.push_back(static_cast<T*>(::operator new(sizeof(T)*m_iChunkSize)));
+        m_aiUsed.push_back(0);
+    }
+
+    QVector<T*> m_apcChunks;
+    QVector<int> m_aiUsed;      ///< constructed nodes in each chunk
+    int m_iChunkSize;           ///< size of the last chunk
+
+private:
+    Q_DISABLE_COPY(ComNodePool)
+};
+
+
+/*!
+ * \brief The ComArena class
+ * owns every CU, PU and TU node of one frame (LCUs included).
+ * Children of a node are allocated together and linked as a run (first node + count),
+ * the whole frame is released at once instead of node by node.
+ * The TU pool is separate so the TU parser can run next to the PU attribute parsers
+ */
+
+class ComArena
+{
+public:
+    ComArena() {}
+
+    /// iNum CUs side by side
+    ComCU* newCUs(ComFrame* pcFrame, int iNum);
+    /// iNum PUs of pcCU side by side
+    ComPU* newPUs(ComCU* pcCU, int iNum);
+    /// iNum TUs side by side
+    ComTU* newTUs(int iNum);
+
+    /// free all nodes, pointers into the arena are invalid afterwards
+    void clear();
+
+    /// heap size of the nodes in bytes (MVs are stored inside the PUs)
+    qint64 getMemory() const;
+    qint64 getCUMemory() const { return m_cCUs.getMemory(); }
+    qint64 getPUMemory() const { return m_cPUs.getMemory(); }
+    qint64 getTUMemory() const { return m_cTUs.getMemory(); }
+
+protected:
+    ComNodePool<ComCU> m_cCUs;
+    ComNodePool<ComPU> m_cPUs;
+    ComNodePool<ComTU> m_cTUs;
+
+private:
+    Q_DISABLE_COPY(ComArena)
+};
+
+#endif // COMARENA_H
@@ -0,0 +1,120 @@
+#include "comblockgrid.h"
+#include "comframe.h"
+#include "comsequence.h"
+
+ComBlockGrid::ComBlockGrid()
+{
+    m_iWidth = 0;
+    m_iHeight = 0;
+    m_iLCUNum = -1;
+}
+
+void ComBlockGrid::build(ComFrame* pcFrame)
+{
+    clear();
+    ComSequence* pcSequence = pcFrame->getSequence();
+    m_iWidth = (pcSequence->getWidth()+GRID_BLOCK_SIZE-1)/GRID_BLOCK_SIZE;
+    m_iHeight = (pcSequence->getHeight()+GRID_BLOCK_SIZE-1)/GRID_BLOCK_SIZE;
+    ComGridBlock cEmpty = { -1, -1, -1 };
+    m_acBlocks.fill(cEmpty, m_iWidth*m_iHeight);
+
+    const QVector<ComCU*>& rapcLCUs = pcFrame->getLCUs();
+    foreach(ComCU* pcLCU, rapcLCUs)
+        xAddCU(pcLCU);
+    m_iLCUNum = rapcLCUs.size();
+}
+
+void ComBlockGrid::clear()
+{
+    m_acBlocks.clear();
+    m_apcLeafCUs.clear();
+    m_apcPUs.clear();
+    m_apcLeafTUs.clear();
+    m_iWidth = 0;
+    m_iHeight = 0;
+    m_iLCUNum = -1;
+}
+
+ComCU* ComBlockGrid::getCU(int iX, int iY) const
+{
+    const ComGridBlock* pcBlock = xGetBlock(iX, iY);
+    return (pcBlock == NULL || pcBlock->iCU < 0) ? NULL : m_apcLeafCUs.at(pcBlock->iCU);
+}
+
+ComPU* ComBlockGrid::getPU(int iX, int iY) const
+{
+    const ComGridBlock* pcBlock = xGetBlock(iX, iY);
+    return (pcBlock == NULL || pcBlock->iPU < 0) ? NULL : m_apcPUs.at(pcBlock->iPU);
+}
+
+ComTU* ComBlockGrid::getTU(int iX, int iY) const
+{
+    const ComGridBlock* pcBlock = xGetBlock(iX, iY);
+    return (pcBlock == NULL || pcBlock->iTU < 0) ? NULL : m_apcLeafTUs.at(pcBlock->iTU);
+}
+
+qint64 ComBlockGrid::getMemory() const
+{
+    return m_acBlocks.capacity()*sizeof(ComGridBlock) + m_apcLeafCUs.capacity()*sizeof(ComCU*) +
+           m_apcPUs.capacity()*sizeof(ComPU*) + m_apcLeafTUs.capacity()*sizeof(ComTU*);
+}
+
+const ComGridBlock* ComBlockGrid::xGetBlock(int iX, int iY) const
+{
+    if( iX < 0 || iY < 0 )
+        return NULL;
+    int iBlockX = iX/GRID_BLOCK_SIZE;
+    int iBlockY = iY/GRID_BLOCK_SIZE;
+    if( iBlockX >= m_iWidth || iBlockY >= m_iHeight )
+        return NULL;
+    return &m_acBlocks.at(iBlockY*m_iWidth+iBlockX);
+}
+
+void ComBlockGrid::xAddCU(ComCU* pcCU)
+{
+    if( !pcCU->getSCUs().empty() )
+    {
+        foreach(ComCU* pcSCU, pcCU->getSCUs())
+            xAddCU(pcSCU);
+        return;
+    }
+
+    /// leaf CU
+    xFill(pcCU->getX(), pcCU->getY(), pcCU->getSize(), pcCU->getSize(), &ComGridBlock::iCU, m_apcLeafCUs.size());
+    m_apcLeafCUs.push_back(pcCU);
+    foreach(ComPU* pcPU, pcCU->getPUs())
+    {
+        xFill(pcPU->getX(), pcPU->getY(), pcPU->getWidth(), pcPU->getHeight(), &ComGridBlock::iPU, m_apcPUs.size());
+        m_apcPUs.push_back(pcPU);
+    }
+    /// TU tree is not read when its category is not decoded
+    if( pcCU->getTURoot().getSize() > 0 )
+        xAddTU(&pcCU->getTURoot());
+}
+
+void ComBlockGrid::xAddTU(ComTU* pcTU)
+{
+    if( !pcTU->getTUs().empty() )
+    {
+        foreach(ComTU* pcSubTU, pcTU->getTUs())
+            xAddTU(pcSubTU);
+        return;
+    }
+    xFill(pcTU->getX(), pcTU->getY(), pcTU->getSize(), pcTU->getSize(), &ComGridBlock::iTU, m_apcLeafTUs.size());
+    m_apcLeafTUs.push_back(pcTU);
+}
+
+void ComBlockGrid::xFill(int iX, int iY, int iWidth, int iHeight, int ComGridBlock::*piField, int iIndex)
+{
+    /// clip to the frame, LCUs on the right and bottom border may stick out
+    int iStartX = qMax(iX, 0)/GRID_BLOCK_SIZE;
+    int iStartY = qMax(iY, 0)/GRID_BLOCK_SIZE;
+    int iEndX = qMin((iX+iWidth+GRID_BLOCK_SIZE-1)/GRID_BLOCK_SIZE, m_iWidth);
+    int iEndY = qMin((iY+iHeight+GRID_BLOCK_SIZE-1)/GRID_BLOCK_SIZE, m_iHeight);
+    for(int iBlockY = iStartY; iBlockY < iEndY; iBlockY++)
+    {
+        ComGridBlock* pcRow = m_acBlocks.data() + iBlockY*m_iWidth;
+        for(int iBlockX = iStartX; iBlockX < iEndX; iBlockX++)
+            pcRow[iBlockX].*piField = iIndex;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef COMBLOCKGRID_H
+#define COMBLOCKGRID_H
+
+#include "comcu.h"
+#include <QVector>
+
+#define GRID_BLOCK_SIZE 4       ///< minimum PU size
+
+class ComFrame;
+
+/// leaf CU, PU and TU covering one 4x4 block, indices into the tables of ComBlockGrid (-1 for none)
+struct ComGridBlock
+{
+    int iCU;
+    int iPU;
+    int iTU;
+};
+
+/*!
+ * \brief The ComBlockGrid class
+ * spatial index of one frame at minimum PU granularity, built on first use (see ComFrame::getBlockGrid()).
+ * Hit tests and neighbour lookups are one array access, the leaf tables can be scanned linearly.
+ * Blocks are stored in raster order
+ */
+
+class ComBlockGrid
+{
+public:
+    ComBlockGrid();
+
+    /// index the leaf CUs, PUs and TUs of the LCUs of pcFrame
+    void build(ComFrame* pcFrame);
+    void clear();
+    /// number of LCUs the grid was built from, -1 if not built
+    int getLCUNum() const { return m_iLCUNum; }
+
+    /// leaf CU/PU/TU covering pixel (iX, iY), NULL outside the frame or if not decoded
+    ComCU* getCU(int iX, int iY) const;
+    ComPU* getPU(int iX, int iY) const;
+    ComTU* getTU(int iX, int iY) const;
+
+    /// frame size in blocks
+    int getWidth() const { return m_iWidth; }
+    int getHeight() const { return m_iHeight; }
+    const ComGridBlock& getBlock(int iBlockX, int iBlockY) const { return m_acBlocks.at(iBlockY*m_iWidth+iBlockX); }
+
+    /// leaf nodes in decoding (z-scan) order
+    const QVector<ComCU*>& getLeafCUs() const { return m_apcLeafCUs; }
+    const QVector<ComPU*>& getPUs() const { return m_apcPUs; }
+    const QVector<ComTU*>& getLeafTUs() const { return m_apcLeafTUs; }
+
+    /// heap size in bytes
+    qint64 getMemory() const;
+
+protected:
+    const ComGridBlock* xGetBlock(int iX, int iY) const;
+    void xAddCU(ComCU* pcCU);
+    void xAddTU(ComTU* pcTU);
+    /// write iIndex into the iField member of the blocks of a pixel rectangle
+    void xFill(int iX, int iY, int iWidth, int iHeight, int ComGridBlock::*piField, int iIndex);
+
+    QVector<ComGridBlock> m_acBlocks;
+    QVector<ComCU*> m_apcLeafCUs;
+    QVector<ComPU*> m_apcPUs;
+    QVector<ComTU*> m_apcLeafTUs;
+    int m_iWidth;
+    int m_iHeight;
+    int m_iLCUNum;
+};
+
+#endif // COMBLOCKGRID_H
@@ -9,21 +9,12 @@ ComCU::ComCU(ComFrame *pcParent)
     m_iX = -1;
     m_iY = -1;
     m_iSize = -1;
-}
-
-ComCU::~ComCU()
-{
-    while( !m_apcSCUs.empty() )
-    {
-        delete m_apcSCUs.back();
-        m_apcSCUs.pop_back();
-    }
-
-    while( !m_apcPUs.empty() )
-    {
-        delete m_apcPUs.back();
-        m_apcPUs.pop_back();
-    }
+    m_iBitCount = 0;
+    m_ePartSize = SIZE_NONE;
+    m_pcSCUs = NULL;
+    m_pcPUs = NULL;
+    m_iSCUNum = 0;
+    m_iPUNum = 0;
 }
 
 int ComCU::getPUNum( PartSize ePartSize )
@@ -4,6 +4,7 @@
 #include "compu.h"
 #include "commv.h"
 #include "comtu.h"
+#include "comnodelist.h"
 
 class ComFrame;
 
@@ -24,11 +25,14 @@ enum PartSize
 
 
 
+/*!
+ * CU nodes live in the arena of their frame (see ComArena),
+ * sub-CUs and PUs are runs of nodes there and are freed with the frame, not by ~ComCU
+ */
 class ComCU
 {
 public:
     explicit ComCU(ComFrame* pcParent);
-    ~ComCU();
 
     bool operator < (const ComCU& cOther) const
     {
@@ -37,13 +41,16 @@ public:
     /*!
      * Sub-CUs (four at most)
      */
-    ADD_CLASS_FIELD(QVector<ComCU*>, apcSCUs, getSCUs, setSCUs)
+    ComNodeList<ComCU> getSCUs() const { return ComNodeList<ComCU>(m_pcSCUs, m_iSCUNum); }
+    void setSCUs(ComCU* pcFirst, int iNum) { m_pcSCUs = pcFirst; m_iSCUNum = iNum; }
 
     /*!
      * PUs & TUs in this CU (only for leaf-CUs)
      */
     ADD_CLASS_FIELD(PartSize, ePartSize, getPartSize, setPartSize)
-    ADD_CLASS_FIELD(QVector<ComPU*>, apcPUs, getPUs, setPUs)
+public:
+    ComNodeList<ComPU> getPUs() const { return ComNodeList<ComPU>(m_pcPUs, m_iPUNum); }
+    void setPUs(ComPU* pcFirst, int iNum) { m_pcPUs = pcFirst; m_iPUNum = iNum; }
     ADD_CLASS_FIELD_NOSETTER(ComTU, cTURoot, getTURoot)
 
 
@@ -73,6 +80,11 @@ public:
                                     int&       riWidth,
                                     int&       riHeight );
 
+protected:
+    ComCU* m_pcSCUs;        ///< first sub-CU in the arena
+    ComPU* m_pcPUs;         ///< first PU in the arena
+    int m_iSCUNum;
+    int m_iPUNum;
 
 
 };
@@ -1,10 +1,17 @@
 #include "comframe.h"
+#include "comsequence.h"
+#include <QDebug>
 
 ComFrame::ComFrame(ComSequence* pcParent)
 {
     m_pcSequence = pcParent;
     m_iFrameCount = -1;
+    m_iNalType = -1;
+    m_iTemporalId = -1;
+    m_chSliceType = '?';
+    m_iQP = -1;
     m_iBitCount = 0;
+    m_bLCUsLoaded = false;
     m_dPSNR = -1;
     m_dBitrate = -1;
     m_dTotalEncTime = -1;
@@ -13,15 +20,53 @@ ComFrame::ComFrame(ComSequence* pcParent)
 
 ComFrame::~ComFrame()
 {
-    for( int i = 0; i < m_cLCUs.size(); i++ )
+    foreach(ComTile* pcTile, m_acTiles)
     {
-        delete m_cLCUs.at(i);
+        delete pcTile;
     }
+}
 
-    foreach(ComTile* pcTile, m_acTiles)
+QVector<ComCU*>& ComFrame::getLCUs()
+{
+    if( !m_bLCUsLoaded )
     {
-        delete pcTile;
+        /// the loader pushes into m_cLCUs through getLCUs() as well
+        m_bLCUsLoaded = true;
+        ComLCULoader* pcLoader = m_pcSequence ? m_pcSequence->getLCULoader() : NULL;
+        if( pcLoader != NULL && !pcLoader->loadLCUs(this) )
+            qWarning() << "Failed to load the LCUs of POC" << m_iPOC;
     }
+    return m_cLCUs;
+}
+
+void ComFrame::releaseLCUs()
+{
+    if( m_pcSequence == NULL || m_pcSequence->getLCULoader() == NULL )
+        return;
+    m_cLCUs.clear();
+    m_cBlockGrid.clear();
+    m_cArena.clear();
+    m_bLCUsLoaded = false;
+}
+
+qint64 ComFrame::getLCUMemory() const
+{
+    return m_cLCUs.capacity() * sizeof(ComCU*) + m_cArena.getMemory() + m_cBlockGrid.getMemory();
+}
+
+void ComFrame::getLCUMemory(qint64& riCU, qint64& riPU, qint64& riTU, qint64& riGrid) const
+{
+    riCU = m_cLCUs.capacity() * sizeof(ComCU*) + m_cArena.getCUMemory();
+    riPU = m_cArena.getPUMemory();
+    riTU = m_cArena.getTUMemory();
+    riGrid = m_cBlockGrid.getMemory();
+}
+
+ComBlockGrid& ComFrame::getBlockGrid()
+{
+    if( m_cBlockGrid.getLCUNum() != getLCUs().size() )
+        m_cBlockGrid.build(this);
+    return m_cBlockGrid;
 }
 
 
@@ -1,7 +1,9 @@
 #ifndef COMFRAME_H
 #define COMFRAME_H
 
-#include "comcu.h"
+#include "comarena.h"
+#include "comblockgrid.h"
+#include "comstatistics.h"
 #include "comtile.h"
 class ComSequence;
 
@@ -17,8 +19,23 @@ public:
     }
 
     /*! CUs in one frame
+      * loaded on first access if the sequence has an LCU loader
       */
-    ADD_CLASS_FIELD(QVector<ComCU*>, cLCUs, getLCUs, setLCUs)
+    QVector<ComCU*>& getLCUs();
+    void setLCUs(const QVector<ComCU*>& rcLCUs) { m_cLCUs = rcLCUs; m_bLCUsLoaded = true; }
+    bool isLCUsLoaded() const { return m_bLCUsLoaded; }
+    /// the LCUs in memory now, never loads them (empty if released)
+    const QVector<ComCU*>& getLoadedLCUs() const { return m_cLCUs; }
+    /// free the CU trees, they are loaded again on the next access (sequences with an LCU loader only)
+    void releaseLCUs();
+    /// heap size of the CU/PU/TU/MV trees in bytes (0 if not loaded)
+    qint64 getLCUMemory() const;
+    /// the same split by node type (CU nodes include the LCU table), nothing is loaded or built
+    void getLCUMemory(qint64& riCU, qint64& riPU, qint64& riTU, qint64& riGrid) const;
+    /// storage of all CU/PU/TU nodes of this frame
+    ComArena& getArena() { return m_cArena; }
+    /// 4x4 block index of the leaf CUs/PUs/TUs, (re)built on access when LCUs were added
+    ComBlockGrid& getBlockGrid();
 
     /*! Frame info
       */
@@ -26,6 +43,12 @@ public:
     ADD_CLASS_FIELD(int, iPOC, getPOC, setPOC)
     ADD_CLASS_FIELD(int, iFrameCount, getFrameCount, setFrameCount)
 
+    /*! Slice header info (of the first slice), -1 / '?' if unknown */
+    ADD_CLASS_FIELD(int, iNalType, getNalType, setNalType)              ///< see NalUnitType
+    ADD_CLASS_FIELD(int, iTemporalId, getTemporalId, setTemporalId)
+    ADD_CLASS_FIELD(char, chSliceType, getSliceType, setSliceType)      ///< 'I', 'P' or 'B'
+    ADD_CLASS_FIELD(int, iQP, getQP, setQP)
+
 
     /*! Tile info */
     ADD_CLASS_FIELD_NOSETTER(QVector<ComTile*>, acTiles, getTiles)
@@ -42,12 +65,20 @@ public:
     /*! Bit comsumed */
     ADD_CLASS_FIELD(int, iBitCount, getBitCount, setBitCount)
 
+    /*! Summary of bits and CU trees, see ComStatistics */
+    ADD_CLASS_FIELD_NOSETTER(ComFrameStatistics, cStatistics, getStatistics)
+
     /*! Obsolescent
      */
     ADD_CLASS_FIELD(double, dPSNR, getPSNR, setPSNR)
     ADD_CLASS_FIELD(double, dBitrate, getBitrate, setBitrate)
     ADD_CLASS_FIELD(double, dTotalEncTime, getTotalEncTime, setTotalEncTime)
 
+protected:
+    ComArena m_cArena;
+    ComBlockGrid m_cBlockGrid;
+    QVector<ComCU*> m_cLCUs;
+    bool m_bLCUsLoaded;
 
 
 };
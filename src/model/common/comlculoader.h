@@ -0,0 +1,21 @@
+#ifndef COMLCULOADER_H
+#define COMLCULOADER_H
+
+class ComFrame;
+
+/*!
+ * \brief The ComLCULoader class
+ * builds the CU trees of one frame on demand (see ComFrame::getLCUs()),
+ * a sequence with a loader keeps only the trees of the frames that are visited
+ */
+
+class ComLCULoader
+{
+public:
+    virtual ~ComLCULoader() {}
+
+    /// push the LCUs of pcFrame into pcFrame->getLCUs(), in ascending address order
+    virtual bool loadLCUs(ComFrame* pcFrame) = 0;
+};
+
+#endif // COMLCULOADER_H
@@ -46,4 +46,34 @@ public:
 
 };
 
+
+#define MAX_MV_NUM 2    ///< bi-prediction
+
+/*!
+ * \brief The ComMVList class
+ * the (at most two) MVs of one PU, stored inline in read order:
+ * the L0 MV first, then the L1 MV (see ComPU::getMV() for the slot of a list)
+ */
+class ComMVList
+{
+public:
+    ComMVList(): m_iSize(0) {}
+
+    ComMV* at(int i) { Q_ASSERT(i >= 0 && i < m_iSize); return &m_acMVs[i]; }
+    const ComMV* at(int i) const { Q_ASSERT(i >= 0 && i < m_iSize); return &m_acMVs[i]; }
+    ComMV* operator [] (int i) { return at(i); }
+    const ComMV* operator [] (int i) const { return at(i); }
+    int size() const { return m_iSize; }
+    int count() const { return m_iSize; }
+    bool empty() const { return m_iSize == 0; }
+    bool isEmpty() const { return m_iSize == 0; }
+
+    void push_back(const ComMV& rcMV) { Q_ASSERT(m_iSize < MAX_MV_NUM); m_acMVs[m_iSize++] = rcMV; }
+    void clear() { m_iSize = 0; }
+
+private:
+    ComMV m_acMVs[MAX_MV_NUM];
+    int m_iSize;
+};
+
 #endif // COMMV_H
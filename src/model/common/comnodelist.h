@@ -0,0 +1,52 @@
+#ifndef COMNODELIST_H
+#define COMNODELIST_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief The ComNodeList class
+ * read-only view of sibling nodes (sub-CUs, PUs or sub-TUs) that lie side by side
+ * in the arena of their frame (see ComArena), it has the reading part of the
+ * QVector<T*> interface the trees were built with, so at(), size(), foreach etc. still work
+ */
+
+template <typename T>
+class ComNodeList
+{
+public:
+    class const_iterator
+    {
+    public:
+        explicit const_iterator(T* pcNode = NULL) : m_pcNode(pcNode) {}
+        T* operator * () const { return m_pcNode; }
+        const_iterator& operator ++ () { ++m_pcNode; return *this; }
+        const_iterator operator ++ (int) { const_iterator cOld = *this; ++m_pcNode; return cOld; }
+        bool operator == (const const_iterator& rcOther) const { return m_pcNode == rcOther.m_pcNode; }
+        bool operator != (const const_iterator& rcOther) const { return m_pcNode != rcOther.m_pcNode; }
+    private:
+        T* m_pcNode;
+    };
+    typedef const_iterator iterator;
+
+    ComNodeList(T* pcFirst = NULL, int iSize = 0) : m_pcFirst(pcFirst), m_iSize(iSize) {}
+
+    T* at(int i) const { Q_ASSERT(i >= 0 && i < m_iSize); return m_pcFirst + i; }
+    T* operator [] (int i) const { return at(i); }
+    T* first() const { return at(0); }
+    T* last() const { return at(m_iSize-1); }
+    int size() const { return m_iSize; }
+    int count() const { return m_iSize; }
+    bool empty() const { return m_iSize == 0; }
+    bool isEmpty() const { return m_iSize == 0; }
+
+    const_iterator begin() const { return const_iterator(m_pcFirst); }
+    const_iterator end() const { return const_iterator(m_pcFirst + m_iSize); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+private:
+    T* m_pcFirst;
+    int m_iSize;
+};
+
+#endif // COMNODELIST_H
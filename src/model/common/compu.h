@@ -31,13 +31,13 @@ public:
         m_iIntraDirChroma = -1;
     }
 
-    ~ComPU()
+    /// MV of reference list iList (0 or 1), NULL if the list is not used
+    ComMV* getMV(int iList)
     {
-        while(!m_apcMVs.empty())
-        {
-            delete m_apcMVs.back();
-            m_apcMVs.pop_back();
-        }
+        if( m_iInterDir < 1 || m_iInterDir > 3 || (m_iInterDir & (1 << iList)) == 0 )
+            return NULL;
+        int iSlot = (iList == 1 && m_iInterDir == 3) ? 1 : 0;
+        return iSlot < m_cMVs.size() ? m_cMVs.at(iSlot) : NULL;
     }
 
 private:
@@ -51,7 +51,7 @@ private:
     ADD_CLASS_FIELD( int, iInterDir, getInterDir, setInterDir)
     ADD_CLASS_FIELD( int, iIntraDirLuma, getIntraDirLuma, setIntraDirLuma)
     ADD_CLASS_FIELD( int, iIntraDirChroma, getIntraDirChroma, setIntraDirChroma)
-    ADD_CLASS_FIELD( QVector<ComMV*>, apcMVs, getMVs, setMVs)
+    ADD_CLASS_FIELD( ComMVList, cMVs, getMVs, setMVs)
 
 
 };
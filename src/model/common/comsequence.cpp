@@ -3,26 +3,36 @@
 
 ComSequence::ComSequence()
 {
+    m_pcLCULoader = NULL;
     init();
 }
 
 ComSequence::~ComSequence()
 {
-    for( int i = 0; i < m_cFramesInDisOrder.size(); i++ )
+    /// decoding order holds every frame (a streamed sequence may not display all of them yet)
+    for( int i = 0; i < m_cFramesInDecOrder.size(); i++ )
     {
-        delete m_cFramesInDisOrder.at(i);
+        delete m_cFramesInDecOrder.at(i);
     }
+    delete m_pcLCULoader;
 }
 
 void ComSequence::init()
 {
     /*! Frames in this sequence */
-    for( int i = 0; i < m_cFramesInDisOrder.size(); i++ )
+    for( int i = 0; i < m_cFramesInDecOrder.size(); i++ )
     {
-        delete m_cFramesInDisOrder.at(i);
+        delete m_cFramesInDecOrder.at(i);
     }
     m_cFramesInDisOrder.clear();
     m_cFramesInDecOrder.clear();
+    delete m_pcLCULoader;
+    m_pcLCULoader = NULL;
+    m_bPreScan = false;
+    m_bFollowing = false;
+    m_iDiskBytes = -1;
+    m_cStatistics = ComSequenceStatistics();
+    m_bStatisticsDirty = true;
 
     /*! Sequence general info */
     m_strFileName.clear();
@@ -50,3 +60,20 @@ void ComSequence::init()
     m_dSameCUModePercent = -1;
     m_dMeanCUDepthError = -1;
 }
+
+const ComSequenceStatistics& ComSequence::getStatistics()
+{
+    if( m_bStatisticsDirty || m_cStatistics.iFrames != m_cFramesInDisOrder.size() )
+        ComStatistics::update(this);
+    return m_cStatistics;
+}
+
+int ComSequence::findDecOrder(int iPoc, int iFromDecOrder) const
+{
+    for( int i = qMax(iFromDecOrder, 0); i < m_cFramesInDecOrder.size(); i++ )
+    {
+        if( m_cFramesInDecOrder.at(i)->getPOC() == iPoc )
+            return i;
+    }
+    return -1;
+}
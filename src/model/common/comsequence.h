@@ -3,6 +3,7 @@
 #include <QString>
 #include <QMetaType>
 #include "comframe.h"
+#include "comlculoader.h"
 
 enum YUVRole
 {
@@ -33,6 +34,15 @@ public:
     ADD_CLASS_FIELD(QVector<ComFrame*>, cFramesInDecOrder, getFramesInDecOrder, setFramesInDecOrder)    /// frames in decoding order      0 4 2 1 3 ...
 
 
+    /*!
+     * \brief findDecOrder first frame with this POC at or after decoding order iFromDecOrder
+     * (the decoder may have written the analysis of a POC window only, so the frames
+     * of the analysis files are not always consecutive in decoding order)
+     * \return its decoding order, -1 if there is none
+     */
+    int findDecOrder(int iPoc, int iFromDecOrder) const;
+
+
     /*! Sequence Parameter Set */
     ADD_CLASS_FIELD( QString, strFileName, getFileName, setFileName )     /// filename
     ADD_CLASS_FIELD( int, iWidth, getWidth, setWidth )                    /// width
@@ -47,10 +57,29 @@ public:
 
     /*! Decoded File Location */
     ADD_CLASS_FIELD( QString, strDeocdingFolder, getDecodingFolder, setDecodingFolder)
+    /*! Bytes of the files in the decoding folder, -1 if not measured (see MemoryFootprint::measureDisk) */
+    ADD_CLASS_FIELD( qint64, iDiskBytes, getDiskBytes, setDiskBytes)
+
+    /*! Builds the CU trees of a frame on first access (owned), NULL if all the trees are parsed at open time */
+    ADD_CLASS_FIELD( ComLCULoader*, pcLCULoader, getLCULoader, setLCULoader)
+
+    /*! Pre-scanned: frames from the slice headers only, no LCU and no picture (decode a frame range to see them) */
+    ADD_CLASS_FIELD( bool, bPreScan, getPreScan, setPreScan)
+
+    /*! Live: the bitstream file is still growing and its new frames are appended (cleared to stop following) */
+    ADD_CLASS_FIELD( bool, bFollowing, getFollowing, setFollowing)
 
     /*! Currently Displaying YUV (Predicted, Residual or Reconstructed)*/
     ADD_CLASS_FIELD( YUVRole, eYUVRole, getYUVRole, setYUVRole)
 
+    /*!
+     * Summary of the frame statistics, updated (see ComStatistics::update) when frames were added
+     * or the statistics were invalidated, e.g. while the sequence is streamed
+     */
+    const ComSequenceStatistics& getStatistics();
+    void setStatistics(const ComSequenceStatistics& rcStatistics) { m_cStatistics = rcStatistics; m_bStatisticsDirty = false; }
+    void invalidateStatistics() { m_bStatisticsDirty = true; }
+
 
     /*!
      * Optional info
@@ -64,6 +93,9 @@ public:
     ADD_CLASS_FIELD(double, dSameCUModePercent, getSameCUModePercent, setSameCUModePercent)
     ADD_CLASS_FIELD(double, dMeanCUDepthError, getMeanCUDepthError, setMeanCUDepthError)
 
+protected:
+    ComSequenceStatistics m_cStatistics;
+    bool m_bStatisticsDirty;
 
 };
 
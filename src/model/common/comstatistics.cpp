@@ -0,0 +1,232 @@
+#include "comstatistics.h"
+#include "comsequence.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QThread>
+
+#define STAT_MIN_PARALLEL_FRAMES 16     ///< fewer stale frames are computed on the calling thread
+
+/// summary of a slice of the stale frames
+class FrameStatisticsTask : public QRunnable
+{
+public:
+    FrameStatisticsTask(const QVector<ComFrame*>& rapcFrames, int iFirst, int iEnd) :
+        m_rapcFrames(rapcFrames), m_iFirst(iFirst), m_iEnd(iEnd)
+    {
+        setAutoDelete(true);
+    }
+    void run()
+    {
+        for(int i = m_iFirst; i < m_iEnd; i++)
+            ComStatistics::computeFrame(m_rapcFrames.at(i));
+    }
+private:
+    const QVector<ComFrame*>& m_rapcFrames;
+    int m_iFirst;
+    int m_iEnd;
+};
+
+
+ComTreeStatistics::ComTreeStatistics()
+{
+    for(int i = 0; i < STAT_MAX_CU_DEPTH; i++)
+        aiCUDepth[i] = 0;
+    iIntraArea = 0;
+    iInterArea = 0;
+    iSkipArea = 0;
+    iInterPUs = 0;
+    iMergePUs = 0;
+    iMVNum = 0;
+    dMVLengthSum = 0;
+    dMaxMVLength = 0;
+}
+
+void ComTreeStatistics::add(const ComTreeStatistics& rcOther)
+{
+    for(int i = 0; i < STAT_MAX_CU_DEPTH; i++)
+        aiCUDepth[i] += rcOther.aiCUDepth[i];
+    iIntraArea += rcOther.iIntraArea;
+    iInterArea += rcOther.iInterArea;
+    iSkipArea += rcOther.iSkipArea;
+    iInterPUs += rcOther.iInterPUs;
+    iMergePUs += rcOther.iMergePUs;
+    iMVNum += rcOther.iMVNum;
+    dMVLengthSum += rcOther.dMVLengthSum;
+    dMaxMVLength = qMax(dMaxMVLength, rcOther.dMaxMVLength);
+}
+
+double ComTreeStatistics::getIntraShare() const
+{
+    qint64 iArea = iIntraArea + iInterArea + iSkipArea;
+    return iArea ? double(iIntraArea)/iArea : 0;
+}
+
+double ComTreeStatistics::getInterShare() const
+{
+    qint64 iArea = iIntraArea + iInterArea + iSkipArea;
+    return iArea ? double(iInterArea)/iArea : 0;
+}
+
+double ComTreeStatistics::getSkipShare() const
+{
+    qint64 iArea = iIntraArea + iInterArea + iSkipArea;
+    return iArea ? double(iSkipArea)/iArea : 0;
+}
+
+double ComTreeStatistics::getMergeRatio() const
+{
+    return iInterPUs ? double(iMergePUs)/iInterPUs : 0;
+}
+
+double ComTreeStatistics::getMeanMVLength() const
+{
+    return iMVNum ? dMVLengthSum/iMVNum : 0;
+}
+
+ComFrameStatistics::ComFrameStatistics()
+{
+    iLCUNum = -1;
+    iBits = 0;
+    bTrees = false;
+}
+
+ComSequenceStatistics::ComSequenceStatistics()
+{
+    iFrames = 0;
+    iTreeFrames = 0;
+    iTotalBits = 0;
+    iMaxFrameBits = 0;
+    dAvgFrameBits = 0;
+    dAvgLCUBits = 0;
+}
+
+
+void ComStatistics::computeFrame(ComFrame* pcFrame)
+{
+    ComFrameStatistics& rcStatistics = pcFrame->getStatistics();
+    rcStatistics.iBits = pcFrame->getBitCount();
+
+    /// trees released (or not loaded yet) : keep the last tree summary
+    const QVector<ComCU*>& rapcLCUs = pcFrame->getLoadedLCUs();
+    if( rapcLCUs.empty() )
+    {
+        if( !rcStatistics.bTrees )
+            rcStatistics.iLCUNum = 0;
+        return;
+    }
+
+    ComTreeStatistics cTrees;
+    foreach(ComCU* pcLCU, rapcLCUs)
+        xAddCU(pcLCU, cTrees);
+    static_cast<ComTreeStatistics&>(rcStatistics) = cTrees;
+    rcStatistics.iLCUNum = rapcLCUs.size();
+    rcStatistics.bTrees = true;
+}
+
+void ComStatistics::update(ComSequence* pcSequence, int iThreadNum)
+{
+    const QVector<ComFrame*>& rapcFrames = pcSequence->getFramesInDisOrder();
+    QVector<ComFrame*> apcStale;
+    foreach(ComFrame* pcFrame, rapcFrames)
+    {
+        if( xIsStale(pcFrame) )
+            apcStale.push_back(pcFrame);
+    }
+
+    if( apcStale.size() < STAT_MIN_PARALLEL_FRAMES )
+    {
+        foreach(ComFrame* pcFrame, apcStale)
+            computeFrame(pcFrame);
+    }
+    else
+    {
+        QThreadPool cPool;
+        cPool.setMaxThreadCount( iThreadNum > 0 ? iThreadNum : QThread::idealThreadCount() );
+        int iTaskNum = cPool.maxThreadCount();
+        for(int i = 0; i < iTaskNum; i++)
+        {
+            int iFirst = apcStale.size()*i/iTaskNum;
+            int iEnd = apcStale.size()*(i+1)/iTaskNum;
+            cPool.start(new FrameStatisticsTask(apcStale, iFirst, iEnd));
+        }
+        cPool.waitForDone();
+    }
+
+    /// sum up
+    ComSequenceStatistics cSequence;
+    foreach(ComFrame* pcFrame, rapcFrames)
+    {
+        const ComFrameStatistics& rcFrame = pcFrame->getStatistics();
+        cSequence.iFrames++;
+        cSequence.iTotalBits += rcFrame.iBits;
+        cSequence.iMaxFrameBits = qMax(cSequence.iMaxFrameBits, rcFrame.iBits);
+        if( rcFrame.bTrees )
+        {
+            cSequence.add(rcFrame);
+            cSequence.iTreeFrames++;
+        }
+    }
+    if( cSequence.iFrames > 0 )
+    {
+        cSequence.dAvgFrameBits = double(cSequence.iTotalBits)/cSequence.iFrames;
+        int iMaxCUSize = pcSequence->getMaxCUSize();
+        if( iMaxCUSize > 0 )
+        {
+            int iLCUNum = ((pcSequence->getWidth()+iMaxCUSize-1)/iMaxCUSize) * ((pcSequence->getHeight()+iMaxCUSize-1)/iMaxCUSize);
+            cSequence.dAvgLCUBits = cSequence.dAvgFrameBits/iLCUNum;
+        }
+    }
+    pcSequence->setStatistics(cSequence);
+}
+
+bool ComStatistics::xIsStale(ComFrame* pcFrame)
+{
+    const ComFrameStatistics& rcStatistics = pcFrame->getStatistics();
+    int iLoadedLCUs = pcFrame->getLoadedLCUs().size();
+    return rcStatistics.iLCUNum < 0 ||
+           rcStatistics.iBits != pcFrame->getBitCount() ||
+           (iLoadedLCUs > 0 && iLoadedLCUs != rcStatistics.iLCUNum);
+}
+
+void ComStatistics::xAddCU(ComCU* pcCU, ComTreeStatistics& rcStatistics)
+{
+    if( !pcCU->getSCUs().empty() )
+    {
+        foreach(ComCU* pcSCU, pcCU->getSCUs())
+            xAddCU(pcSCU, rcStatistics);
+        return;
+    }
+
+    /// leaf CU
+    int iDepth = qBound(0, pcCU->getDepth(), STAT_MAX_CU_DEPTH-1);
+    rcStatistics.aiCUDepth[iDepth]++;
+    foreach(ComPU* pcPU, pcCU->getPUs())
+    {
+        qint64 iArea = qint64(pcPU->getWidth())*pcPU->getHeight();
+        switch( pcPU->getPredMode() )
+        {
+        case MODE_INTRA:
+            rcStatistics.iIntraArea += iArea;
+            continue;
+        case MODE_INTER:
+            rcStatistics.iInterArea += iArea;
+            break;
+        case MODE_SKIP:
+            rcStatistics.iSkipArea += iArea;
+            break;
+        default:
+            continue;       ///< prediction not decoded
+        }
+
+        rcStatistics.iInterPUs++;
+        if( pcPU->getMergeIndex() >= 0 )
+            rcStatistics.iMergePUs++;
+        for(int i = 0; i < pcPU->getMVs().size(); i++)
+        {
+            double dLength = pcPU->getMVs().at(i)->getLength();
+            rcStatistics.iMVNum++;
+            rcStatistics.dMVLengthSum += dLength;
+            rcStatistics.dMaxMVLength = qMax(rcStatistics.dMaxMVLength, dLength);
+        }
+    }
+}
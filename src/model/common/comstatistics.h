@@ -0,0 +1,81 @@
+#ifndef COMSTATISTICS_H
+#define COMSTATISTICS_H
+
+#include <QtGlobal>
+
+#define STAT_MAX_CU_DEPTH 8
+
+class ComFrame;
+class ComSequence;
+class ComCU;
+
+/*!
+ * \brief The ComTreeStatistics struct
+ * CU, prediction and motion summary of a set of CU trees
+ */
+struct ComTreeStatistics
+{
+    ComTreeStatistics();
+    void add(const ComTreeStatistics& rcOther);
+
+    /// share of the PU area in [0,1]
+    double getIntraShare() const;
+    double getInterShare() const;
+    double getSkipShare() const;
+    /// merged PUs / inter and skip PUs
+    double getMergeRatio() const;
+    /// in quarter pels
+    double getMeanMVLength() const;
+
+    int aiCUDepth[STAT_MAX_CU_DEPTH];       ///< leaf CUs per depth
+    qint64 iIntraArea;                      ///< pixels of intra PUs
+    qint64 iInterArea;
+    qint64 iSkipArea;
+    int iInterPUs;                          ///< inter and skip PUs
+    int iMergePUs;
+    int iMVNum;
+    double dMVLengthSum;                    ///< quarter pels
+    double dMaxMVLength;
+};
+
+/// summary of one frame, kept after its CU trees are released
+struct ComFrameStatistics : public ComTreeStatistics
+{
+    ComFrameStatistics();
+
+    int iLCUNum;        ///< LCUs the trees were summed from, -1 if never computed
+    int iBits;          ///< frame bits when computed
+    bool bTrees;        ///< the ComTreeStatistics part is valid (the trees were loaded)
+};
+
+/// summary of a sequence, the tree part covers the frames with bTrees
+struct ComSequenceStatistics : public ComTreeStatistics
+{
+    ComSequenceStatistics();
+
+    int iFrames;
+    int iTreeFrames;
+    qint64 iTotalBits;
+    int iMaxFrameBits;
+    double dAvgFrameBits;
+    double dAvgLCUBits;
+};
+
+/*!
+ * \brief The ComStatistics class
+ * computes the statistics cached in ComFrame and ComSequence (see ComSequence::getStatistics())
+ */
+class ComStatistics
+{
+public:
+    /// summary of the loaded CU trees of pcFrame, nothing is loaded
+    static void computeFrame(ComFrame* pcFrame);
+    /// compute the frames that changed since their last summary (in parallel) and sum them up
+    static void update(ComSequence* pcSequence, int iThreadNum = 0);
+
+protected:
+    static bool xIsStale(ComFrame* pcFrame);
+    static void xAddCU(ComCU* pcCU, ComTreeStatistics& rcStatistics);
+};
+
+#endif // COMSTATISTICS_H
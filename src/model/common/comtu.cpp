@@ -2,4 +2,9 @@
 
 ComTU::ComTU()
 {
+    m_iX = -1;
+    m_iY = -1;
+    m_iSize = -1;
+    m_pcTUs = NULL;
+    m_iTUNum = 0;
 }
@@ -1,16 +1,24 @@
 #ifndef COMTU_H
 #define COMTU_H
 #include "gitldef.h"
-#include <QVector>
+#include "comnodelist.h"
+
+/*!
+ * sub-TUs are a run of nodes in the arena of the frame (see ComArena)
+ */
 class ComTU
 {
 public:
     ComTU();
-    ADD_CLASS_FIELD(QVector<ComTU*>, apcTUs, getTUs, setTUs)
+    ComNodeList<ComTU> getTUs() const { return ComNodeList<ComTU>(m_pcTUs, m_iTUNum); }
+    void setTUs(ComTU* pcFirst, int iNum) { m_pcTUs = pcFirst; m_iTUNum = iNum; }
     ADD_CLASS_FIELD(int, iX, getX, setX)                                        ///< X Position in frame
     ADD_CLASS_FIELD(int, iY, getY, setY)                                        ///< Y Position in frame
     ADD_CLASS_FIELD(int, iSize, getSize, setSize)                               ///< CU Size
 
+protected:
+    ComTU* m_pcTUs;         ///< first sub-TU in the arena
+    int m_iTUNum;
 };
 
 #endif // COMTU_H
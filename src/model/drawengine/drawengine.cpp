@@ -1,4 +1,5 @@
 #include "drawengine.h"
+#include "model/modellocator.h"
 #include <QPainter>
 #include <iostream>
 using namespace std;
@@ -65,6 +66,9 @@ QPixmap* DrawEngine::drawFrame( ComSequence* pcSequence, int iPoc, QPixmap *pcPi
     QRect cScaledFrameArea =  m_cDrawnPixmap.rect();
     m_cFilterLoader.drawFrame(&cPainter, pcFrame, m_dScale, &cScaledFrameArea);
 
+    /// frames viewed long ago may be released to stay within the memory budget
+    ModelLocator::getInstance()->getSequenceManager().touchFrame(pcFrame);
+
     return &m_cDrawnPixmap;
 
 }
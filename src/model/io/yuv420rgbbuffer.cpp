@@ -25,6 +25,20 @@ YUV420RGBBuffer::~YUV420RGBBuffer()
 }
 
 
+qint64 YUV420RGBBuffer::getBufferMemory() const
+{
+    if( m_puhYUVBuffer == NULL )
+        return 0;
+    qint64 iPixels = qint64(m_iBufferWidth) * m_iBufferHeight;
+    return (iPixels * 3 / 2) * (m_bIs16Bit ? 2 : 1) + iPixels * 3;
+}
+
+qint64 YUV420RGBBuffer::getPixmapMemory() const
+{
+    return qint64(m_cFramePixmap.width()) * m_cFramePixmap.height() * m_cFramePixmap.depth() / 8;
+}
+
+
 bool YUV420RGBBuffer::openYUVFile( const QString& strYUVPath, int iWidth, int iHeight, bool bIs16Bit)
 {
 
@@ -49,6 +63,13 @@ bool YUV420RGBBuffer::openYUVFile( const QString& strYUVPath, int iWidth, int iH
     m_iBufferHeight = iHeight;
     m_bIs16Bit = bIs16Bit;
 
+    /// no picture at all (pre-scan), getFrame() gives blank frames of this size
+    if( strYUVPath.isEmpty() )
+    {
+        m_cIOYUV.getYUVFile().close();
+        return true;
+    }
+
     /// set YUV file reader
     if( !m_cIOYUV.openYUVFilePath(strYUVPath) )
     {
@@ -65,7 +86,15 @@ QPixmap* YUV420RGBBuffer::getFrame(int iFrameCount)
 {
     QPixmap* pcFramePixmap = NULL;
 
-    if( xReadFrame(iFrameCount) )
+    if( !m_cIOYUV.getYUVFile().isOpen() && iFrameCount >= 0 )
+    {
+        /// the filters still draw on it
+        m_iFrameCount = iFrameCount;
+        m_cFramePixmap = QPixmap(m_iBufferWidth, m_iBufferHeight);
+        m_cFramePixmap.fill(Qt::gray);
+        pcFramePixmap = &m_cFramePixmap;
+    }
+    else if( xReadFrame(iFrameCount) )
     {
         QImage cFrameImg(m_puhRGBBuffer, m_iBufferWidth, m_iBufferHeight, QImage::Format_RGB888 );
         m_cFramePixmap = QPixmap::fromImage(cFrameImg);
@@ -21,6 +21,11 @@ public:
     bool openYUVFile( const QString& strYUVPath, int iWidth, int iHeight, bool bIs16Bit = false );
     QPixmap* getFrame(int iFrameCount);
 
+    /// bytes of the YUV and RGB buffers
+    qint64 getBufferMemory() const;
+    /// bytes of the pixmap of the current frame
+    qint64 getPixmapMemory() const;
+
 
     ADD_CLASS_FIELD(int, iBufferWidth, getBufferWidth, setBufferWidth)
     ADD_CLASS_FIELD(int, iBufferHeight, getBufferHeight, setBufferHeight)
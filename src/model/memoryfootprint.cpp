@@ -0,0 +1,117 @@
+#include "memoryfootprint.h"
+#include "io/yuv420rgbbuffer.h"
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QPixmap>
+
+MemoryFootprint::MemoryFootprint()
+{
+    for(int i = 0; i < MEMORY_CATEGORY_NUM; i++)
+        m_aiBytes[i] = 0;
+    m_iFrames = 0;
+    m_iLoadedFrames = 0;
+}
+
+void MemoryFootprint::addFrame(ComFrame* pcFrame)
+{
+    qint64 iCU, iPU, iTU, iGrid;
+    pcFrame->getLCUMemory(iCU, iPU, iTU, iGrid);
+    m_aiBytes[MEMORY_CU]   += iCU;
+    m_aiBytes[MEMORY_PU]   += iPU;
+    m_aiBytes[MEMORY_TU]   += iTU;
+    m_aiBytes[MEMORY_GRID] += iGrid;
+
+    m_aiBytes[MEMORY_FRAME] += sizeof(ComFrame) +
+            pcFrame->getTiles().capacity()*sizeof(ComTile*) + pcFrame->getTiles().size()*sizeof(ComTile) +
+            (pcFrame->getL0List().capacity() + pcFrame->getL1List().capacity() + pcFrame->getLCList().capacity())*sizeof(int);
+
+    m_iFrames++;
+    if( iCU > 0 )
+        m_iLoadedFrames++;
+}
+
+void MemoryFootprint::addSequence(ComSequence* pcSequence)
+{
+    foreach(ComFrame* pcFrame, pcSequence->getFramesInDisOrder())
+        addFrame(pcFrame);
+    m_aiBytes[MEMORY_FRAME] += sizeof(ComSequence) +
+            (pcSequence->getFramesInDisOrder().capacity() + pcSequence->getFramesInDecOrder().capacity())*sizeof(ComFrame*);
+
+    /// measured when the decoding or the cache loading finished, not on every query
+    m_aiBytes[MEMORY_DISK] += qMax<qint64>(pcSequence->getDiskBytes(), 0);
+}
+
+qint64 MemoryFootprint::measureDisk(const QString& strFolder)
+{
+    qint64 iBytes = 0;
+    if( strFolder.isEmpty() )
+        return 0;
+    QDirIterator cIter(strFolder, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while( cIter.hasNext() )
+    {
+        cIter.next();
+        iBytes += cIter.fileInfo().size();
+    }
+    return iBytes;
+}
+
+void MemoryFootprint::addFrameBuffer(const YUV420RGBBuffer& rcBuffer)
+{
+    m_aiBytes[MEMORY_BUFFER] += rcBuffer.getBufferMemory();
+    m_aiBytes[MEMORY_PIXMAP] += rcBuffer.getPixmapMemory();
+}
+
+void MemoryFootprint::addPixmap(const QPixmap& rcPixmap)
+{
+    m_aiBytes[MEMORY_PIXMAP] += qint64(rcPixmap.width()) * rcPixmap.height() * rcPixmap.depth() / 8;
+}
+
+qint64 MemoryFootprint::getResident() const
+{
+    qint64 iBytes = 0;
+    for(int i = 0; i < MEMORY_CATEGORY_NUM; i++)
+    {
+        if( i != MEMORY_DISK )
+            iBytes += m_aiBytes[i];
+    }
+    return iBytes;
+}
+
+QString MemoryFootprint::toText() const
+{
+    QString strText = QString("RAM %1 (CU trees of %2/%3 frames)")
+                      .arg(formatBytes(getResident())).arg(m_iLoadedFrames).arg(m_iFrames);
+    for(int i = 0; i < MEMORY_CATEGORY_NUM; i++)
+    {
+        strText += QString("\n  %1: %2").arg(getCategoryName((MemoryCategory)i))
+                                        .arg(formatBytes(m_aiBytes[i]));
+    }
+    return strText;
+}
+
+QString MemoryFootprint::getCategoryName(MemoryCategory eCategory)
+{
+    switch( eCategory )
+    {
+    case MEMORY_CU:     return "CUs";
+    case MEMORY_PU:     return "PUs & MVs";
+    case MEMORY_TU:     return "TUs";
+    case MEMORY_GRID:   return "block grids";
+    case MEMORY_FRAME:  return "frame info";
+    case MEMORY_BUFFER: return "YUV/RGB buffers";
+    case MEMORY_PIXMAP: return "pixmaps";
+    case MEMORY_DISK:   return "cache files (disk)";
+    default:            return "?";
+    }
+}
+
+QString MemoryFootprint::formatBytes(qint64 iBytes)
+{
+    if( iBytes >= (qint64(1) << 30) )
+        return QString("%1 GB").arg(iBytes / double(1 << 30), 0, 'f', 2);
+    if( iBytes >= (1 << 20) )
+        return QString("%1 MB").arg(iBytes / double(1 << 20), 0, 'f', 1);
+    if( iBytes >= (1 << 10) )
+        return QString("%1 KB").arg(iBytes / double(1 << 10), 0, 'f', 1);
+    return QString("%1 B").arg(iBytes);
+}
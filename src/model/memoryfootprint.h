@@ -0,0 +1,64 @@
+#ifndef MEMORYFOOTPRINT_H
+#define MEMORYFOOTPRINT_H
+
+#include "common/comsequence.h"
+#include <QString>
+
+class YUV420RGBBuffer;
+class QPixmap;
+
+enum MemoryCategory
+{
+    MEMORY_CU,          ///< CU nodes and LCU tables
+    MEMORY_PU,          ///< PU nodes with their MVs
+    MEMORY_TU,          ///< TU nodes
+    MEMORY_GRID,        ///< 4x4 block grids
+    MEMORY_FRAME,       ///< frame objects, tiles and reference lists
+    MEMORY_BUFFER,      ///< YUV and RGB buffers of the displayed frame
+    MEMORY_PIXMAP,      ///< displayed and drawn pixmaps
+    MEMORY_DISK,        ///< decoder output and cache files, not in RAM
+    MEMORY_CATEGORY_NUM
+};
+
+/*!
+ * \brief The MemoryFootprint class
+ * bytes per category of a frame or a sequence, measured when added (the CU trees
+ * of a sequence with an LCU loader come and go, see SequenceManager::touchFrame())
+ */
+
+class MemoryFootprint
+{
+public:
+    MemoryFootprint();
+
+    /// frame object and its CU/PU/TU trees, nothing is loaded
+    void addFrame(ComFrame* pcFrame);
+    /// all frames, the sequence object and the files of its decoding folder as last measured
+    void addSequence(ComSequence* pcSequence);
+    /// buffers of the displayed frame (they belong to the current sequence)
+    void addFrameBuffer(const YUV420RGBBuffer& rcBuffer);
+    void addPixmap(const QPixmap& rcPixmap);
+
+    qint64 getBytes(MemoryCategory eCategory) const { return m_aiBytes[eCategory]; }
+    /// all categories but MEMORY_DISK
+    qint64 getResident() const;
+    /// frames with CU trees in memory
+    int getLoadedFrames() const { return m_iLoadedFrames; }
+    int getFrames() const { return m_iFrames; }
+
+    /// one line per category
+    QString toText() const;
+
+    /// bytes of the files in strFolder and below, read from the disk (see ComSequence::getDiskBytes)
+    static qint64 measureDisk(const QString& strFolder);
+
+    static QString getCategoryName(MemoryCategory eCategory);
+    static QString formatBytes(qint64 iBytes);
+
+protected:
+    qint64 m_aiBytes[MEMORY_CATEGORY_NUM];
+    int m_iFrames;
+    int m_iLoadedFrames;
+};
+
+#endif // MEMORYFOOTPRINT_H
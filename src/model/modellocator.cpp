@@ -5,10 +5,12 @@ SINGLETON_PATTERN_IMPLIMENT(ModelLocator)
 ModelLocator::ModelLocator()
 {
     setModualName("model");
+    m_cSequenceManager.setMemoryBudget(qint64(m_cPreferences.getMemoryBudget()) << 20);
 }
 
 ModelLocator::~ModelLocator()
 {
+    qDeleteAll(m_apcDecodeJobs);
 }
 
 
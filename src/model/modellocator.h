@@ -12,6 +12,7 @@
 #include "parsers/cupuparser.h"
 #include "exceptions/nosequencefoundexception.h"
 #include "selectionmanager.h"
+#include "parsers/decodejob.h"
 
 /*!
  * \brief The ModelLocator class
@@ -47,6 +48,11 @@ public:
       */
     ADD_CLASS_FIELD_NOSETTER(Preferences, cPreferences, getPreferences)             ///< Setting for cache directory, decoder path, etc.
 
+    /**
+      * Background decoding
+      */
+    ADD_CLASS_FIELD_NOSETTER(QList<DecodeJob*>, apcDecodeJobs, getDecodeJobs)     ///< bitstreams being decoded, not in the sequence manager yet
+
 public:
     /**
       * SINGLETON ( design pattern )
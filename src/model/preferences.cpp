@@ -28,11 +28,43 @@ Preferences::Preferences() :
     }
 
 
+    if(!m_cSettings.contains("shm_transport")) {
+        m_cSettings.setValue("shm_transport", false);
+        m_cSettings.sync();
+    }
+
+    if(!m_cSettings.contains("cache_decoder_output")) {
+        m_cSettings.setValue("cache_decoder_output", false);
+        m_cSettings.sync();
+    }
+
+    if(!m_cSettings.contains("lazy_lcu_loading")) {
+        m_cSettings.setValue("lazy_lcu_loading", true);
+        m_cSettings.sync();
+    }
+
+    if(!m_cSettings.contains("memory_budget_mb")) {
+        m_cSettings.setValue("memory_budget_mb", 4096);
+        m_cSettings.sync();
+    }
+
+    if(!m_cSettings.contains("parallel_decoding")) {
+        m_cSettings.setValue("parallel_decoding", false);
+        m_cSettings.sync();
+    }
+
+
     m_strCacheFolder   = m_cSettings.value("cache_path").toString();
     xCreateIfNotExist(m_strCacheFolder);
 
     m_strThemeName     = m_cSettings.value("theme_name").toString();
 
+    m_bShmTransport       = m_cSettings.value("shm_transport").toBool();
+    m_bCacheDecoderOutput = m_cSettings.value("cache_decoder_output").toBool();
+    m_bLazyLCULoading     = m_cSettings.value("lazy_lcu_loading").toBool();
+    m_iMemoryBudget       = m_cSettings.value("memory_budget_mb").toInt();
+    m_bParallelDecoding   = m_cSettings.value("parallel_decoding").toBool();
+
 }
 
 
@@ -51,6 +83,42 @@ void Preferences::setThemeName(const QString& strThemeName)
 }
 
 
+void Preferences::setShmTransport(bool bShmTransport)
+{
+    m_bShmTransport = bShmTransport;
+    m_cSettings.setValue("shm_transport", bShmTransport);
+    m_cSettings.sync();
+}
+
+void Preferences::setCacheDecoderOutput(bool bCacheDecoderOutput)
+{
+    m_bCacheDecoderOutput = bCacheDecoderOutput;
+    m_cSettings.setValue("cache_decoder_output", bCacheDecoderOutput);
+    m_cSettings.sync();
+}
+
+void Preferences::setLazyLCULoading(bool bLazyLCULoading)
+{
+    m_bLazyLCULoading = bLazyLCULoading;
+    m_cSettings.setValue("lazy_lcu_loading", bLazyLCULoading);
+    m_cSettings.sync();
+}
+
+void Preferences::setMemoryBudget(int iMemoryBudget)
+{
+    m_iMemoryBudget = qMax(iMemoryBudget, 0);
+    m_cSettings.setValue("memory_budget_mb", m_iMemoryBudget);
+    m_cSettings.sync();
+}
+
+void Preferences::setParallelDecoding(bool bParallelDecoding)
+{
+    m_bParallelDecoding = bParallelDecoding;
+    m_cSettings.setValue("parallel_decoding", bParallelDecoding);
+    m_cSettings.sync();
+}
+
+
 void Preferences::xCreateIfNotExist(QString strPath)
 {
     QDir cFolder(strPath);
@@ -20,12 +20,22 @@ public:
 
     void setCacheFolder(const QString& strCacheFolder);
     void setThemeName(const QString& strThemeName);
+    void setShmTransport(bool bShmTransport);
+    void setCacheDecoderOutput(bool bCacheDecoderOutput);
+    void setLazyLCULoading(bool bLazyLCULoading);
+    void setMemoryBudget(int iMemoryBudget);
+    void setParallelDecoding(bool bParallelDecoding);
 
 protected:
     void xCreateIfNotExist(QString strPath);
 
     ADD_CLASS_FIELD_NOSETTER(QString, strCacheFolder, getCacheFolder)       /// for temp decoded sequences
     ADD_CLASS_FIELD_NOSETTER(QString, strThemeName, getThemeName)           /// theme name
+    ADD_CLASS_FIELD_NOSETTER(bool, bShmTransport, getShmTransport)          /// decoder output through shared memory
+    ADD_CLASS_FIELD_NOSETTER(bool, bCacheDecoderOutput, getCacheDecoderOutput)  /// keep the per-LCU txt files when streaming with shared memory
+    ADD_CLASS_FIELD_NOSETTER(bool, bLazyLCULoading, getLazyLCULoading)      /// parse the CU trees of a frame when it is visited
+    ADD_CLASS_FIELD_NOSETTER(int, iMemoryBudget, getMemoryBudget)           /// MB of CU trees kept for all sequences, 0 for no limit
+    ADD_CLASS_FIELD_NOSETTER(bool, bParallelDecoding, getParallelDecoding)  /// decode bitstream segments (cut at IRAPs) at the same time
 
     ADD_CLASS_FIELD_PRIVATE(QSettings, cSettings)    /// for save onto disk
 
@@ -24,64 +24,15 @@ ComCU *SelectionManager::getLCU(ComFrame* pcFrame, const QPointF* pcUnscaledPos)
 
 ComCU *SelectionManager::getSCU(ComFrame* pcFrame, const QPointF* pcUnscaledPos)
 {
-    ComCU* pcLCU = getLCU(pcFrame, pcUnscaledPos);
-    ComCU* pcCurCU = pcLCU;
-    if(pcLCU != NULL)
-    {
-        while(!pcCurCU->getSCUs().empty())
-        {
-            foreach(ComCU* pcSCU, pcCurCU->getSCUs())
-            {
-                QRectF cSCURect(pcSCU->getX(), pcSCU->getY(), pcSCU->getSize(), pcSCU->getSize());
-                if(cSCURect.contains(*pcUnscaledPos))
-                {
-                    pcCurCU = pcSCU;
-                    break;
-                }
-            }
-        }
-        return pcCurCU;
-    }
-    return NULL;
+    return pcFrame->getBlockGrid().getCU(qFloor(pcUnscaledPos->x()), qFloor(pcUnscaledPos->y()));
 }
 
 ComPU *SelectionManager::getPU(ComFrame* pcFrame, const QPointF* pcUnscaledPos)
 {
-    ComCU* pcSCU = getSCU(pcFrame, pcUnscaledPos);
-    if(pcSCU != NULL)
-    {
-        foreach(ComPU* pcPU, pcSCU->getPUs())
-        {
-            QRectF cPURect(pcPU->getX(), pcPU->getY(), pcPU->getWidth(), pcPU->getHeight());
-            if(cPURect.contains(*pcUnscaledPos))
-            {
-                return pcPU;
-            }
-        }
-    }
-    return NULL;
+    return pcFrame->getBlockGrid().getPU(qFloor(pcUnscaledPos->x()), qFloor(pcUnscaledPos->y()));
 }
 
 ComTU *SelectionManager::getTU(ComFrame* pcFrame, const QPointF* pcUnscaledPos)
 {
-    ComCU* pcSCU = getSCU(pcFrame, pcUnscaledPos);
-
-    if(pcSCU != NULL)
-    {
-        ComTU* pcCurTU = &pcSCU->getTURoot();
-        while(!pcCurTU->getTUs().empty())
-        {
-            foreach(ComTU* pcTU, pcCurTU->getTUs())
-            {
-                QRectF cTURect(pcTU->getX(), pcTU->getY(), pcTU->getSize(), pcTU->getSize());
-                if(cTURect.contains(*pcUnscaledPos))
-                {
-                    pcCurTU = pcTU;
-                    break;
-                }
-            }
-        }
-        return pcCurTU;
-    }
-    return NULL;
+    return pcFrame->getBlockGrid().getTU(qFloor(pcUnscaledPos->x()), qFloor(pcUnscaledPos->y()));
 }
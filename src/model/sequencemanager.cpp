@@ -3,6 +3,8 @@
 SequenceManager::SequenceManager()
 {
     m_pcCurrentSequence = NULL;
+    m_iMemoryBudget = 0;
+    m_iLoadedLCUMemory = 0;
 }
 
 SequenceManager::~SequenceManager()
@@ -30,6 +32,9 @@ void SequenceManager::setCurrentSequence(ComSequence *pcSequence)
 void SequenceManager::addSequence(ComSequence *pcSequence)
 {
     m_apSequences.push_back(pcSequence);
+    /// summarize the frames once, while their CU trees are still in memory
+    /// (the frames of a lazily loaded sequence got their summaries from the LCU index)
+    pcSequence->getStatistics();
 }
 
 bool SequenceManager::delSequence(ComSequence *pcSequence)
@@ -39,6 +44,8 @@ bool SequenceManager::delSequence(ComSequence *pcSequence)
         if( m_apSequences[i] == pcSequence)
         {
             m_apSequences.remove(i);
+            foreach(ComFrame* pcFrame, pcSequence->getFramesInDecOrder())
+                xForgetFrame(pcFrame);
             if(pcSequence == m_pcCurrentSequence)
                 m_pcCurrentSequence = NULL;
             delete pcSequence;
@@ -62,3 +69,46 @@ ComSequence* SequenceManager::getSequenceByFilename(const QString &strFilename)
     }
     return NULL;
 }
+
+void SequenceManager::touchFrame(ComFrame* pcFrame)
+{
+    ComSequence* pcSequence = pcFrame->getSequence();
+    if( pcSequence == NULL || pcSequence->getLCULoader() == NULL )
+        return;     ///< can not be loaded again, never released
+
+    xForgetFrame(pcFrame);
+    qint64 iMemory = pcFrame->getLCUMemory();
+    m_apcViewedFrames.push_front(pcFrame);
+    m_cFrameMemory.insert(pcFrame, iMemory);
+    m_iLoadedLCUMemory += iMemory;
+    xEvict();
+}
+
+void SequenceManager::setMemoryBudget(qint64 iMemoryBudget)
+{
+    m_iMemoryBudget = iMemoryBudget;
+    xEvict();
+}
+
+void SequenceManager::xEvict()
+{
+    if( m_iMemoryBudget <= 0 )
+        return;
+    /// the most recently viewed frame stays even if it alone is over budget
+    while( m_iLoadedLCUMemory > m_iMemoryBudget && m_apcViewedFrames.size() > 1 )
+    {
+        ComFrame* pcFrame = m_apcViewedFrames.back();
+        xForgetFrame(pcFrame);
+        pcFrame->releaseLCUs();
+    }
+}
+
+void SequenceManager::xForgetFrame(ComFrame* pcFrame)
+{
+    QHash<ComFrame*, qint64>::iterator cIter = m_cFrameMemory.find(pcFrame);
+    if( cIter == m_cFrameMemory.end() )
+        return;
+    m_iLoadedLCUMemory -= cIter.value();
+    m_cFrameMemory.erase(cIter);
+    m_apcViewedFrames.removeOne(pcFrame);
+}
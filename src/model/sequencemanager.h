@@ -4,10 +4,15 @@
 #include "common/comsequence.h"
 #include "exceptions/nosequencefoundexception.h"
 #include <QVector>
+#include <QList>
+#include <QHash>
 #include <QDebug>
 /*!
  * \brief The SequenceManager class
  * This class contains serveral sequences, in order to support multi-sequence analysis (difference comparasion, etc.)
+ * The CU trees of viewed frames are kept within a memory budget shared by all sequences,
+ * the least recently viewed frames are released first and loaded again when they are viewed
+ * (only sequences with an LCU loader, see ComFrame::releaseLCUs()).
  */
 
 class SequenceManager
@@ -28,7 +33,24 @@ public:
 
     ComSequence* getSequenceByFilename(const QString& strFilename);
 
+    /// pcFrame is being viewed: it becomes the most recently viewed frame, older ones may be released
+    void touchFrame(ComFrame* pcFrame);
+
+    /// 0 for no limit
+    void setMemoryBudget(qint64 iMemoryBudget);
+
+    /// estimated memory of the CU trees of the frames in the LRU list
+    qint64 getLoadedLCUMemory() const { return m_iLoadedLCUMemory; }
+
+protected:
+    void xEvict();
+    void xForgetFrame(ComFrame* pcFrame);
+
     ADD_CLASS_FIELD_PRIVATE(ComSequence*, pcCurrentSequence)
     ADD_CLASS_FIELD_PRIVATE(QVector<ComSequence*>, apSequences)
+    ADD_CLASS_FIELD_PRIVATE(qint64, iMemoryBudget)                      ///< bytes
+    ADD_CLASS_FIELD_PRIVATE(qint64, iLoadedLCUMemory)
+    ADD_CLASS_FIELD_PRIVATE(QList<ComFrame*>, apcViewedFrames)          ///< most recently viewed first
+    ADD_CLASS_FIELD_PRIVATE(QHash<ComFrame*, qint64>, cFrameMemory)     ///< estimate at the time it was viewed
 };
 #endif // SEQUENCEMANAGER_H
@@ -0,0 +1,486 @@
+#include "analysisbinparser.h"
+#include <QtEndian>
+#include <QtAlgorithms>
+#include <QDebug>
+
+#define CU_SLIPT_FLAG 99      ///< CU splitting flag in file
+#define TU_SLIPT_FLAG 99      ///< TU splitting flag in file
+
+/// binary container constants (see TSysuAnalyzerOutput.h)
+#define BIN_MAGIC           "SYSUANA"
+#define BIN_VERSION         1
+#define BIN_TAG_FRAME       0x4D415246    ///< 'FRAM'
+#define BIN_TAG_INDEX       0x58444E49    ///< 'INDX'
+
+/// per-LCU categories, same order as SysuAnalyzerCategory
+enum BinCategory
+{
+    BIN_CAT_PRED = 0,
+    BIN_CAT_CUPU,
+    BIN_CAT_MV,
+    BIN_CAT_MERGE,
+    BIN_CAT_INTRA,
+    BIN_CAT_TU,
+    BIN_CAT_BIT_LCU,
+    BIN_CAT_BIT_SCU,
+    BIN_CAT_ME,
+    BIN_CAT_TILE,
+    BIN_CAT_NUM
+};
+
+/// for CU sorting in Addr ascending order
+static bool xCUSortingOrder(const ComCU* pcCUFirst, const ComCU* pcCUSecond)
+{
+    return (*pcCUFirst < *pcCUSecond);
+}
+
+static quint32 xGetUInt(const char* pcData)
+{
+    return qFromLittleEndian<quint32>((const uchar*)pcData);
+}
+
+AnalysisBinParser::AnalysisBinParser(QObject *parent) :
+    QObject(parent)
+{
+}
+
+
+bool AnalysisBinParser::parseFile(QIODevice* pcInputDevice, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
+
+    /// header
+    QByteArray cHeader = pcInputDevice->read(16);
+    if( cHeader.size() != 16 || qstrcmp(cHeader.constData(), BIN_MAGIC) != 0 )
+    {
+        qCritical() << "AnalysisBinParser Error! Not an analysis container!";
+        return false;
+    }
+    quint32 uiVersion = xGetUInt(cHeader.constData()+8);
+    if( uiVersion > BIN_VERSION )
+    {
+        qCritical() << "AnalysisBinParser Error! Unsupported container version" << uiVersion;
+        return false;
+    }
+
+    /// chunks
+    int iDecOrder = -1;
+    int iLastPOC  = -1;
+    while( !pcInputDevice->atEnd() )
+    {
+        QByteArray cChunkHeader = pcInputDevice->read(8);
+        if( cChunkHeader.size() != 8 )
+            break;
+        quint32 uiTag = xGetUInt(cChunkHeader.constData());
+        quint32 uiLength = xGetUInt(cChunkHeader.constData()+4);
+
+        if( uiTag == BIN_TAG_FRAME )
+        {
+            QByteArray cPayload = pcInputDevice->read(uiLength);
+            if( (quint32)cPayload.size() != uiLength )
+            {
+                qCritical() << "AnalysisBinParser Error! Truncated frame chunk!";
+                return false;
+            }
+            if( xParseFrame(cPayload, pcSequence, iDecOrder, iLastPOC) == false )
+                return false;
+        }
+        else if( uiTag == BIN_TAG_INDEX )
+        {
+            /// the index is the last chunk, only trailer follows
+            break;
+        }
+        else
+        {
+            /// unknown chunk : skip it
+            pcInputDevice->read(uiLength);
+        }
+    }
+
+    return true;
+}
+
+
+bool AnalysisBinParser::xParseFrame(const QByteArray& rcPayload, ComSequence* pcSequence, int& riDecOrder, int& riLastPOC)
+{
+    const char* pcData = rcPayload.constData();
+    int iSize = rcPayload.size();
+    if( iSize < 8 )
+        return false;
+
+    /// poc
+    int iPoc = (int)xGetUInt(pcData);
+    /// frames out of the decoder's POC window have no chunk, a disabled category is an empty column
+    if( riDecOrder < 0 || riLastPOC != iPoc )
+        riDecOrder = pcSequence->findDecOrder(iPoc, riDecOrder+1);
+    riLastPOC = iPoc;
+    if( riDecOrder < 0 )
+    {
+        qCritical() << "AnalysisBinParser Error! POC" << iPoc << "is not in decoder general info!";
+        return false;
+    }
+    ComFrame* pcFrame = pcSequence->getFramesInDecOrder().at(riDecOrder);
+
+    /// split category columns
+    QVector< QVector<int> > aaiColumns(BIN_CAT_NUM);
+    int iOffset = 8;
+    while( iOffset + 8 <= iSize )
+    {
+        quint32 uiCategory = xGetUInt(pcData+iOffset);
+        int iBytes = (int)xGetUInt(pcData+iOffset+4);
+        iOffset += 8;
+        if( iBytes < 0 || iOffset + iBytes > iSize )
+        {
+            qCritical() << "AnalysisBinParser Error! Illegal category size!";
+            return false;
+        }
+        if( uiCategory < BIN_CAT_NUM )
+        {
+            QVector<int>& raiColumn = aaiColumns[uiCategory];
+            raiColumn.resize(iBytes/4);
+            for(int i = 0; i < raiColumn.size(); i++)
+                raiColumn[i] = (int)xGetUInt(pcData+iOffset+4*i);
+        }
+        iOffset += iBytes;
+    }
+
+    /// CU & PU structure first, other categories are attached to it
+    int iSeqWidth = pcSequence->getWidth();
+    int iMaxCUSize = pcSequence->getMaxCUSize();
+    int iCUOneRow = (iSeqWidth+iMaxCUSize-1)/iMaxCUSize;
+    const QVector<int>& raiCUPU = aaiColumns[BIN_CAT_CUPU];
+    int iPos = 0;
+    while( iPos + 2 <= raiCUPU.size() )
+    {
+        int iAddr = raiCUPU[iPos];
+        int iEntryEnd = iPos + 2 + raiCUPU[iPos+1];
+        iPos += 2;
+        ComCU* pcLCU = pcFrame->getArena().newCUs(pcFrame, 1);
+        pcLCU->setAddr(iAddr);
+        pcLCU->setFrame(pcFrame);
+        pcLCU->setDepth(0);
+        pcLCU->setZorder(0);
+        pcLCU->setSize(iMaxCUSize);
+        pcLCU->setX((iAddr%iCUOneRow)*iMaxCUSize);
+        pcLCU->setY((iAddr/iCUOneRow)*iMaxCUSize);
+        pcFrame->getLCUs().push_back(pcLCU);
+        if( xReadCUMode(raiCUPU, iPos, pcLCU) == false )
+            return false;
+        iPos = iEntryEnd;
+    }
+    qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(), xCUSortingOrder);
+
+    /// per-LCU attributes
+    for(int iCategory = 0; iCategory < BIN_CAT_NUM; iCategory++)
+    {
+        if( iCategory == BIN_CAT_CUPU || iCategory == BIN_CAT_ME )
+            continue;
+
+        const QVector<int>& raiColumn = aaiColumns[iCategory];
+        iPos = 0;
+        while( iPos + 2 <= raiColumn.size() )
+        {
+            int iAddr = raiColumn[iPos];
+            int iEntryEnd = iPos + 2 + raiColumn[iPos+1];
+            iPos += 2;
+
+            if( iCategory == BIN_CAT_TILE )
+            {
+                /// tile entry : addr is the tile number
+                ComTile* pcTile = new ComTile(pcFrame);
+                int iValue = 0;
+                xReadValue(raiColumn, iPos, iValue);
+                pcTile->setFirstCUAddr(iValue);
+                xReadValue(raiColumn, iPos, iValue);
+                pcTile->setWidth(iValue);
+                xReadValue(raiColumn, iPos, iValue);
+                pcTile->setHeight(iValue);
+                pcFrame->getTiles().push_back(pcTile);
+                iPos = iEntryEnd;
+                continue;
+            }
+
+            if( iAddr < 0 || iAddr >= pcFrame->getLCUs().size() )
+            {
+                qCritical() << "AnalysisBinParser Error! Illegal LCU address!";
+                return false;
+            }
+            ComCU* pcLCU = pcFrame->getLCUs().at(iAddr);
+
+            bool bSuccess = true;
+            if( iCategory == BIN_CAT_TU )
+            {
+                bSuccess = xReadTU(raiColumn, iPos, pcLCU);
+            }
+            else if( iCategory == BIN_CAT_BIT_LCU )
+            {
+                int iLCUBit = 0;
+                bSuccess = xReadValue(raiColumn, iPos, iLCUBit);
+                pcLCU->setBitCount(iLCUBit);
+                pcFrame->getBitCount() += iLCUBit;
+            }
+            else if( iCategory == BIN_CAT_BIT_SCU )
+            {
+                bSuccess = xReadSCUBit(raiColumn, iPos, pcLCU);
+            }
+            else
+            {
+                bSuccess = xReadPU(iCategory, raiColumn, iPos, pcLCU);
+            }
+            if( !bSuccess )
+                return false;
+            iPos = iEntryEnd;
+        }
+    }
+
+    return true;
+}
+
+
+ComCU* AnalysisBinParser::buildLCU(ComFrame* pcFrame, int iAddr, const QVector<int>* paiValues)
+{
+    ComSequence* pcSequence = pcFrame->getSequence();
+    int iMaxCUSize = pcSequence->getMaxCUSize();
+    int iCUOneRow = (pcSequence->getWidth()+iMaxCUSize-1)/iMaxCUSize;
+
+    ComCU* pcLCU = pcFrame->getArena().newCUs(pcFrame, 1);
+    pcLCU->setAddr(iAddr);
+    pcLCU->setFrame(pcFrame);
+    pcLCU->setDepth(0);
+    pcLCU->setZorder(0);
+    pcLCU->setSize(iMaxCUSize);
+    pcLCU->setX((iAddr%iCUOneRow)*iMaxCUSize);
+    pcLCU->setY((iAddr/iCUOneRow)*iMaxCUSize);
+    pcFrame->getLCUs().push_back(pcLCU);
+
+    /// same order as xParseFrame : CU & PU structure first
+    int iPos = 0;
+    if( xReadCUMode(paiValues[BIN_CAT_CUPU], iPos, pcLCU) == false )
+        return NULL;
+    for(int iCategory = 0; iCategory < BIN_CAT_NUM; iCategory++)
+    {
+        if( iCategory == BIN_CAT_CUPU || iCategory == BIN_CAT_ME || iCategory == BIN_CAT_TILE )
+            continue;
+        const QVector<int>& raiColumn = paiValues[iCategory];
+        iPos = 0;
+        bool bSuccess = true;
+        if( iCategory == BIN_CAT_TU )
+        {
+            bSuccess = xReadTU(raiColumn, iPos, pcLCU);
+        }
+        else if( iCategory == BIN_CAT_BIT_LCU )
+        {
+            int iLCUBit = 0;
+            bSuccess = xReadValue(raiColumn, iPos, iLCUBit);
+            pcLCU->setBitCount(iLCUBit);
+            pcFrame->getBitCount() += iLCUBit;
+        }
+        else if( iCategory == BIN_CAT_BIT_SCU )
+        {
+            bSuccess = xReadSCUBit(raiColumn, iPos, pcLCU);
+        }
+        else
+        {
+            bSuccess = xReadPU(iCategory, raiColumn, iPos, pcLCU);
+        }
+        if( !bSuccess )
+            return NULL;
+    }
+    return pcLCU;
+}
+
+bool AnalysisBinParser::xReadCUMode(const QVector<int>& raiValues, int& riPos, ComCU* pcCU)
+{
+    int iCUMode;
+    if( xReadValue(raiValues, riPos, iCUMode) == false )
+    {
+        qCritical() << "AnalysisBinParser Error! Illegal CU/PU Mode!";
+        return false;
+    }
+
+    if( iCUMode == CU_SLIPT_FLAG )
+    {
+        int iMaxDepth = pcCU->getFrame()->getSequence()->getMaxCUDepth();
+        int iTotalNumPart = 1 << ( (iMaxDepth-pcCU->getDepth()) << 1 );
+        /// non-leaf node : add 4 children CUs
+        ComCU* pcChildren = pcCU->getFrame()->getArena().newCUs(pcCU->getFrame(), 4);
+        pcCU->setSCUs(pcChildren, 4);
+        for(int i = 0; i < 4; i++)
+        {
+            ComCU* pcChildNode = &pcChildren[i];
+            pcChildNode->setAddr(pcCU->getAddr());
+            pcChildNode->setDepth(pcCU->getDepth()+1);
+            pcChildNode->setZorder( pcCU->getZorder() + (iTotalNumPart/4)*i );
+            pcChildNode->setSize(pcCU->getSize()/2);
+            pcChildNode->setX(pcCU->getX() + i%2 * (pcCU->getSize()/2));
+            pcChildNode->setY(pcCU->getY() + i/2 * (pcCU->getSize()/2));
+            if( xReadCUMode(raiValues, riPos, pcChildNode) == false )
+                return false;
+        }
+    }
+    else
+    {
+        /// leaf node : create PUs and write the PU Mode for it
+        pcCU->setPartSize((PartSize)iCUMode);
+
+        int iPUCount = ComCU::getPUNum((PartSize)iCUMode);
+        ComPU* pcPUs = pcCU->getFrame()->getArena().newPUs(pcCU, iPUCount);
+        pcCU->setPUs(pcPUs, iPUCount);
+        for(int i = 0; i < iPUCount; i++)
+        {
+            ComPU* pcPU = &pcPUs[i];
+            int iPUOffsetX, iPUOffsetY, iPUWidth, iPUHeight;
+            ComCU::getPUOffsetAndSize(pcCU->getSize(), (PartSize)iCUMode, i, iPUOffsetX, iPUOffsetY, iPUWidth, iPUHeight);
+            pcPU->setX(pcCU->getX() + iPUOffsetX);
+            pcPU->setY(pcCU->getY() + iPUOffsetY);
+            pcPU->setWidth(iPUWidth);
+            pcPU->setHeight(iPUHeight);
+        }
+    }
+    return true;
+}
+
+
+bool AnalysisBinParser::xReadTU(const QVector<int>& raiValues, int& riPos, ComCU* pcCU)
+{
+    if( !pcCU->getSCUs().empty() )
+    {
+        /// non-leaf CU node : continue to leaf CU
+        for(int i = 0; i < 4; i++)
+        {
+            if( xReadTU(raiValues, riPos, pcCU->getSCUs().at(i)) == false )
+                return false;
+        }
+        return true;
+    }
+
+    /// leaf CU node : read TU
+    ComTU* pcTURoot = &pcCU->getTURoot();
+    pcTURoot->setX(pcCU->getX());
+    pcTURoot->setY(pcCU->getY());
+    pcTURoot->setSize(pcCU->getSize());
+    return xReadTUHelper(raiValues, riPos, &pcCU->getFrame()->getArena(), pcTURoot);
+}
+
+
+bool AnalysisBinParser::xReadTUHelper(const QVector<int>& raiValues, int& riPos, ComArena* pcArena, ComTU* pcTU)
+{
+    int iTUMode;
+    if( xReadValue(raiValues, riPos, iTUMode) == false )
+    {
+        qCritical() << "AnalysisBinParser Error! Illegal TU Mode!";
+        return false;
+    }
+
+    if( iTUMode == TU_SLIPT_FLAG )
+    {
+        /// non-leaf node : add 4 children TUs
+        ComTU* pcChildren = pcArena->newTUs(4);
+        pcTU->setTUs(pcChildren, 4);
+        for(int i = 0; i < 4; i++)
+        {
+            ComTU* pcChildNode = &pcChildren[i];
+            pcChildNode->setSize(pcTU->getSize()/2);
+            pcChildNode->setX(pcTU->getX() + i%2 * (pcTU->getSize()/2));
+            pcChildNode->setY(pcTU->getY() + i/2 * (pcTU->getSize()/2));
+            if( xReadTUHelper(raiValues, riPos, pcArena, pcChildNode) == false )
+                return false;
+        }
+    }
+    return true;
+}
+
+
+bool AnalysisBinParser::xReadPU(int iCategory, const QVector<int>& raiValues, int& riPos, ComCU* pcCU)
+{
+    if( !pcCU->getSCUs().empty() )
+    {
+        /// non-leaf node : recursive reading for children
+        for(int i = 0; i < 4; i++)
+        {
+            if( xReadPU(iCategory, raiValues, riPos, pcCU->getSCUs().at(i)) == false )
+                return false;
+        }
+        return true;
+    }
+
+    /// leaf node : read data
+    for(int i = 0; i < pcCU->getPUs().size(); i++)
+    {
+        ComPU* pcPU = pcCU->getPUs().at(i);
+        int iValue = 0;
+        if( xReadValue(raiValues, riPos, iValue) == false )
+            return false;
+
+        switch( iCategory )
+        {
+        case BIN_CAT_PRED:
+            pcPU->setPredMode((PredMode)iValue);
+            break;
+        case BIN_CAT_MERGE:
+            pcPU->setMergeIndex(iValue);
+            break;
+        case BIN_CAT_INTRA:
+        {
+            int iIntraDirChroma = 0;
+            if( xReadValue(raiValues, riPos, iIntraDirChroma) == false )
+                return false;
+            pcPU->setIntraDirLuma(iValue);
+            pcPU->setIntraDirChroma(iIntraDirChroma);
+            break;
+        }
+        case BIN_CAT_MV:
+        {
+            /// inter dir, then 1 MV for uni-prediction or 2 MVs for bi-prediction
+            pcPU->setInterDir(iValue);
+            int iMVNum = (iValue == 3) ? 2 : ((iValue == 1 || iValue == 2) ? 1 : 0);
+            for(int j = 0; j < iMVNum; j++)
+            {
+                int iRefPOC, iHor, iVer;
+                if( !xReadValue(raiValues, riPos, iRefPOC) ||
+                    !xReadValue(raiValues, riPos, iHor) ||
+                    !xReadValue(raiValues, riPos, iVer) )
+                    return false;
+                ComMV cReadMV(iHor, iVer);
+                cReadMV.setRefPOC(iRefPOC);
+                pcPU->getMVs().push_back(cReadMV);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+
+bool AnalysisBinParser::xReadSCUBit(const QVector<int>& raiValues, int& riPos, ComCU* pcCU)
+{
+    if( !pcCU->getSCUs().empty() )
+    {
+        /// non-leaf node : recursive reading for children
+        for(int i = 0; i < 4; i++)
+        {
+            if( xReadSCUBit(raiValues, riPos, pcCU->getSCUs().at(i)) == false )
+                return false;
+        }
+        return true;
+    }
+
+    /// leaf node : read data
+    int iSCUBit = 0;
+    if( xReadValue(raiValues, riPos, iSCUBit) == false )
+        return false;
+    pcCU->setBitCount(iSCUBit);
+    return true;
+}
+
+
+bool AnalysisBinParser::xReadValue(const QVector<int>& raiValues, int& riPos, int& riValue)
+{
+    if( riPos >= raiValues.size() )
+        return false;
+    riValue = raiValues[riPos++];
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef ANALYSISBINPARSER_H
+#define ANALYSISBINPARSER_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QVector>
+#include "model/common/comsequence.h"
+
+/*!
+ * \brief The AnalysisBinParser class
+ * this class is used to parse the binary analysis container (i.e. the 'decoder_analysis.bin')
+ * written by TSysuAnalyzerOutput. It replaces the cupu, tu, pred, mv, merge, intra, bit and
+ * tile text files, the container layout is documented in TSysuAnalyzerOutput.h
+ */
+
+class AnalysisBinParser : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AnalysisBinParser(QObject *parent = 0);
+    /*!
+     * \brief parseFile
+     * \param pcInputDevice opened input file
+     * \param pcSequence output sequence (SPS and decoder general info must be parsed already)
+     * \return
+     */
+    bool parseFile(QIODevice* pcInputDevice, ComSequence* pcSequence);
+
+    /*!
+     * \brief buildLCU build one LCU from the values of each category (used by the in-process decoder)
+     * \param paiValues BIN_CAT_NUM columns, same values as one line of each text file (ME and tile are ignored)
+     * \return the LCU appended to pcFrame (not sorted), NULL if the values are illegal
+     */
+    ComCU* buildLCU(ComFrame* pcFrame, int iAddr, const QVector<int>* paiValues);
+
+protected:
+    bool xParseFrame(const QByteArray& rcPayload, ComSequence* pcSequence, int& riDecOrder, int& riLastPOC);
+
+    /// category readers, each one walks the LCU tree like the corresponding text parser
+    bool xReadCUMode(const QVector<int>& raiValues, int& riPos, ComCU* pcCU);
+    bool xReadTU(const QVector<int>& raiValues, int& riPos, ComCU* pcCU);
+    bool xReadTUHelper(const QVector<int>& raiValues, int& riPos, ComArena* pcArena, ComTU* pcTU);
+    bool xReadPU(int iCategory, const QVector<int>& raiValues, int& riPos, ComCU* pcCU);
+    bool xReadSCUBit(const QVector<int>& raiValues, int& riPos, ComCU* pcCU);
+
+    bool xReadValue(const QVector<int>& raiValues, int& riPos, int& riValue);
+
+signals:
+
+public slots:
+
+};
+
+#endif // ANALYSISBINPARSER_H
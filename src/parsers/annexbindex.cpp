@@ -0,0 +1,463 @@
+#include "annexbindex.h"
+#include "../views/bitstreamversionselector.h"
+#include <QFile>
+#include <QByteArray>
+#include <QList>
+#include <QDataStream>
+#include <QDebug>
+
+#define ANNEXB_INDEX_MAGIC      0x58494241      ///< 'ABIX'
+#define ANNEXB_INDEX_VERSION    1
+#define ANNEXB_COPY_BLOCK       (1 << 20)       ///< bytes copied per read by writeRange()
+#define ANNEXB_MAX_SPS          16
+#define ANNEXB_MAX_PPS          64
+
+/// position of the next 0x000001 at or after iPos, iSize if there is none
+static qint64 xNextStartCode(const uchar* pucData, qint64 iSize, qint64 iPos)
+{
+    for( ; iPos+2 < iSize; iPos++ )
+    {
+        if( pucData[iPos+2] > 1 )
+            iPos += 2;      ///< no start code can end at iPos+2
+        else if( pucData[iPos] == 0 && pucData[iPos+1] == 0 && pucData[iPos+2] == 1 )
+            return iPos;
+    }
+    return iSize;
+}
+
+/// NAL units which may start an access unit before its first VCL NAL unit (7.4.2.4.4)
+static bool xIsAUPrefix(int iType)
+{
+    return (iType >= NAL_VPS && iType <= NAL_AUD) || iType == NAL_PREFIX_SEI ||
+           (iType >= NAL_RSV_NVCL41 && iType <= NAL_RSV_NVCL44) ||
+           (iType >= NAL_UNSPEC48 && iType <= NAL_UNSPEC55);
+}
+
+/// RBSP bits of a NAL unit payload, emulation prevention bytes skipped, zeros past its end
+class RbspReader
+{
+public:
+    RbspReader(const uchar* pucData, qint64 iSize)
+        : m_pucData(pucData), m_iSize(iSize), m_iPos(0), m_iZeros(0), m_uiByte(0), m_iBitsLeft(0) {}
+
+    uint readBits(int iBits)
+    {
+        uint uiValue = 0;
+        for( ; iBits > 0; iBits-- )
+        {
+            if( m_iBitsLeft == 0 )
+            {
+                m_uiByte = xNextByte();
+                m_iBitsLeft = 8;
+            }
+            uiValue = (uiValue << 1) | ((m_uiByte >> --m_iBitsLeft) & 1);
+        }
+        return uiValue;
+    }
+
+    /// ue(v)
+    uint readUE()
+    {
+        int iLeadingZeros = 0;
+        while( readBits(1) == 0 && iLeadingZeros < 31 )
+            iLeadingZeros++;
+        return ((1u << iLeadingZeros) - 1) + readBits(iLeadingZeros);
+    }
+
+    /// more bits read than the NAL unit has (a broken or truncated one)
+    bool isOverrun() const { return m_iPos > m_iSize; }
+
+private:
+    uint xNextByte()
+    {
+        if( m_iPos >= m_iSize )
+        {
+            m_iPos++;
+            return 0;
+        }
+        uint uiByte = m_pucData[m_iPos++];
+        if( m_iZeros >= 2 && uiByte == 3 )
+        {
+            m_iZeros = 0;
+            return xNextByte();
+        }
+        m_iZeros = (uiByte == 0) ? m_iZeros+1 : 0;
+        return uiByte;
+    }
+
+    const uchar* m_pucData;
+    qint64 m_iSize;
+    qint64 m_iPos;
+    int m_iZeros;           ///< zero bytes just read
+    uint m_uiByte;
+    int m_iBitsLeft;
+};
+
+/// the SPS syntax elements a first slice header depends on, iPocLsbBits is 0 for an unknown SPS
+struct SpsInfo
+{
+    int iPocLsbBits;
+    bool bSeparateColourPlane;
+};
+
+/// the PPS syntax elements a first slice header depends on, iSpsId is -1 for an unknown PPS
+struct PpsInfo
+{
+    int iSpsId;
+    bool bOutputFlagPresent;
+    int iExtraSliceHeaderBits;
+};
+
+/// seq_parameter_set_rbsp() up to log2_max_pic_order_cnt_lsb_minus4 (7.3.2.2)
+static bool xParseSPS(RbspReader& rcReader, int& riSpsId, SpsInfo& rcSps)
+{
+    rcReader.readBits(4);                                   ///< sps_video_parameter_set_id
+    int iMaxSubLayersMinus1 = rcReader.readBits(3);
+    rcReader.readBits(1);                                   ///< sps_temporal_id_nesting_flag
+
+    /// profile_tier_level(): 96 bits of the general profile and level, then the sub-layers
+    rcReader.readBits(8);
+    rcReader.readBits(32);
+    rcReader.readBits(32);
+    rcReader.readBits(24);
+    bool abSubLayerProfile[8], abSubLayerLevel[8];
+    for(int i = 0; i < iMaxSubLayersMinus1; i++)
+    {
+        abSubLayerProfile[i] = rcReader.readBits(1);
+        abSubLayerLevel[i] = rcReader.readBits(1);
+    }
+    if( iMaxSubLayersMinus1 > 0 )
+        rcReader.readBits(2 * (8-iMaxSubLayersMinus1));     ///< reserved_zero_2bits
+    for(int i = 0; i < iMaxSubLayersMinus1; i++)
+    {
+        if( abSubLayerProfile[i] )
+        {
+            rcReader.readBits(32);
+            rcReader.readBits(32);
+            rcReader.readBits(24);
+        }
+        if( abSubLayerLevel[i] )
+            rcReader.readBits(8);
+    }
+
+    riSpsId = rcReader.readUE();
+    rcSps.bSeparateColourPlane = (rcReader.readUE() == 3) ? rcReader.readBits(1) : false;
+    rcReader.readUE();                                      ///< pic_width_in_luma_samples
+    rcReader.readUE();                                      ///< pic_height_in_luma_samples
+    if( rcReader.readBits(1) )                              ///< conformance_window_flag
+    {
+        for(int i = 0; i < 4; i++)
+            rcReader.readUE();
+    }
+    rcReader.readUE();                                      ///< bit_depth_luma_minus8
+    rcReader.readUE();                                      ///< bit_depth_chroma_minus8
+    rcSps.iPocLsbBits = rcReader.readUE() + 4;
+    return !rcReader.isOverrun() && riSpsId < ANNEXB_MAX_SPS && rcSps.iPocLsbBits <= 16;
+}
+
+/// pic_parameter_set_rbsp() up to num_extra_slice_header_bits (7.3.2.3)
+static bool xParsePPS(RbspReader& rcReader, int& riPpsId, PpsInfo& rcPps)
+{
+    riPpsId = rcReader.readUE();
+    rcPps.iSpsId = rcReader.readUE();
+    rcReader.readBits(1);                                   ///< dependent_slice_segments_enabled_flag
+    rcPps.bOutputFlagPresent = rcReader.readBits(1);
+    rcPps.iExtraSliceHeaderBits = rcReader.readBits(3);
+    return !rcReader.isOverrun() && riPpsId < ANNEXB_MAX_PPS && rcPps.iSpsId < ANNEXB_MAX_SPS;
+}
+
+/// slice_pic_order_cnt_lsb of the first slice segment of a picture (7.3.6.1), -1 if the parameter sets are unknown
+static int xParsePocLsb(RbspReader& rcReader, int iNalType, const SpsInfo* pcSpsList, const PpsInfo* pcPpsList,
+                        int& riPocLsbBits)
+{
+    rcReader.readBits(1);                                   ///< first_slice_segment_in_pic_flag
+    if( AnnexBIndex::isIRAP(iNalType) )
+        rcReader.readBits(1);                               ///< no_output_of_prior_pics_flag
+    uint uiPpsId = rcReader.readUE();
+    if( uiPpsId >= ANNEXB_MAX_PPS || pcPpsList[uiPpsId].iSpsId < 0 )
+        return -1;
+    const PpsInfo& rcPps = pcPpsList[uiPpsId];
+    const SpsInfo& rcSps = pcSpsList[rcPps.iSpsId];
+    if( rcSps.iPocLsbBits == 0 )
+        return -1;
+    riPocLsbBits = rcSps.iPocLsbBits;
+
+    rcReader.readBits(rcPps.iExtraSliceHeaderBits);         ///< slice_reserved_flag
+    rcReader.readUE();                                      ///< slice_type
+    if( rcPps.bOutputFlagPresent )
+        rcReader.readBits(1);                               ///< pic_output_flag
+    if( rcSps.bSeparateColourPlane )
+        rcReader.readBits(2);                               ///< colour_plane_id
+    if( iNalType == NAL_IDR_W_RADL || iNalType == NAL_IDR_N_LP )
+        return 0;
+    int iPocLsb = rcReader.readBits(rcSps.iPocLsbBits);
+    return rcReader.isOverrun() ? -1 : iPocLsb;
+}
+
+/// sub-layer non-reference, RADL and RASL pictures are not prevTid0Pic (8.3.1)
+static bool xIsTid0Candidate(int iNalType)
+{
+    if( iNalType <= NAL_RSV_VCL_N14 && iNalType % 2 == 0 )
+        return false;
+    return iNalType < NAL_RADL_N || iNalType > NAL_RASL_R;
+}
+
+
+AnnexBIndex::AnnexBIndex()
+{
+    m_iSize = 0;
+}
+
+bool AnnexBIndex::open(const QString& strBitstreamFilePath, const QString& strCacheFile)
+{
+    QFile cBitstreamFile(strBitstreamFilePath);
+    if( !cBitstreamFile.open(QIODevice::ReadOnly) )
+        return false;
+    qint64 iSize = cBitstreamFile.size();
+    if( !strCacheFile.isEmpty() && xLoad(strCacheFile, iSize) )
+        return true;
+
+    /// memory-map the whole file if possible (same as IntTokenizer)
+    QByteArray cBuffer;
+    const uchar* pucData = cBitstreamFile.map(0, iSize);
+    if( pucData == NULL )
+    {
+        cBuffer = cBitstreamFile.readAll();
+        pucData = (const uchar*)cBuffer.constData();
+    }
+    scan(pucData, iSize);
+    if( cBuffer.isEmpty() )
+        cBitstreamFile.unmap((uchar*)pucData);
+
+    if( !strCacheFile.isEmpty() && !xSave(strCacheFile) )
+        qWarning() << "Bitstream index can not be saved to" << strCacheFile;
+    return true;
+}
+
+void AnnexBIndex::scan(const uchar* pucData, qint64 iSize)
+{
+    m_iSize = iSize;
+    m_acPictures.clear();
+    m_acParamSets.clear();
+
+    qint64 iAUStart = -1;           ///< first prefix NAL unit of the next picture
+    int iLastCRA = -1;              ///< the RASL pictures of a CRA follow it before the next IRAP
+    bool bNoRaslOutput = true;      ///< the next IRAP picture starts a coded video sequence (first one, after EOS)
+    int iPrevTid0Poc = 0;
+    SpsInfo acSps[ANNEXB_MAX_SPS];
+    PpsInfo acPps[ANNEXB_MAX_PPS];
+    for(int i = 0; i < ANNEXB_MAX_SPS; i++)
+        acSps[i].iPocLsbBits = 0;
+    for(int i = 0; i < ANNEXB_MAX_PPS; i++)
+        acPps[i].iSpsId = -1;
+    qint64 iStartCode = xNextStartCode(pucData, iSize, 0);
+    while( iStartCode < iSize )
+    {
+        qint64 iNalStart = (iStartCode > 0 && pucData[iStartCode-1] == 0) ? iStartCode-1 : iStartCode;
+        qint64 iHeader = iStartCode + 3;
+        qint64 iNext = xNextStartCode(pucData, iSize, iHeader);
+        if( iHeader+2 > iNext )
+        {
+            iStartCode = iNext;
+            continue;
+        }
+        int iType = (pucData[iHeader] >> 1) & 0x3F;
+        int iTemporalId = (pucData[iHeader+1] & 0x07) - 1;
+        RbspReader cReader(pucData + iHeader+2, iNext - (iHeader+2));
+
+        if( iType <= NAL_VCL_LAST )
+        {
+            /// first_slice_segment_in_pic_flag
+            if( iHeader+2 < iNext && (pucData[iHeader+2] & 0x80) )
+            {
+                /// POC (8.3.1), the MSB is reset at the start of every coded video sequence
+                int iPoc = 0;
+                int iPocLsbBits = 0;
+                int iPocLsb = xParsePocLsb(cReader, iType, acSps, acPps, iPocLsbBits);
+                if( iPocLsb >= 0 )
+                {
+                    int iMaxPocLsb = 1 << iPocLsbBits;
+                    int iPocMsb = 0;
+                    if( !isIRAP(iType) || (iType == NAL_CRA && !bNoRaslOutput) )
+                    {
+                        int iPrevPocLsb = iPrevTid0Poc & (iMaxPocLsb-1);
+                        int iPrevPocMsb = iPrevTid0Poc - iPrevPocLsb;
+                        if( iPocLsb < iPrevPocLsb && iPrevPocLsb - iPocLsb >= iMaxPocLsb/2 )
+                            iPocMsb = iPrevPocMsb + iMaxPocLsb;
+                        else if( iPocLsb > iPrevPocLsb && iPocLsb - iPrevPocLsb > iMaxPocLsb/2 )
+                            iPocMsb = iPrevPocMsb - iMaxPocLsb;
+                        else
+                            iPocMsb = iPrevPocMsb;
+                    }
+                    iPoc = iPocMsb + iPocLsb;
+                    if( iTemporalId == 0 && xIsTid0Candidate(iType) )
+                        iPrevTid0Poc = iPoc;
+                }
+                if( isIRAP(iType) )
+                    bNoRaslOutput = false;
+
+                AnnexBPicture cPicture = { iAUStart >= 0 ? iAUStart : iNalStart, iType, iTemporalId, iPoc, isIRAP(iType) };
+                if( isIRAP(iType) )
+                    iLastCRA = (iType == NAL_CRA) ? m_acPictures.size() : -1;
+                else if( (iType == NAL_RASL_N || iType == NAL_RASL_R) && iLastCRA >= 0 )
+                {
+                    m_acPictures[iLastCRA].bCutPoint = false;
+                    iLastCRA = -1;
+                }
+                m_acPictures.push_back(cPicture);
+            }
+            iAUStart = -1;
+        }
+        else
+        {
+            if( iType >= NAL_VPS && iType <= NAL_PPS )
+            {
+                AnnexBNalUnit cParamSet = { iNalStart, iNext };
+                m_acParamSets.push_back(cParamSet);
+            }
+            int iId;
+            SpsInfo cSps;
+            PpsInfo cPps;
+            if( iType == NAL_SPS && xParseSPS(cReader, iId, cSps) )
+                acSps[iId] = cSps;
+            else if( iType == NAL_PPS && xParsePPS(cReader, iId, cPps) )
+                acPps[iId] = cPps;
+            else if( iType == NAL_EOS )
+                bNoRaslOutput = true;
+            if( iAUStart < 0 && xIsAUPrefix(iType) )
+                iAUStart = iNalStart;
+        }
+        iStartCode = iNext;
+    }
+}
+
+bool AnnexBIndex::isSupported(int iEncoderVersion)
+{
+    return iEncoderVersion == HM100 || iEncoderVersion == HM120;
+}
+
+qint64 AnnexBIndex::getPictureEnd(int iPicture) const
+{
+    if( iPicture+1 < m_acPictures.size() )
+        return m_acPictures[iPicture+1].iStart;
+    return m_iSize;
+}
+
+qint64 AnnexBIndex::getBytesBefore(int iPictureNum) const
+{
+    if( iPictureNum <= 0 )
+        return 0;
+    return getPictureEnd(qMin(iPictureNum, m_acPictures.size()) - 1);
+}
+
+int AnnexBIndex::findCutPoint(int iPicture) const
+{
+    for(int i = qMin(iPicture, m_acPictures.size()-1); i > 0; i--)
+    {
+        if( m_acPictures[i].bCutPoint )
+            return i;
+    }
+    return 0;
+}
+
+bool AnnexBIndex::writeRange(const QString& strBitstreamFilePath, qint64 iStart, qint64 iEnd, const QString& strFilename) const
+{
+    QFile cBitstreamFile(strBitstreamFilePath);
+    QFile cRangeFile(strFilename);
+    if( !cBitstreamFile.open(QIODevice::ReadOnly) || !cRangeFile.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+        return false;
+
+    QByteArray cParamSets;
+    if( !readParamSets(&cBitstreamFile, iStart, cParamSets) )
+        return false;
+    cRangeFile.write(cParamSets);
+
+    if( !cBitstreamFile.seek(iStart) )
+        return false;
+    for(qint64 iPos = iStart; iPos < iEnd; )
+    {
+        QByteArray cBlock = cBitstreamFile.read(qMin(iEnd - iPos, (qint64)ANNEXB_COPY_BLOCK));
+        if( cBlock.isEmpty() || cRangeFile.write(cBlock) != cBlock.size() )
+            return false;
+        iPos += cBlock.size();
+    }
+    return true;
+}
+
+bool AnnexBIndex::readParamSets(QFile* pcBitstreamFile, qint64 iStart, QByteArray& rcParamSets) const
+{
+    /// latest copy of every parameter set, in the order they were sent (a later one may replace an earlier one)
+    QList<QByteArray> acParamSets;
+    foreach(const AnnexBNalUnit& rcParamSet, m_acParamSets)
+    {
+        if( rcParamSet.iEnd > iStart )
+            break;
+        if( !pcBitstreamFile->seek(rcParamSet.iStart) )
+            return false;
+        QByteArray cNal = pcBitstreamFile->read(rcParamSet.iEnd - rcParamSet.iStart);
+        acParamSets.removeOne(cNal);
+        acParamSets.push_back(cNal);
+    }
+    rcParamSets.clear();
+    foreach(const QByteArray& cNal, acParamSets)
+        rcParamSets.append(cNal);
+    return true;
+}
+
+bool AnnexBIndex::xLoad(const QString& strCacheFile, qint64 iBitstreamSize)
+{
+    QFile cIndexFile(strCacheFile);
+    if( !cIndexFile.open(QIODevice::ReadOnly) )
+        return false;
+    QDataStream cIn(&cIndexFile);
+
+    quint32 uiMagic, uiVersion, uiPictureNum, uiParamSetNum;
+    qint64 iSize;
+    cIn >> uiMagic >> uiVersion >> iSize;
+    if( uiMagic != ANNEXB_INDEX_MAGIC || uiVersion != ANNEXB_INDEX_VERSION || iSize != iBitstreamSize )
+        return false;
+
+    cIn >> uiPictureNum;
+    if( cIn.status() != QDataStream::Ok )
+        return false;
+    QVector<AnnexBPicture> acPictures(uiPictureNum);
+    for(quint32 i = 0; i < uiPictureNum; i++)
+    {
+        qint32 iNalType, iTemporalId, iPoc;
+        cIn >> acPictures[i].iStart >> iNalType >> iTemporalId >> iPoc >> acPictures[i].bCutPoint;
+        acPictures[i].iNalType = iNalType;
+        acPictures[i].iTemporalId = iTemporalId;
+        acPictures[i].iPoc = iPoc;
+    }
+    cIn >> uiParamSetNum;
+    if( cIn.status() != QDataStream::Ok )
+        return false;
+    QVector<AnnexBNalUnit> acParamSets(uiParamSetNum);
+    for(quint32 i = 0; i < uiParamSetNum; i++)
+        cIn >> acParamSets[i].iStart >> acParamSets[i].iEnd;
+    if( cIn.status() != QDataStream::Ok )
+        return false;
+
+    m_iSize = iSize;
+    m_acPictures = acPictures;
+    m_acParamSets = acParamSets;
+    return true;
+}
+
+bool AnnexBIndex::xSave(const QString& strCacheFile) const
+{
+    QFile cIndexFile(strCacheFile);
+    if( !cIndexFile.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+        return false;
+    QDataStream cOut(&cIndexFile);
+
+    cOut << (quint32)ANNEXB_INDEX_MAGIC << (quint32)ANNEXB_INDEX_VERSION << m_iSize;
+    cOut << (quint32)m_acPictures.size();
+    foreach(const AnnexBPicture& rcPicture, m_acPictures)
+        cOut << rcPicture.iStart << (qint32)rcPicture.iNalType << (qint32)rcPicture.iTemporalId
+             << (qint32)rcPicture.iPoc << rcPicture.bCutPoint;
+    cOut << (quint32)m_acParamSets.size();
+    foreach(const AnnexBNalUnit& rcParamSet, m_acParamSets)
+        cOut << rcParamSet.iStart << rcParamSet.iEnd;
+    return cOut.status() == QDataStream::Ok;
+}
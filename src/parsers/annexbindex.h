@@ -0,0 +1,107 @@
+#ifndef ANNEXBINDEX_H
+#define ANNEXBINDEX_H
+
+#include <QVector>
+#include <QString>
+#include <QFile>
+#include "gitldef.h"
+
+/// HEVC NAL unit types (Table 7-1)
+enum NalUnitType
+{
+    NAL_RADL_N = 6,
+    NAL_RADL_R = 7,
+    NAL_RASL_N = 8,
+    NAL_RASL_R = 9,
+    NAL_RSV_VCL_N14 = 14,
+    NAL_BLA_W_LP = 16,
+    NAL_BLA_N_LP = 18,
+    NAL_IDR_W_RADL = 19,
+    NAL_IDR_N_LP = 20,
+    NAL_CRA = 21,
+    NAL_VCL_LAST = 31,
+    NAL_VPS = 32,
+    NAL_SPS = 33,
+    NAL_PPS = 34,
+    NAL_AUD = 35,
+    NAL_EOS = 36,
+    NAL_PREFIX_SEI = 39,
+    NAL_RSV_NVCL41 = 41,
+    NAL_RSV_NVCL44 = 44,
+    NAL_UNSPEC48 = 48,
+    NAL_UNSPEC55 = 55
+};
+
+/// one picture (access unit) of the bitstream
+struct AnnexBPicture
+{
+    qint64 iStart;          ///< first NAL unit of the access unit (parameter sets, SEI, ... included)
+    int iNalType;           ///< type of its first slice
+    int iTemporalId;
+    int iPoc;               ///< from the first slice header, 0 if its parameter sets were not found
+    bool bCutPoint;         ///< decoding can start here, the pictures from here on are decoded the same
+};
+
+/// one NAL unit of the bitstream, start code included
+struct AnnexBNalUnit
+{
+    qint64 iStart;
+    qint64 iEnd;
+};
+
+/*!
+ * \brief The AnnexBIndex class
+ * pictures and parameter sets of an HEVC Annex-B bitstream (HM-10.0 and later), found by one scan of the
+ * start codes and NAL unit headers; of the slice data only the first slice header of every picture is read
+ * (for its POC). A picture is a cut point if it is an IDR or BLA picture, or a CRA picture without RASL
+ * pictures (they would be dropped when decoding starts at the CRA).
+ * The index can be kept in a cache file, so a bitstream is scanned once only.
+ */
+
+class AnnexBIndex
+{
+public:
+    AnnexBIndex();
+
+    /// scan the whole file, or load the index from strCacheFile (and save it there after a scan)
+    bool open(const QString& strBitstreamFilePath, const QString& strCacheFile = QString());
+    void scan(const uchar* pucData, qint64 iSize);
+
+    /// end of picture iPicture (start of the next one)
+    qint64 getPictureEnd(int iPicture) const;
+
+    /// bytes of the pictures before iPictureNum, i.e. consumed by a decoder which has decoded iPictureNum pictures
+    qint64 getBytesBefore(int iPictureNum) const;
+
+    /// the last cut point at or before iPicture (0 if there is none), where decoding picture iPicture starts
+    int findCutPoint(int iPicture) const;
+
+    /*!
+     * \brief writeRange write bytes [iStart, iEnd) of the bitstream to strFilename as a bitstream of its own:
+     * preceded by the latest copy of every parameter set sent before iStart, iStart has to be a cut point
+     */
+    bool writeRange(const QString& strBitstreamFilePath, qint64 iStart, qint64 iEnd, const QString& strFilename) const;
+
+    /// the latest copy of every parameter set sent before iStart, in bitstream order (see writeRange())
+    bool readParamSets(QFile* pcBitstreamFile, qint64 iStart, QByteArray& rcParamSets) const;
+
+    static bool isIRAP(int iNalType) { return iNalType >= NAL_BLA_W_LP && iNalType <= NAL_CRA; }
+    /*!
+     * IDR and BLA pictures start with POC MSB 0 in every decoding, so a decoder started at one of them
+     * writes the POCs of the whole bitstream (a CRA cut point restarts its POC MSB at 0 only there)
+     */
+    static bool isPocReset(int iNalType) { return iNalType >= NAL_BLA_W_LP && iNalType <= NAL_IDR_N_LP; }
+
+    /// the bitstreams of this decoder use the NAL unit types of the final HEVC spec (HM-10.0 and later)
+    static bool isSupported(int iEncoderVersion);
+
+    ADD_CLASS_FIELD_NOSETTER(qint64, iSize, getSize)                                 ///< bytes of the bitstream
+    ADD_CLASS_FIELD_NOSETTER(QVector<AnnexBPicture>, acPictures, getPictures)       ///< in decoding order
+    ADD_CLASS_FIELD_NOSETTER(QVector<AnnexBNalUnit>, acParamSets, getParamSets)     ///< VPS, SPS and PPS NAL units, in bitstream order
+
+protected:
+    bool xLoad(const QString& strCacheFile, qint64 iBitstreamSize);
+    bool xSave(const QString& strCacheFile) const;
+};
+
+#endif // ANNEXBINDEX_H
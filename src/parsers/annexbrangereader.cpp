@@ -0,0 +1,35 @@
+#include "annexbrangereader.h"
+
+#define RANGE_READ_SIZE         (1 << 20)       ///< bytes read from the file at once
+
+AnnexBRangeReader::AnnexBRangeReader(qint64 iStart, qint64 iEnd, const QByteArray& rcParamSets) :
+    m_iStart(iStart), m_iEnd(iEnd), m_cParamSets(rcParamSets)
+{
+}
+
+bool AnnexBRangeReader::open(const QString& strFilePath)
+{
+    m_cFile.setFileName(strFilePath);
+    if( !m_cFile.open(QIODevice::ReadOnly) || !m_cFile.seek(m_iStart) )
+        return false;
+    m_iBytesRead = m_iStart;
+    return true;
+}
+
+bool AnnexBRangeReader::readAccessUnit(QByteArray& rcAnnexB)
+{
+    if( !m_cParamSets.isEmpty() )
+    {
+        rcAnnexB.append(m_cParamSets);
+        m_cParamSets.clear();
+        return true;
+    }
+    if( m_iBytesRead >= m_iEnd )
+        return false;
+    QByteArray cData = m_cFile.read(qMin(m_iEnd - m_iBytesRead, (qint64)RANGE_READ_SIZE));
+    if( cData.isEmpty() )
+        return false;
+    m_iBytesRead += cData.size();
+    rcAnnexB.append(cData);
+    return true;
+}
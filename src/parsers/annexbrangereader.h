@@ -0,0 +1,28 @@
+#ifndef ANNEXBRANGEREADER_H
+#define ANNEXBRANGEREADER_H
+
+#include "parsers/containerdemuxer.h"
+
+/*!
+ * \brief The AnnexBRangeReader class
+ * bytes [iStart, iEnd) of an Annex-B file written into the decoder's stdin, preceded by the parameter sets
+ * sent before iStart (see AnnexBIndex::readParamSets()): the same bitstream as AnnexBIndex::writeRange()
+ * writes to a file, without the copy. iStart has to be a cut point.
+ */
+
+class AnnexBRangeReader : public ContainerDemuxer
+{
+public:
+    AnnexBRangeReader(qint64 iStart, qint64 iEnd, const QByteArray& rcParamSets);
+
+    bool open(const QString& strFilePath);
+    /// the parameter sets first, then the range in blocks (not aligned to access units)
+    bool readAccessUnit(QByteArray& rcAnnexB);
+
+protected:
+    qint64 m_iStart;
+    qint64 m_iEnd;
+    QByteArray m_cParamSets;        ///< written before the range, dropped once written
+};
+
+#endif // ANNEXBRANGEREADER_H
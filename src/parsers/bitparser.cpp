@@ -1,5 +1,5 @@
 #include "bitparser.h"
-#include <QRegExp>
+#include <QDebug>
 
 BitParser::BitParser(QObject *parent) :
     QObject(parent)
@@ -9,112 +9,106 @@ BitParser::BitParser(QObject *parent) :
 
 bool BitParser::parseLCUBitFile(QTextStream* pcInputStream, ComSequence* pcSequence)
 {
-    Q_ASSERT( pcSequence != NULL );
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseLCUBitFile(&cTokenizer, pcSequence);
+}
 
-    QString strOneLine;
-    QRegExp cMatchTarget;
+
+bool BitParser::parseSCUBitFile(QTextStream* pcInputStream, ComSequence* pcSequence)
+{
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseSCUBitFile(&cTokenizer, pcSequence);
+}
 
 
+bool BitParser::parseLCUBitFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
+
     /// <0,0> 95
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
 
     int iDecOrder = -1;
     int iLastPOC  = -1;
-
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-
-            ///
-            QString strBitInfo = cMatchTarget.cap(3);
-            int iLCUBit = strBitInfo.toInt();
-            pcLCU->setBitCount(iLCUBit);
-            pcFrame->getBitCount() += iLCUBit;
-
+            qCritical() << "BitParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        ///
+        int iLCUBit = 0;
+        pcTokenizer->readInt(iLCUBit);
+        pcLCU->setBitCount(iLCUBit);
+        pcFrame->getBitCount() += iLCUBit;
     }
     return true;
 }
 
 
 
-bool BitParser::parseSCUBitFile(QTextStream* pcInputStream, ComSequence* pcSequence)
+bool BitParser::parseSCUBitFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
 {
     Q_ASSERT( pcSequence != NULL );
 
-    QString strOneLine;
-    QRegExp cMatchTarget;
-
-
     /// <0,8> 8 36 31 36 30 36 31 36 0 36 2 36 1 36 0 36 1 36
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-    QTextStream cSCUBitInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-
-            ///
-            QString strSCUBitInfo = cMatchTarget.cap(3);
-            cSCUBitInfoStream.setString( &strSCUBitInfo, QIODevice::ReadOnly );
-            xParseSCUBitFile(&cSCUBitInfoStream, pcLCU);
-
+            qCritical() << "BitParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        xParseSCUBitFile(pcTokenizer, pcLCU);
     }
     return true;
 }
 
 
-bool BitParser::xParseSCUBitFile(QTextStream* pcSCUBitInfoStream, ComCU* pcCU)
+bool BitParser::xParseSCUBitFile(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     if( !pcCU->getSCUs().empty() )
     {
         /// non-leaf node : recursive reading for children
-        xParseSCUBitFile(pcSCUBitInfoStream, pcCU->getSCUs().at(0));
-        xParseSCUBitFile(pcSCUBitInfoStream, pcCU->getSCUs().at(1));
-        xParseSCUBitFile(pcSCUBitInfoStream, pcCU->getSCUs().at(2));
-        xParseSCUBitFile(pcSCUBitInfoStream, pcCU->getSCUs().at(3));
+        xParseSCUBitFile(pcTokenizer, pcCU->getSCUs().at(0));
+        xParseSCUBitFile(pcTokenizer, pcCU->getSCUs().at(1));
+        xParseSCUBitFile(pcTokenizer, pcCU->getSCUs().at(2));
+        xParseSCUBitFile(pcTokenizer, pcCU->getSCUs().at(3));
     }
     else
     {
         /// leaf node : read data
-        Q_ASSERT(pcSCUBitInfoStream->atEnd()==false);
         int iSCUBit;
-        *pcSCUBitInfoStream >> iSCUBit;
+        if( !pcTokenizer->readInt(iSCUBit) )
+            return false;
         pcCU->setBitCount(iSCUBit);
     }
     return true;
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 class BitParser : public QObject
 {
     Q_OBJECT
@@ -11,9 +12,11 @@ public:
     explicit BitParser(QObject *parent = 0);
     bool parseLCUBitFile(QTextStream* pcInputStream, ComSequence* pcSequence);
     bool parseSCUBitFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseLCUBitFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
+    bool parseSCUBitFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 
 protected:
-    bool xParseSCUBitFile(QTextStream* pcSCUBitInfoStream, ComCU* pcCU);
+    bool xParseSCUBitFile(IntTokenizer* pcTokenizer, ComCU* pcCU);
 signals:
     
 public slots:
@@ -1,4 +1,6 @@
 #include "bitstreamparser.h"
+#include "parsers/growingfilereader.h"
+#include "parsers/annexbrangereader.h"
 #include "../views/bitstreamversionselector.h"
 #include "exceptions/decodernotfoundexception.h"
 #include "exceptions/bitstreamnotfoundexception.h"
@@ -8,11 +10,37 @@
 #include <QFileInfo>
 #include <QDebug>
 #include <QApplication>
+#include <cstdlib>
+#include <cstring>
+
+#define DECODER_PROGRESS_INTERVAL 100   ///< ms, shortest time between two progress events
+#define DEMUX_PIPE_BUFFER   (4 << 20)   ///< bytes of demuxed access units waiting for the decoder at most
+#define FOLLOW_POLL_INTERVAL 200        ///< ms, between two looks at a followed file without new data
 
 BitstreamParser::BitstreamParser(QObject *parent):
     m_cDecoderProcess(this)
 {
+    m_pcShmReader = NULL;
+    m_bUseShm = false;
+    m_bCacheShmToDisk = false;
+    m_bTakeShmRecords = false;
+    m_iAnalysisFirstPOC = 0;
+    m_iAnalysisLastPOC = -1;
+    m_bPreScan = false;
+    m_bFollow = false;
+    m_iRangeStart = 0;
+    m_iRangeEnd = -1;
+    m_pcDemuxer = NULL;
+    m_iDemuxProgress = -1;
+    m_iDecodedFrames = 0;
+    m_iLastPOC = -1;
+    m_iExpectedFrames = -1;
+    m_iReportedFrames = 0;
     connect(&m_cDecoderProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(displayDecoderOutput()));
+    connect(&m_cDecoderProcess, SIGNAL(bytesWritten(qint64)), this, SLOT(feedDecoder()));
+    m_cFollowTimer.setSingleShot(true);
+    m_cFollowTimer.setInterval(FOLLOW_POLL_INTERVAL);
+    connect(&m_cFollowTimer, SIGNAL(timeout()), this, SLOT(feedDecoder()));
     connect(qApp, SIGNAL(aboutToQuit()), &m_cDecoderProcess, SLOT(kill()));
     //connect
 }
@@ -21,6 +49,22 @@ BitstreamParser::~BitstreamParser()
 {
     m_cDecoderProcess.kill();
     //m_cDecoderProcess.waitForFinished();
+    delete m_pcShmReader;
+    delete m_pcDemuxer;
+}
+
+void BitstreamParser::setSharedMemoryTransport(bool bEnable, bool bCacheToDisk, bool bTakeRecords)
+{
+    m_bUseShm = bEnable;
+    m_bCacheShmToDisk = bCacheToDisk;
+    m_bTakeShmRecords = bTakeRecords;
+}
+
+void BitstreamParser::setAnalysisSelection(const QString& strCategories, int iFirstPOC, int iLastPOC)
+{
+    m_strAnalysisCategories = strCategories;
+    m_iAnalysisFirstPOC = iFirstPOC;
+    m_iAnalysisLastPOC = iLastPOC;
 }
 
 
@@ -28,7 +72,24 @@ bool BitstreamParser::parseFile(QString strDecoderFolder,
                                 int iEncoderVersion,
                                 QString strBitstreamFilePath,
                                 QString strOutputPath,
-                                ComSequence* pcSequence)
+                                ComSequence* pcSequence,
+                                bool bBinaryAnalysis)
+{
+    startDecoding(strDecoderFolder, iEncoderVersion, strBitstreamFilePath, strOutputPath, bBinaryAnalysis);
+
+    /// wait for end/cancel
+    waitForDecoding(-1);
+
+    pcSequence->setDecodingFolder(strOutputPath);
+
+    return isDecodingSuccessful();
+}
+
+bool BitstreamParser::startDecoding(QString strDecoderFolder,
+                                    int iEncoderVersion,
+                                    QString strBitstreamFilePath,
+                                    QString strOutputPath,
+                                    bool bBinaryAnalysis)
 {
     QDir cCurDir = QDir::current();
     /// check if decoder exist
@@ -75,12 +136,80 @@ bool BitstreamParser::parseFile(QString strDecoderFolder,
         throw BitstreamNotFoundException();
     }
 
+    /// TS, MP4, a followed file or a range: the HM decoder reads the access units from stdin ("-b -", HM-10.0 and later)
+    bool bHMDecoder = ( iEncoderVersion == HM40 || iEncoderVersion == HM52 ||
+                        iEncoderVersion == HM100 || iEncoderVersion == HM120 );
+    delete m_pcDemuxer;
+    m_pcDemuxer = NULL;
+    m_iDemuxProgress = -1;
+    if( m_bFollow && ContainerDemuxer::isContainer(strBitstreamFilePath) )
+    {
+        qCritical() << "Only raw Annex-B files can be followed while they grow";
+        throw BitstreamNotFoundException();
+    }
+    if( m_bFollow )
+        m_pcDemuxer = new GrowingFileReader();
+    else if( m_iRangeEnd >= 0 && bHMDecoder )
+        m_pcDemuxer = new AnnexBRangeReader(m_iRangeStart, m_iRangeEnd, m_cRangeParamSets);
+    else if( bHMDecoder )
+        m_pcDemuxer = ContainerDemuxer::create(strBitstreamFilePath);
+    if( m_pcDemuxer != NULL && iEncoderVersion != HM100 && iEncoderVersion != HM120 )
+    {
+        qCritical() << "TS and MP4 files (growing files and bitstream ranges) can only be decoded by HM-10.0 and later";
+        delete m_pcDemuxer;
+        m_pcDemuxer = NULL;
+        throw BitstreamNotFoundException();
+    }
+    if( m_pcDemuxer != NULL )
+    {
+        if( !m_pcDemuxer->open(strBitstreamFilePath) )
+        {
+            delete m_pcDemuxer;
+            m_pcDemuxer = NULL;
+            throw BitstreamNotFoundException();
+        }
+        m_iDemuxProgress = 0;
+    }
+
     /// check if output folder exist
     if( !cCurDir.exists(strOutputPath) )
     {
         cCurDir.mkpath(strOutputPath);
     }
 
+    /// remove stale binary analysis output and LCU index, so the parsers never mix them with a new decoding
+    QDir(strOutputPath).remove("decoder_analysis.bin");
+    QDir(strOutputPath).remove("decoder_lcu_index.bin");
+
+    /// shared memory transport (HM only), the reader must exist before the decoder attaches
+    delete m_pcShmReader;
+    m_pcShmReader = NULL;
+    if( m_bUseShm && bHMDecoder && !m_bPreScan && ShmRingReader::isSupported() )
+    {
+        /// per-LCU files of a previous decoding in this folder would be taken for a cache
+        QDir cOutputDir(strOutputPath);
+        foreach(const QString& strStaleFile, cOutputDir.entryList(QStringList() << "decoder_*.txt", QDir::Files))
+            cOutputDir.remove(strStaleFile);
+
+        m_pcShmReader = new ShmRingReader();
+        if( m_pcShmReader->create(strOutputPath, m_bTakeShmRecords, m_bCacheShmToDisk) )
+        {
+            m_pcShmReader->start();
+        }
+        else
+        {
+            qWarning() << "Shared memory transport not available, use files";
+            delete m_pcShmReader;
+            m_pcShmReader = NULL;
+        }
+    }
+
+    m_iDecodedFrames = 0;
+    m_iLastPOC = -1;
+    m_iReportedFrames = 0;
+    m_cLineTail.clear();
+    m_cDecodingTimer.start();
+    m_cProgressTimer.start();
     m_cDecoderProcess.setWorkingDirectory(strOutputPath);
     QString strStandardOutputFile = strOutputPath+"/decoder_general.txt";
     m_cStdOutputFile.setFileName(strStandardOutputFile);
@@ -90,6 +219,8 @@ bool BitstreamParser::parseFile(QString strDecoderFolder,
     strDecoderPath = QDir::toNativeSeparators(strDecoderPath);
     /// convert to native path
     strBitstreamFilePath = QDir::toNativeSeparators(strBitstreamFilePath);
+    if( m_pcDemuxer != NULL )
+        strBitstreamFilePath = "-";
 
     QString strDecoderCmd;
 
@@ -99,7 +230,23 @@ bool BitstreamParser::parseFile(QString strDecoderFolder,
         case HM52:
         case HM100:
         case HM120:
+            /// slice headers only, no YUV and no per-LCU info
+            if( m_bPreScan && (iEncoderVersion == HM100 || iEncoderVersion == HM120) )
+            {
+                strDecoderCmd = QString("\"%1\" -b \"%2\" --PreScan=1").arg(strDecoderPath).arg(strBitstreamFilePath);
+                break;
+            }
             strDecoderCmd = QString("\"%1\" -b \"%2\" -o decoder_yuv.yuv").arg(strDecoderPath).arg(strBitstreamFilePath);
+            /// analysis info in shared memory, or in binary container (decoder_analysis.bin) instead of text files
+            if( m_pcShmReader != NULL )
+                strDecoderCmd += QString(" --AnalysisOutputFormat=2 --AnalysisShmName=%1").arg(m_pcShmReader->getName());
+            else if( bBinaryAnalysis )
+                strDecoderCmd += " --AnalysisOutputFormat=1";
+            /// only the categories and pictures asked for
+            if( !m_strAnalysisCategories.isEmpty() )
+                strDecoderCmd += QString(" --AnalysisCategories=%1").arg(m_strAnalysisCategories);
+            if( m_iAnalysisFirstPOC != 0 || m_iAnalysisLastPOC >= 0 )
+                strDecoderCmd += QString(" --AnalysisFirstPOC=%1 --AnalysisLastPOC=%2").arg(m_iAnalysisFirstPOC).arg(m_iAnalysisLastPOC);
             break;
         case AV1:
             strDecoderCmd = QString("\"%1\" --i420 \"%2\" -o decoder_yuv.yuv").arg(strDecoderPath).arg(strBitstreamFilePath);
@@ -111,40 +258,145 @@ bool BitstreamParser::parseFile(QString strDecoderFolder,
     qDebug() << strDecoderCmd;
 
     m_cDecoderProcess.start(strDecoderCmd);
-    /// wait for end/cancel
-    m_cDecoderProcess.waitForFinished(-1);
+    feedDecoder();
+    return true;
+}
 
-    m_cStdOutputFile.close();
+bool BitstreamParser::waitForDecoding(int iMsecs)
+{
+    if( m_cDecoderProcess.state() != QProcess::NotRunning )
+        m_cDecoderProcess.waitForFinished(iMsecs);
+    if( m_cDecoderProcess.state() != QProcess::NotRunning )
+        return false;
 
-    pcSequence->setDecodingFolder(strOutputPath);
+    /// decoder exited, write out the rest of its output
+    if( m_cStdOutputFile.isOpen() )
+    {
+        displayDecoderOutput();
+        xCountPOCLine(m_cLineTail.constData(), m_cLineTail.constData() + m_cLineTail.size());
+        m_cLineTail.clear();
+        xReportProgress(true);
+        m_cStdOutputFile.close();
+    }
+    if( m_pcShmReader != NULL )
+        m_pcShmReader->finish();
+    return true;
+}
 
-    return (m_cDecoderProcess.exitCode() == 0);
+bool BitstreamParser::isDecodingSuccessful() const
+{
+    return m_cDecoderProcess.exitStatus() == QProcess::NormalExit &&
+           m_cDecoderProcess.exitCode() == 0;
+}
+
+void BitstreamParser::cancel()
+{
+    if( m_cDecoderProcess.state() != QProcess::NotRunning )
+        m_cDecoderProcess.kill();
 }
 
 void BitstreamParser::displayDecoderOutput()
 {
+    /// raw bytes to the file, nothing is decoded or re-encoded
+    QByteArray cData = m_cDecoderProcess.readAllStandardOutput();
+    if( !cData.isEmpty() )
+    {
+        m_cStdOutputFile.write(cData);
 
+        /// count the POC lines (the last line may not be complete yet)
+        m_cLineTail += cData;
+        const char* pchData = m_cLineTail.constData();
+        const char* pchEnd = pchData + m_cLineTail.size();
+        const char* pchLine = pchData;
+        const char* pchLineEnd;
+        while( (pchLineEnd = (const char*)memchr(pchLine, '\n', pchEnd-pchLine)) != NULL )
+        {
+            xCountPOCLine(pchLine, pchLineEnd);
+            pchLine = pchLineEnd + 1;
+        }
+        m_cLineTail.remove(0, pchLine - pchData);
+    }
+    xReportProgress(false);
+}
 
+void BitstreamParser::feedDecoder()
+{
+    if( m_pcDemuxer == NULL )
+        return;
 
-    while( m_cDecoderProcess.canReadLine() )
+    /// a few access units ahead of the decoder, the rest stays in the file
+    while( m_cDecoderProcess.bytesToWrite() < DEMUX_PIPE_BUFFER )
     {
-        // write to file
-        QString strLine = m_cDecoderProcess.readLine();
-        m_cStdOutputFile.write(strLine.toStdString().c_str());
+        QByteArray cAccessUnit;
+        if( !m_pcDemuxer->readAccessUnit(cAccessUnit) )
+        {
+            /// a followed file has no end yet, look for new data later
+            if( m_pcDemuxer->isWaiting() )
+            {
+                if( m_cDecoderProcess.state() != QProcess::NotRunning && !m_cFollowTimer.isActive() )
+                    m_cFollowTimer.start();
+                return;
+            }
+            /// end of the bitstream for the decoder once the pipe is drained
+            m_iDemuxProgress = 100;
+            m_cDecoderProcess.closeWriteChannel();
+            delete m_pcDemuxer;
+            m_pcDemuxer = NULL;
+            return;
+        }
+        m_cDecoderProcess.write(cAccessUnit);
+        m_iDemuxProgress = m_pcDemuxer->getSize() > 0 ?
+                           int(m_pcDemuxer->getBytesRead() * 100 / m_pcDemuxer->getSize()) : -1;
+    }
+}
+
+void BitstreamParser::stopFollowing()
+{
+    if( !m_bFollow || m_pcDemuxer == NULL )
+        return;
+    static_cast<GrowingFileReader*>(m_pcDemuxer)->stopFollowing();
+    m_cFollowTimer.stop();
+    feedDecoder();
+}
+
+void BitstreamParser::xCountPOCLine(const char* pchLine, const char* pchLineEnd)
+{
+    // POC   18 TId: 0 ( B-SLICE, QP 33 ) [DT  0.005] ...
+    while( pchLine < pchLineEnd && (*pchLine == ' ' || *pchLine == '\t') )
+        pchLine++;
+    if( pchLineEnd - pchLine < 4 || strncmp(pchLine, "POC", 3) != 0 )
+        return;
+    m_iLastPOC = (int)strtol(pchLine+3, NULL, 10);
+    m_iDecodedFrames++;
+}
 
+void BitstreamParser::xReportProgress(bool bFinished)
+{
+    if( !bFinished && m_cProgressTimer.elapsed() < DECODER_PROGRESS_INTERVAL )
+        return;
+    if( !bFinished && m_iDecodedFrames == m_iReportedFrames )
+        return;
+    m_cProgressTimer.restart();
+    m_iReportedFrames = m_iDecodedFrames;
 
-        // display progress text as event
-        QRegExp cMatchTarget;
-        cMatchTarget.setPattern("POC *(-?[0-9]+)");
+    /// the streaming parser follows the file, it sees the output at the same pace as the UI
+    m_cStdOutputFile.flush();
 
-        if( cMatchTarget.indexIn(strLine) != -1 )
-        {
-            GitlUpdateUIEvt evt;
-            int iPoc = cMatchTarget.cap(1).toInt();
-            QString strText = QString("POC %1 Decoded").arg(iPoc);
-            evt.setParameter("decoding_progress", strText);
-            dispatchEvt(evt);
-        }
+    double dSeconds = m_cDecodingTimer.elapsed() / 1000.0;
+    double dFps = dSeconds > 0 ? m_iDecodedFrames / dSeconds : 0;
+    QString strText = QString("POC %1 Decoded, %2 Frames, %3 fps").arg(m_iLastPOC).arg(m_iDecodedFrames).arg(dFps, 0, 'f', 1);
+    int iETA = -1;
+    if( m_iExpectedFrames > 0 && dFps > 0 )
+    {
+        iETA = qMax(0, qRound((m_iExpectedFrames - m_iDecodedFrames) / dFps));
+        strText += QString(", %1 s Left").arg(iETA);
     }
 
+    GitlUpdateUIEvt evt;
+    evt.setParameter("decoding_progress", strText);
+    evt.setParameter("decoded_frames", m_iDecodedFrames);
+    evt.setParameter("decoding_last_poc", m_iLastPOC);
+    evt.setParameter("decoding_fps", dFps);
+    evt.setParameter("decoding_eta", iETA);
+    dispatchEvt(evt);
 }
@@ -4,27 +4,123 @@
 #include <QObject>
 #include <QProcess>
 #include <QFile>
+#include <QElapsedTimer>
+#include <QTimer>
 #include "gitlmodual.h"
 #include "model/common/comsequence.h"
+#include "parsers/shmringreader.h"
+#include "parsers/containerdemuxer.h"
 class BitstreamParser : public QObject, public GitlModual
 {
     Q_OBJECT
 public:
     explicit BitstreamParser(QObject *parent = 0);
     ~BitstreamParser();
+    /// \param bBinaryAnalysis see startDecoding()
     bool parseFile(QString strDecoderFolder,
                    int iEncoderVersion,
                    QString strBitstreamFilePath,
                    QString strTempOutputPath,
-                   ComSequence* pcSequence);
+                   ComSequence* pcSequence,
+                   bool bBinaryAnalysis);
+
+    /*!
+     * \brief startDecoding start the decoder and return at once (used by the streaming open)
+     * a TS or MP4 file is demuxed (see ContainerDemuxer) and written into the stdin of an HM decoder,
+     * no elementary stream file is written
+     * \param bBinaryAnalysis ask HM for decoder_analysis.bin instead of the per-LCU txt files
+     *        (parsed at once, only the txt files can be indexed for the lazy LCU loading)
+     */
+    bool startDecoding(QString strDecoderFolder,
+                       int iEncoderVersion,
+                       QString strBitstreamFilePath,
+                       QString strOutputPath,
+                       bool bBinaryAnalysis);
+    /// process decoder output for at most iMsecs, return true if the decoder has exited
+    bool waitForDecoding(int iMsecs);
+    /// decoder exited normally
+    bool isDecodingSuccessful() const;
+    /// kill the decoder
+    void cancel();
+
+    /*!
+     * \brief setSharedMemoryTransport receive the per-LCU records and the reconstructed pictures
+     * through shared memory instead of files (HM decoders on POSIX systems only), call it before startDecoding
+     * \param bCacheToDisk still write the decoder_*.txt files, so the folder can be reopened without decoding
+     * \param bTakeRecords the records are taken from getShmReader() while decoding (streaming), otherwise they
+     * are always written to the decoder_*.txt files and parsed from there
+     */
+    void setSharedMemoryTransport(bool bEnable, bool bCacheToDisk, bool bTakeRecords = false);
+    /// reader of the current decoding, NULL if the files are used
+    ShmRingReader* getShmReader() { return m_pcShmReader; }
+
+    /*!
+     * \brief setAnalysisSelection have HM write only some per-LCU categories, for the pictures of a POC window only
+     * (the parsers take the missing categories and frames as not analyzed), call it before startDecoding
+     * \param strCategories comma separated TSysuAnalyzerOutput category names (cupu,tu,pred,...), empty for all
+     * \param iLastPOC -1 for no upper limit, 0 and -1 record every picture
+     */
+    void setAnalysisSelection(const QString& strCategories, int iFirstPOC, int iLastPOC);
+
+    /*!
+     * \brief setPreScan have HM parse the parameter sets and slice headers only (HM-10.0 and later):
+     * the POC lines with the picture bits are written, no picture is reconstructed and no per-LCU info is recorded,
+     * call it before startDecoding
+     */
+    void setPreScan(bool bPreScan) { m_bPreScan = bPreScan; }
+
+    /*!
+     * \brief setFollow follow an Annex-B file which is still growing (HM-10.0 and later, see GrowingFileReader):
+     * new bytes are written into the decoder's stdin as they show up, the decoder runs until stopFollowing(),
+     * call it before startDecoding
+     */
+    void setFollow(bool bFollow) { m_bFollow = bFollow; }
+
+    /*!
+     * \brief setBitstreamRange decode bytes [iStart, iEnd) of an Annex-B file only, preceded by rcParamSets
+     * (HM-10.0 and later, see AnnexBRangeReader): they are written into the decoder's stdin, no range file is written.
+     * iEnd < 0 for the whole file, call it before startDecoding
+     */
+    void setBitstreamRange(qint64 iStart, qint64 iEnd, const QByteArray& rcParamSets)
+    { m_iRangeStart = iStart; m_iRangeEnd = iEnd; m_cRangeParamSets = rcParamSets; }
+    /// the followed file is complete, the decoder gets the rest of it and exits
+    void stopFollowing();
 
     ADD_CLASS_FIELD_PRIVATE(QProcess, cDecoderProcess)  ///< HM Decoder Process
     ADD_CLASS_FIELD_PRIVATE(QFile, cStdOutputFile)      ///< HM Decoder Standard Output File
+    ADD_CLASS_FIELD_PRIVATE(ShmRingReader*, pcShmReader) ///< shared memory transport, owned
+    ADD_CLASS_FIELD_PRIVATE(bool, bUseShm)
+    ADD_CLASS_FIELD_PRIVATE(bool, bCacheShmToDisk)
+    ADD_CLASS_FIELD_PRIVATE(bool, bTakeShmRecords)
+    ADD_CLASS_FIELD_PRIVATE(QString, strAnalysisCategories)
+    ADD_CLASS_FIELD_PRIVATE(int, iAnalysisFirstPOC)
+    ADD_CLASS_FIELD_PRIVATE(int, iAnalysisLastPOC)
+    ADD_CLASS_FIELD_PRIVATE(bool, bPreScan)
+    ADD_CLASS_FIELD_PRIVATE(bool, bFollow)
+    ADD_CLASS_FIELD_PRIVATE(QTimer, cFollowTimer)     ///< polls the followed file for new data
+    ADD_CLASS_FIELD_PRIVATE(qint64, iRangeStart)
+    ADD_CLASS_FIELD_PRIVATE(qint64, iRangeEnd)        ///< -1 for the whole file
+    ADD_CLASS_FIELD_PRIVATE(QByteArray, cRangeParamSets)
+    ADD_CLASS_FIELD_PRIVATE(ContainerDemuxer*, pcDemuxer)    ///< owned, NULL for Annex-B or once every access unit is written
+    ADD_CLASS_FIELD_NOSETTER(int, iDecodedFrames, getDecodedFrames)     ///< POC lines written by the decoder so far
+    ADD_CLASS_FIELD_NOSETTER(int, iLastPOC, getLastPOC)                 ///< POC of the last of them
+    ADD_CLASS_FIELD(int, iExpectedFrames, getExpectedFrames, setExpectedFrames)    ///< frames in the bitstream for the ETA, -1 if unknown
+    ADD_CLASS_FIELD_NOSETTER(int, iDemuxProgress, getDemuxProgress)     ///< percent of the container file written to the decoder, -1 for Annex-B
 signals:
 
 public slots:
     void displayDecoderOutput();                        ///< HM Decoder Output
+    void feedDecoder();                                 ///< next access units of the container (or new data of the followed file) into the decoder's stdin
+
+protected:
+    void xCountPOCLine(const char* pchLine, const char* pchLineEnd);
+    /// progress event, at most one per DECODER_PROGRESS_INTERVAL unless bFinished
+    void xReportProgress(bool bFinished);
 
+    QByteArray m_cLineTail;                             ///< stdout after the last complete line
+    int m_iReportedFrames;
+    QElapsedTimer m_cDecodingTimer;
+    QElapsedTimer m_cProgressTimer;
 };
 
 #endif // BITSTREAMPARSER_H
@@ -0,0 +1,50 @@
+#include "containerdemuxer.h"
+#include "parsers/tsdemuxer.h"
+#include "parsers/mp4demuxer.h"
+#include <QDebug>
+
+enum ContainerFormat
+{
+    CONTAINER_NONE,
+    CONTAINER_TS,
+    CONTAINER_MP4
+};
+
+static ContainerFormat xProbe(const QString& strFilePath)
+{
+    QFile cFile(strFilePath);
+    if( !cFile.open(QIODevice::ReadOnly) )
+        return CONTAINER_NONE;
+    QByteArray cHead = cFile.read(TS_PACKET_SIZE_M2TS*2);
+
+    /// MP4: the first box is an ftyp box (or a moov/free/mdat box of files without one)
+    if( cHead.size() >= 8 )
+    {
+        QByteArray cType = cHead.mid(4, 4);
+        if( cType == "ftyp" || cType == "moov" || cType == "free" || cType == "mdat" || cType == "styp" )
+            return CONTAINER_MP4;
+    }
+
+    /// TS: a sync byte at the start of two packets
+    if( TSDemuxer::findPacketSize((const uchar*)cHead.constData(), cHead.size()) > 0 )
+        return CONTAINER_TS;
+    return CONTAINER_NONE;
+}
+
+ContainerDemuxer* ContainerDemuxer::create(const QString& strFilePath)
+{
+    switch( xProbe(strFilePath) )
+    {
+        case CONTAINER_TS:
+            return new TSDemuxer();
+        case CONTAINER_MP4:
+            return new MP4Demuxer();
+        default:
+            return NULL;
+    }
+}
+
+bool ContainerDemuxer::isContainer(const QString& strFilePath)
+{
+    return xProbe(strFilePath) != CONTAINER_NONE;
+}
@@ -0,0 +1,46 @@
+#ifndef CONTAINERDEMUXER_H
+#define CONTAINERDEMUXER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+#include "gitldef.h"
+
+/*!
+ * \brief The ContainerDemuxer class
+ * reads the HEVC video track of a container file (MPEG-TS or MP4) access unit by access unit,
+ * each one as Annex-B NAL units with start codes, so it can be written into the decoder's stdin
+ * (see BitstreamParser) and no elementary stream file is extracted first.
+ * Only the first HEVC track is read, anything else in the file is skipped.
+ */
+
+class ContainerDemuxer
+{
+public:
+    virtual ~ContainerDemuxer() {}
+
+    /// a demuxer for the container format of the file (by its first bytes), NULL for raw Annex-B and unknown files
+    static ContainerDemuxer* create(const QString& strFilePath);
+    static bool isContainer(const QString& strFilePath);
+
+    /// find the HEVC track, false if the file has none
+    virtual bool open(const QString& strFilePath) = 0;
+
+    /// append the next access unit to rcAnnexB, false at the end of the track
+    virtual bool readAccessUnit(QByteArray& rcAnnexB) = 0;
+
+    /// no access unit now, but more may come later (see GrowingFileReader)
+    virtual bool isWaiting() const { return false; }
+
+    /// bytes of the container file, for the progress
+    qint64 getSize() const { return m_cFile.size(); }
+
+    ADD_CLASS_FIELD_NOSETTER(qint64, iBytesRead, getBytesRead)      ///< of the container file, up to the last access unit
+
+protected:
+    ContainerDemuxer() : m_iBytesRead(0) {}
+
+    QFile m_cFile;
+};
+
+#endif // CONTAINERDEMUXER_H
@@ -1,6 +1,5 @@
 #include "cupuparser.h"
 #include <QTextStream>
-#include <QRegExp>
 #include <QtAlgorithms>
 #include <QDebug>
 #define CU_SLIPT_FLAG 99      ///< CU splitting flag in file
@@ -18,6 +17,14 @@ CUPUParser::CUPUParser(QObject *parent) :
 
 
 bool CUPUParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
+{
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
+
+
+bool CUPUParser::parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
 {
     Q_ASSERT( pcSequence != NULL );
 
@@ -26,81 +33,77 @@ bool CUPUParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
     int iMaxCUSize = pcSequence->getMaxCUSize();
     int iCUOneRow = (iSeqWidth+iMaxCUSize-1)/iMaxCUSize;
 
-    ////
-    QString strOneLine;
-    QRegExp cMatchTarget;
-
 
     /// <1,1> 99 0 0 5 0
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
     int iLCUSize = pcSequence->getMaxCUSize();
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*) ");
-    QTextStream cCUInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( iLastPOC != iPoc && pcFrame != NULL )
         {
-
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = new ComCU(pcFrame);
-            pcLCU->setAddr(iAddr);
-            pcLCU->setFrame(pcFrame);
-            pcLCU->setDepth(0);
-            pcLCU->setZorder(0);
-            pcLCU->setSize(iLCUSize);
-            int iPixelX = (pcLCU->getAddr()%iCUOneRow)*iMaxCUSize;
-            int iPixelY = (pcLCU->getAddr()/iCUOneRow)*iMaxCUSize;
-            pcLCU->setX(iPixelX);
-            pcLCU->setY(iPixelY);
-
-            /// recursively parse the CU&PU quard-tree structure
-            QString strCUInfo = cMatchTarget.cap(3);
-            cCUInfoStream.setString( &strCUInfo, QIODevice::ReadOnly );
-            if( xReadInCUMode( &cCUInfoStream, pcLCU ) == false )
-                return false;
-            pcFrame->getLCUs().push_back(pcLCU);
-        }        
-
-        /// sort LCU in ascendning order
-        qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(), xCUSortingOrder);
-
+            /// sort LCU of the finished frame in ascending order
+            qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(), xCUSortingOrder);
+        }
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
+        {
+            qCritical() << "CUPUParser Error! No frame of POC" << iPoc;
+            return false;
+        }
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getArena().newCUs(pcFrame, 1);
+        pcLCU->setAddr(iAddr);
+        pcLCU->setFrame(pcFrame);
+        pcLCU->setDepth(0);
+        pcLCU->setZorder(0);
+        pcLCU->setSize(iLCUSize);
+        int iPixelX = (pcLCU->getAddr()%iCUOneRow)*iMaxCUSize;
+        int iPixelY = (pcLCU->getAddr()/iCUOneRow)*iMaxCUSize;
+        pcLCU->setX(iPixelX);
+        pcLCU->setY(iPixelY);
+
+        /// recursively parse the CU&PU quard-tree structure
+        if( xReadInCUMode( pcTokenizer, pcLCU ) == false )
+            return false;
+        pcFrame->getLCUs().push_back(pcLCU);
     }
 
+    /// sort LCU in ascendning order
+    if( pcFrame != NULL )
+        qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(), xCUSortingOrder);
 
     return true;
 }
 
 
 
-bool CUPUParser::xReadInCUMode(QTextStream* pcCUInfoStream, ComCU* pcCU)
+bool CUPUParser::xReadInCUMode(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     int iCUMode;
-    if( pcCUInfoStream->atEnd() )
+    if( !pcTokenizer->readInt(iCUMode) )
     {
         qCritical() << "CUPUParser Error! Illegal CU/PU Mode!";
         return false;
     }
-    *pcCUInfoStream >> iCUMode;
 
     if( iCUMode == CU_SLIPT_FLAG )
     {
         int iMaxDepth = pcCU->getFrame()->getSequence()->getMaxCUDepth();
         int iTotalNumPart = 1 << ( (iMaxDepth-pcCU->getDepth()) << 1 );
         /// non-leaf node : add 4 children CUs
+        ComCU* pcChildren = pcCU->getFrame()->getArena().newCUs(pcCU->getFrame(), 4);
+        pcCU->setSCUs(pcChildren, 4);
         for(int i = 0; i < 4; i++)
         {
-            ComCU* pcChildNode = new ComCU(pcCU->getFrame());
+            ComCU* pcChildNode = &pcChildren[i];
             pcChildNode->setAddr(pcCU->getAddr());
             pcChildNode->setDepth(pcCU->getDepth()+1);
             pcChildNode->setZorder( pcCU->getZorder() + (iTotalNumPart/4)*i );
@@ -109,8 +112,7 @@ bool CUPUParser::xReadInCUMode(QTextStream* pcCUInfoStream, ComCU* pcCU)
             int iSubCUY = pcCU->getY() + i/2 * (pcCU->getSize()/2);
             pcChildNode->setX(iSubCUX);
             pcChildNode->setY(iSubCUY);
-            pcCU->getSCUs().push_back(pcChildNode);
-            xReadInCUMode(pcCUInfoStream, pcChildNode);
+            xReadInCUMode(pcTokenizer, pcChildNode);
         }
     }
     else
@@ -119,9 +121,11 @@ bool CUPUParser::xReadInCUMode(QTextStream* pcCUInfoStream, ComCU* pcCU)
         pcCU->setPartSize((PartSize)iCUMode);
 
         int iPUCount = ComCU::getPUNum((PartSize)iCUMode);
+        ComPU* pcPUs = pcCU->getFrame()->getArena().newPUs(pcCU, iPUCount);
+        pcCU->setPUs(pcPUs, iPUCount);
         for(int i = 0; i < iPUCount; i++)
         {
-            ComPU* pcPU = new ComPU(pcCU);
+            ComPU* pcPU = &pcPUs[i];
             int iPUOffsetX, iPUOffsetY, iPUWidth, iPUHeight;
             ComCU::getPUOffsetAndSize(pcCU->getSize(), (PartSize)iCUMode, i, iPUOffsetX, iPUOffsetY, iPUWidth, iPUHeight);
             int iPUX = pcCU->getX() + iPUOffsetX;
@@ -130,7 +134,6 @@ bool CUPUParser::xReadInCUMode(QTextStream* pcCUInfoStream, ComCU* pcCU)
             pcPU->setY(iPUY);
             pcPU->setWidth(iPUWidth);
             pcPU->setHeight(iPUHeight);
-            pcCU->getPUs().push_back(pcPU);
         }
 
     }
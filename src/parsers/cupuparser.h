@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 //
 /*!
  * \brief The CUPUParser class
@@ -23,8 +24,9 @@ public:
      * \return
      */
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 protected:
-    bool xReadInCUMode(QTextStream* pcCUInfoStream, ComCU *pcCU);
+    bool xReadInCUMode(IntTokenizer* pcTokenizer, ComCU *pcCU);
 signals:
 
 public slots:
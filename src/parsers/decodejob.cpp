@@ -0,0 +1,387 @@
+#include "decodejob.h"
+#include "parsers/decoderoutputparser.h"
+#include "parsers/parallelbitstreamparser.h"
+#include "model/analysiscache.h"
+#include "model/memoryfootprint.h"
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QRunnable>
+#include <QDebug>
+#include <climits>
+
+static int s_iNextJobId = 0;
+
+/// the decoder output of a finished job, parsed while the commands go on
+class OutputParseTask : public QRunnable
+{
+public:
+    OutputParseTask(DecodeJob* pcJob) : m_pcJob(pcJob) { setAutoDelete(true); }
+    void run() { m_pcJob->xParseOutput(); }
+private:
+    DecodeJob* m_pcJob;
+};
+
+DecodeJob::DecodeJob(QObject *parent) :
+    QObject(parent)
+{
+    m_iId = s_iNextJobId++;
+    m_bFinished = false;
+    m_bSuccessful = false;
+    m_bCancelled = false;
+    m_bLazyLCULoading = false;
+    m_pcSequence = NULL;
+    m_iFirstFrame = 0;
+    m_iLastFrame = -1;
+    m_iFirstPicture = 0;
+    m_iPictureNum = 0;
+    m_bCheckpoints = false;
+    m_iSection = 0;
+    m_iEncoderVersion = -1;
+    m_bParsing = false;
+    m_cParsePool.setMaxThreadCount(1);
+#ifdef HM_INPROCESS_DECODER
+    m_bInProcess = false;
+    m_pcInProcess = NULL;
+#endif
+}
+
+DecodeJob::~DecodeJob()
+{
+    /// the decoder is killed by m_cBitstreamParser, a parsing has to end before the sequence goes
+    m_cParsePool.waitForDone();
+#ifdef HM_INPROCESS_DECODER
+    delete m_pcInProcess;                   ///< cancelled, it builds m_pcSequence until it has stopped
+#endif
+    delete m_pcSequence;
+}
+
+bool DecodeJob::start(QString strDecoderFolder,
+                      int iEncoderVersion,
+                      QString strBitstreamFilePath,
+                      QString strOutputPath,
+                      ComSequence* pcSequence)
+{
+    m_strFileName = strBitstreamFilePath;
+    m_strOutputPath = strOutputPath;
+    m_pcSequence = pcSequence;
+    m_strDecoderFolder = strDecoderFolder;
+    m_iEncoderVersion = iEncoderVersion;
+
+    /// pictures are only found in bitstreams of the final HEVC syntax, otherwise the progress is unknown
+    /// (a TS or MP4 file is demuxed into the decoder, its progress is the part of the file demuxed)
+    bool bContainer = ContainerDemuxer::isContainer(strBitstreamFilePath);
+    if( AnnexBIndex::isSupported(iEncoderVersion) && !bContainer && !m_cIndex.open(strBitstreamFilePath, m_strIndexFile) )
+        qWarning() << "Bitstream can not be indexed, decoding progress unknown";
+    m_iFirstPicture = 0;
+    m_iPictureNum = m_cIndex.getPictures().size();
+
+    /// a frame range: the pictures from the cut point on only depend on each other
+    bool bFrameRange = ( m_iFirstFrame > 0 || m_iLastFrame >= 0 );
+    if( bFrameRange )
+    {
+        if( m_cIndex.getPictures().empty() )
+        {
+            qCritical() << "A frame range can only be decoded from Annex-B HEVC bitstreams of HM-10.0 and later";
+            return false;
+        }
+        int iLastFrame = (m_iLastFrame < 0) ? m_iPictureNum-1 : qMin(m_iLastFrame, m_iPictureNum-1);
+        if( m_iFirstFrame > iLastFrame )
+        {
+            qCritical() << "Frames" << m_iFirstFrame << "to" << m_iLastFrame << "are not in the bitstream";
+            return false;
+        }
+        m_iFirstPicture = m_cIndex.findCutPoint(m_iFirstFrame);
+        m_iPictureNum = iLastFrame - m_iFirstPicture + 1;
+        if( !xSetRange(m_cIndex.getPictures()[m_iFirstPicture].iStart, m_cIndex.getPictureEnd(iLastFrame)) )
+            return false;
+        qDebug() << "Decoding frames" << m_iFirstPicture << "to" << iLastFrame;
+    }
+
+    /// the whole bitstream in sections, an earlier job may have decoded some of them
+    if( m_bCheckpoints && !bFrameRange && m_iPictureNum > 0 )
+        xPlanSections();
+    if( !m_aiSections.empty() )
+    {
+        /// the per-LCU records of a section are parsed from the joined files, not kept in shared memory
+        m_cBitstreamParser.setSharedMemoryTransport(false, false);
+        return m_iSection == m_aiSections.size() || xStartSection();
+    }
+
+#ifdef HM_INPROCESS_DECODER
+    if( m_bInProcess && !bFrameRange )
+    {
+        m_pcInProcess = new InProcessDecoder();
+        return m_pcInProcess->startDecoding(strBitstreamFilePath, strOutputPath, pcSequence);
+    }
+#endif
+
+    if( m_iPictureNum > 0 )
+        m_cBitstreamParser.setExpectedFrames(m_iPictureNum);
+
+    /// the binary container is parsed at once, the txt files can be indexed for the lazy LCU loading
+    return m_cBitstreamParser.startDecoding(strDecoderFolder, iEncoderVersion, strBitstreamFilePath, strOutputPath, !m_bLazyLCULoading);
+}
+
+bool DecodeJob::poll(int iMsecs)
+{
+    if( m_bFinished )
+        return true;
+
+    /// the output is being parsed, m_bSuccessful is set when it is done
+    if( m_bParsing )
+    {
+        if( !m_cParsePool.waitForDone(iMsecs) )
+            return false;
+        m_bParsing = false;
+        m_bFinished = true;
+        if( m_bCancelled )
+        {
+            qDebug() << "Decoding cancelled:" << m_strFileName;
+            m_bSuccessful = false;
+        }
+        return true;
+    }
+
+    /// (every section may have been decoded by an earlier job already)
+    bool bDecoded = !m_aiSections.empty() && m_iSection == m_aiSections.size();
+    if( !bDecoded )
+    {
+        if( !xWaitForDecoder(iMsecs) )
+            return false;
+        bDecoded = !m_bCancelled && xIsDecodingSuccessful();
+
+        /// a section is done: record the checkpoint, then decode the next one
+        if( bDecoded && !m_aiSections.empty() )
+        {
+            AnalysisCache::markCheckpoint(m_strOutputPath, ++m_iSection);
+            if( m_iSection < m_aiSections.size() )
+            {
+                if( xStartSection() )
+                    return false;
+                bDecoded = false;
+            }
+        }
+    }
+
+    if( m_bCancelled )
+    {
+        qDebug() << "Decoding cancelled:" << m_strFileName;
+        m_bFinished = true;
+        return true;
+    }
+    if( !bDecoded )
+    {
+        qCritical() << "Bitstream decoding FAILED!" << m_strFileName;
+        m_bFinished = true;
+        return true;
+    }
+
+    /// joining and parsing take as long as the output is big, next_frame or switch_sequence go on meanwhile
+    m_bParsing = true;
+    m_cParsePool.start(new OutputParseTask(this));
+    return false;
+}
+
+void DecodeJob::xParseOutput()
+{
+    /// one decoder output for the whole bitstream
+    if( !m_aiSections.empty() )
+    {
+        QStringList astrFolders;
+        for(int i = 0; i < m_aiSections.size(); i++)
+            astrFolders << xSectionFolder(i);
+        if( !ParallelBitstreamParser::joinOutput(astrFolders, m_strOutputPath, -1) )
+        {
+            qCritical() << "Decoder output of the bitstream sections can not be joined" << m_strOutputPath;
+            return;
+        }
+        foreach(const QString& strFolder, astrFolders)
+            QDir(strFolder).removeRecursively();
+    }
+
+    bool bBuilt = false;
+#ifdef HM_INPROCESS_DECODER
+    /// the sequence was built while decoding, only its frame order is left
+    if( m_pcInProcess != NULL )
+    {
+        m_bSuccessful = m_pcInProcess->finishDecoding();
+        bBuilt = true;
+    }
+#endif
+
+    /// (the shared memory reader has written the per-LCU records to the txt files too)
+    if( !bBuilt )
+    {
+        m_pcSequence->setDecodingFolder(m_strOutputPath);
+        DecoderOutputParser cDecoderOutputParser;
+        cDecoderOutputParser.setLazyLCULoading(m_bLazyLCULoading);
+        cDecoderOutputParser.setStageEvents(false);     ///< the UI is not called from this thread
+        m_bSuccessful = cDecoderOutputParser.parseFolder(m_strOutputPath, m_pcSequence);
+    }
+    if( m_bSuccessful )
+    {
+        m_pcSequence->setDiskBytes(MemoryFootprint::measureDisk(m_strOutputPath));
+        m_pcSequence->getStatistics();
+    }
+
+    /// one POC line per picture given to the decoder, in the same order
+    const QVector<ComFrame*>& rcFrames = m_pcSequence->getFramesInDecOrder();
+    if( m_bSuccessful && rcFrames.size() == m_iPictureNum )
+    {
+        for(int i = 0; i < rcFrames.size(); i++)
+            rcFrames[i]->setNalType(m_cIndex.getPictures()[m_iFirstPicture+i].iNalType);
+    }
+}
+
+void DecodeJob::cancel()
+{
+    if( m_bFinished )
+        return;
+    m_bCancelled = true;
+    /// (the decoder has exited, its output is being parsed)
+    if( m_bParsing )
+        return;
+#ifdef HM_INPROCESS_DECODER
+    if( m_pcInProcess != NULL )
+        m_pcInProcess->cancel();
+#endif
+    m_cBitstreamParser.cancel();
+}
+
+int DecodeJob::getProgress()
+{
+    if( m_bFinished || m_bParsing )
+        return 100;
+    if( m_iPictureNum == 0 )
+        return m_cBitstreamParser.getDemuxProgress();
+    qint64 iFirstByte = m_cIndex.getBytesBefore(m_iFirstPicture);
+    qint64 iDecodedBytes = m_cIndex.getBytesBefore(xDecodedPictures()) - iFirstByte;
+    qint64 iTotalBytes = m_cIndex.getBytesBefore(m_iFirstPicture + m_iPictureNum) - iFirstByte;
+    if( iTotalBytes <= 0 )
+        return -1;
+    return int(iDecodedBytes * 100 / iTotalBytes);
+}
+
+ComSequence* DecodeJob::takeSequence()
+{
+    ComSequence* pcSequence = m_pcSequence;
+    m_pcSequence = NULL;
+    return pcSequence;
+}
+
+/// the sections are joined with the POCs as written, a CRA section would restart its POC MSB at 0
+static bool xIsSectionStart(const AnnexBPicture& rcPicture)
+{
+    return rcPicture.bCutPoint && AnnexBIndex::isPocReset(rcPicture.iNalType);
+}
+
+void DecodeJob::xPlanSections()
+{
+    const QVector<AnnexBPicture>& rcPictures = m_cIndex.getPictures();
+    QVector<qint64> aiOffsets;
+    int iDone = AnalysisCache::readCheckpoints(m_strOutputPath, m_aiSections, aiOffsets);
+
+    /// the sections recorded must start at IDR or BLA pictures of this index, the ones decoded must be on disk
+    /// in the output format of this job (the lazy LCU loading may have been switched since)
+    bool bValid = iDone > 0 && m_aiSections[0] == 0;
+    for(int i = 1; bValid && i < m_aiSections.size(); i++)
+    {
+        int iPicture = m_aiSections[i];
+        bValid = iPicture > m_aiSections[i-1] && iPicture < rcPictures.size() &&
+                 xIsSectionStart(rcPictures[iPicture]) && rcPictures[iPicture].iStart == aiOffsets[i];
+    }
+    for(int i = 0; bValid && i < iDone; i++)
+        bValid = QFile::exists(xSectionFolder(i) + "/decoder_general.txt") &&
+                 QFile::exists(xSectionFolder(i) + "/decoder_analysis.bin") == !m_bLazyLCULoading;
+    if( bValid )
+    {
+        m_iSection = iDone;
+        qDebug() << "Resuming decoding at checkpoint" << iDone << "of" << m_aiSections.size()
+                 << "( frame" << (iDone < m_aiSections.size() ? m_aiSections[iDone] : rcPictures.size()) << ")";
+        return;
+    }
+
+    /// a new plan: every section goes on up to the first IDR or BLA picture DECODE_CHECKPOINT_BYTES after its start
+    m_aiSections.clear();
+    aiOffsets.clear();
+    m_iSection = 0;
+    for(int i = 0; i < rcPictures.size(); i++)
+    {
+        if( i == 0 || (xIsSectionStart(rcPictures[i]) && rcPictures[i].iStart - aiOffsets.back() >= DECODE_CHECKPOINT_BYTES) )
+        {
+            m_aiSections.push_back(i);
+            aiOffsets.push_back(rcPictures[i].iStart);
+        }
+    }
+    /// checkpoints need the manifest of a cache folder, and more than one section
+    if( m_aiSections.size() < 2 || !AnalysisCache::writeCheckpoints(m_strOutputPath, m_aiSections, aiOffsets) )
+        m_aiSections.clear();
+}
+
+bool DecodeJob::xStartSection()
+{
+    const QVector<AnnexBPicture>& rcPictures = m_cIndex.getPictures();
+    int iFirst = m_aiSections[m_iSection];
+    int iEnd = (m_iSection+1 < m_aiSections.size()) ? m_aiSections[m_iSection+1] : rcPictures.size();
+
+    /// a section left by a killed job is decoded again from its start
+    QString strFolder = xSectionFolder(m_iSection);
+    QDir(strFolder).removeRecursively();
+    QDir::current().mkpath(strFolder);
+    qint64 iStart = (m_iSection == 0) ? 0 : rcPictures[iFirst].iStart;
+    if( !xSetRange(iStart, m_cIndex.getPictureEnd(iEnd-1)) )
+        return false;
+    qDebug() << "Decoding section" << m_iSection+1 << "of" << m_aiSections.size() << ", frames" << iFirst << "to" << iEnd-1;
+    m_cBitstreamParser.setExpectedFrames(iEnd - iFirst);
+    return m_cBitstreamParser.startDecoding(m_strDecoderFolder, m_iEncoderVersion, m_strFileName, strFolder, !m_bLazyLCULoading);
+}
+
+bool DecodeJob::xSetRange(qint64 iStart, qint64 iEnd)
+{
+    QFile cBitstreamFile(m_strFileName);
+    QByteArray cParamSets;
+    if( !cBitstreamFile.open(QIODevice::ReadOnly) || !m_cIndex.readParamSets(&cBitstreamFile, iStart, cParamSets) )
+    {
+        qCritical() << "Parameter sets can not be read from" << m_strFileName;
+        return false;
+    }
+    m_cBitstreamParser.setBitstreamRange(iStart, iEnd, cParamSets);
+    return true;
+}
+
+QString DecodeJob::xSectionFolder(int iSection) const
+{
+    return m_strOutputPath + QString("/checkpoint_%1").arg(iSection);
+}
+
+bool DecodeJob::xWaitForDecoder(int iMsecs)
+{
+#ifdef HM_INPROCESS_DECODER
+    if( m_pcInProcess != NULL )
+        return m_pcInProcess->wait(iMsecs < 0 ? ULONG_MAX : (unsigned long)iMsecs);
+#endif
+    return m_cBitstreamParser.waitForDecoding(iMsecs);
+}
+
+bool DecodeJob::xIsDecodingSuccessful() const
+{
+#ifdef HM_INPROCESS_DECODER
+    if( m_pcInProcess != NULL )
+        return m_pcInProcess->isDecodingSuccessful();
+#endif
+    return m_cBitstreamParser.isDecodingSuccessful();
+}
+
+int DecodeJob::xDecodedPictures()
+{
+#ifdef HM_INPROCESS_DECODER
+    if( m_pcInProcess != NULL )
+        return m_iFirstPicture + m_pcInProcess->getDecodedFrames();
+#endif
+    if( m_aiSections.empty() )
+        return m_iFirstPicture + m_cBitstreamParser.getDecodedFrames();
+    if( m_iSection >= m_aiSections.size() )
+        return m_cIndex.getPictures().size();
+    return m_aiSections[m_iSection] + m_cBitstreamParser.getDecodedFrames();
+}
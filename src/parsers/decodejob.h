@@ -0,0 +1,139 @@
+#ifndef DECODEJOB_H
+#define DECODEJOB_H
+
+#include <QObject>
+#include <QThreadPool>
+#include "gitldef.h"
+#include "model/common/comsequence.h"
+#include "parsers/bitstreamparser.h"
+#include "parsers/annexbindex.h"
+#ifdef HM_INPROCESS_DECODER
+#include "parsers/inprocessdecoder.h"
+#endif
+
+#define DECODE_CHECKPOINT_BYTES (64 << 20)      ///< bitstream bytes of a section at least, see DecodeJob::setCheckpoints
+
+/*!
+ * \brief The DecodeJob class
+ * one bitstream decoded in the background: the decoder runs while other commands are executed,
+ * DecodeJobCommand polls it until the decoder has exited, then until the decoder output is parsed into the
+ * sequence on a worker thread (the sequence is handed out only after that, see takeSequence()).
+ * The progress is the part of the bitstream in front of the last decoded picture (HEVC only).
+ * A frame range N..M (decoding order, HEVC only) is decoded from the nearest cut point at or before N
+ * up to M, the rest of the bitstream is not read by the decoder (the range is written into its stdin, see AnnexBRangeReader).
+ * The NAL unit types of the frames come from the index (the decoder does not print them).
+ * With checkpoints a long bitstream is decoded section by section, each one from an IDR or BLA picture into a folder
+ * of its own, and the sections decoded are recorded in the cache manifest (see AnalysisCache): a job killed
+ * on the way is resumed by the next one at the first section not decoded. The outputs are joined at the end.
+ * In process (see setInProcess()) the linked HM library decodes on a thread of InProcessDecoder and builds
+ * the sequence meanwhile, polled and cancelled like the decoder process.
+ * A job is found by its id (see ModelLocator::getDecodeJobs()).
+ */
+
+class DecodeJob : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DecodeJob(QObject *parent = 0);
+    ~DecodeJob();
+
+    /// start the decoder and return at once, pcSequence is owned by the job until takeSequence()
+    bool start(QString strDecoderFolder,
+               int iEncoderVersion,
+               QString strBitstreamFilePath,
+               QString strOutputPath,
+               ComSequence* pcSequence);
+
+    /// see BitstreamParser::setSharedMemoryTransport, call it before start()
+    /// (the records go to the decoder_*.txt files whatever bCacheToDisk, they are parsed from there)
+    void setSharedMemoryTransport(bool bEnable, bool bCacheToDisk)
+    { m_cBitstreamParser.setSharedMemoryTransport(bEnable, bCacheToDisk); }
+
+    /// see BitstreamParser::setAnalysisSelection, call it before start()
+    void setAnalysisSelection(const QString& strCategories, int iFirstPOC, int iLastPOC)
+    { m_cBitstreamParser.setAnalysisSelection(strCategories, iFirstPOC, iLastPOC); }
+
+    /// see BitstreamParser::setPreScan, call it before start()
+    void setPreScan(bool bPreScan) { m_cBitstreamParser.setPreScan(bPreScan); }
+
+    /// frames iFirstFrame..iLastFrame in decoding order (-1 for the last one), call it before start()
+    void setFrameRange(int iFirstFrame, int iLastFrame) { m_iFirstFrame = iFirstFrame; m_iLastFrame = iLastFrame; }
+
+    /*!
+     * \brief setCheckpoints decode the whole bitstream (HEVC only) in sections of about DECODE_CHECKPOINT_BYTES,
+     * resuming after the sections an earlier job recorded in the manifest of the output folder, call it before start()
+     */
+    void setCheckpoints(bool bCheckpoints) { m_bCheckpoints = bCheckpoints; }
+
+#ifdef HM_INPROCESS_DECODER
+    /// decode with the linked HM-12.0 library (see InProcessDecoder) instead of a decoder process,
+    /// the whole bitstream with every category only, call it before start()
+    void setInProcess(bool bInProcess) { m_bInProcess = bInProcess; }
+#endif
+
+    /*!
+     * \brief poll wait for the decoder or the parsing of its output at most iMsecs,
+     * start the parsing once the decoder has exited
+     * \return true if the job is finished (see isSuccessful())
+     */
+    bool poll(int iMsecs);
+
+    /// kill the decoder, the job finishes at the next poll() (a parsing in progress is finished and dropped)
+    void cancel();
+
+    /// percent of the bitstream decoded, -1 if unknown
+    int getProgress();
+
+    /// the sequence of a successful job, the caller owns it
+    ComSequence* takeSequence();
+
+    ADD_CLASS_FIELD_NOSETTER(int, iId, getId)                            ///< unique in this process
+    ADD_CLASS_FIELD_NOSETTER(QString, strFileName, getFileName)          ///< bitstream file
+    ADD_CLASS_FIELD_NOSETTER(QString, strOutputPath, getOutputPath)      ///< decoder output folder
+    ADD_CLASS_FIELD_NOSETTER(bool, bFinished, isFinished)
+    ADD_CLASS_FIELD_NOSETTER(bool, bSuccessful, isSuccessful)            ///< decoded and parsed
+    ADD_CLASS_FIELD_NOSETTER(bool, bCancelled, isCancelled)
+    ADD_CLASS_FIELD(bool, bLazyLCULoading, getLazyLCULoading, setLazyLCULoading)   ///< see DecoderOutputParser
+    ADD_CLASS_FIELD(QString, strIndexFile, getIndexFile, setIndexFile)             ///< cache file of the AnnexBIndex, none if empty
+
+protected:
+    friend class OutputParseTask;
+
+    /// join the sections and parse the decoder output into m_pcSequence, on m_cParsePool
+    void xParseOutput();
+    /// sections of the bitstream, from the manifest if they match the index or a new plan
+    void xPlanSections();
+    bool xStartSection();
+    /// the decoder reads bytes [iStart, iEnd) of the bitstream only (see BitstreamParser::setBitstreamRange)
+    bool xSetRange(qint64 iStart, qint64 iEnd);
+    QString xSectionFolder(int iSection) const;
+    /// pictures the decoder is done with, in the whole bitstream
+    int xDecodedPictures();
+    /// wait for the decoder process (or thread) to exit at most iMsecs, true if it has
+    bool xWaitForDecoder(int iMsecs);
+    bool xIsDecodingSuccessful() const;
+
+    BitstreamParser m_cBitstreamParser;
+    AnnexBIndex m_cIndex;                   ///< picture positions for the progress and the frame range
+    int m_iFirstFrame;
+    int m_iLastFrame;
+    int m_iFirstPicture;                    ///< first picture given to the decoder
+    int m_iPictureNum;                      ///< pictures given to the decoder
+    ComSequence* m_pcSequence;
+
+    bool m_bCheckpoints;
+    QVector<int> m_aiSections;              ///< first picture of every section, empty if decoded at once
+    int m_iSection;                         ///< section being decoded
+    QString m_strDecoderFolder;
+    int m_iEncoderVersion;
+
+#ifdef HM_INPROCESS_DECODER
+    bool m_bInProcess;
+    InProcessDecoder* m_pcInProcess;        ///< instead of m_cBitstreamParser if not NULL
+#endif
+
+    bool m_bParsing;                        ///< xParseOutput() started, not polled to its end yet
+    QThreadPool m_cParsePool;               ///< one worker for xParseOutput()
+};
+
+#endif // DECODEJOB_H
@@ -3,6 +3,16 @@
 #include <QTextStream>
 #include <QDebug>
 
+// POC   18 TId: 0 ( B-SLICE, QP 33 ) [DT  0.005] [L0 17 16 15 14 ] [L1 17 16 15 14 ] [LC 17 16 15 14 ] [MD5:f2984e1c87633f1c2476eb2ddb844a53,(OK)]
+static const char* s_pchFrameLinePattern =
+    "POC *(-?[0-9]+).*\\[DT *([0-9.]+) *\\] \\[L0(( -?[0-9]+){0,}) \\] \\[L1(( -?[0-9]+){0,}) \\] (\\[LC(( -?[0-9]+){0,}) \\])?";
+
+/// TId: 0 ( B-SLICE, QP 33 )
+static const char* s_pchSliceInfoPattern = "TId: *([0-9]+) *\\( *([IPB])-SLICE, *QP *(-?[0-9]+) *\\)";
+
+/// [BITS 123456] of a pre-scan, the bits of the slice NAL units (the per-LCU bits add up to them otherwise)
+static const char* s_pchPicBitsPattern = "\\[BITS *([0-9]+)\\]";
+
 /// rearrange frames into POC ascending order
 static bool xFrameSortingOrder(ComFrame* pcFrameFirst, ComFrame* pcFrameSecond)
 {
@@ -51,7 +61,7 @@ bool DecoderGeneralParser::parseFile(QTextStream* pcInputStream, ComSequence* pc
     // read one frame
 
     ComFrame *pcFrame = NULL;
-    cMatchTarget.setPattern("POC *(-?[0-9]+).*\\[DT *([0-9.]+) *\\] \\[L0(( -?[0-9]+){0,}) \\] \\[L1(( -?[0-9]+){0,}) \\] (\\[LC(( -?[0-9]+){0,}) \\])?");
+    cMatchTarget.setPattern(s_pchFrameLinePattern);
     pcInputStream->readLine();///< Skip a empty line
     while( !pcInputStream->atEnd() )
     {
@@ -63,18 +73,7 @@ bool DecoderGeneralParser::parseFile(QTextStream* pcInputStream, ComSequence* pc
                 break;
         }
         if( cMatchTarget.indexIn(strOneLine) != -1 ) {
-            pcFrame = new ComFrame(pcSequence);
-
-            /// POC & Decoding time
-            pcFrame->setPOC(cMatchTarget.cap(1).toInt());
-            pcFrame->setTotalDecTime(cMatchTarget.cap(2).toDouble());
-
-            /// L0 L1 LC
-            QString strL0, strL1, strLC;
-            strL0 = cMatchTarget.cap(3); strL1 = cMatchTarget.cap(5); strLC = cMatchTarget.cap(7);
-            readIntArray(&pcFrame->getL0List(), &strL0);
-            readIntArray(&pcFrame->getL1List(), &strL1);
-            readIntArray(&pcFrame->getLCList(), &strLC);
+            pcFrame = parseFrameLine(strOneLine, pcSequence);
 
             pcSequence->getFramesInDecOrder().push_back(pcFrame);
             pcSequence->getFramesInDisOrder().push_back(pcFrame);
@@ -109,6 +108,62 @@ bool DecoderGeneralParser::parseFile(QTextStream* pcInputStream, ComSequence* pc
     return true;
 }
 
+ComFrame* DecoderGeneralParser::parseFrameLine(const QString& strOneLine, ComSequence* pcSequence)
+{
+    QRegExp cMatchTarget(s_pchFrameLinePattern);
+    if( cMatchTarget.indexIn(strOneLine) == -1 )
+        return NULL;
+
+    ComFrame* pcFrame = new ComFrame(pcSequence);
+
+    /// POC & Decoding time
+    pcFrame->setPOC(cMatchTarget.cap(1).toInt());
+    pcFrame->setTotalDecTime(cMatchTarget.cap(2).toDouble());
+
+    /// L0 L1 LC
+    QString strL0, strL1, strLC;
+    strL0 = cMatchTarget.cap(3); strL1 = cMatchTarget.cap(5); strLC = cMatchTarget.cap(7);
+    readIntArray(&pcFrame->getL0List(), &strL0);
+    readIntArray(&pcFrame->getL1List(), &strL1);
+    readIntArray(&pcFrame->getLCList(), &strLC);
+
+    /// slice type & QP
+    QRegExp cSliceInfo(s_pchSliceInfoPattern);
+    if( cSliceInfo.indexIn(strOneLine) != -1 )
+    {
+        pcFrame->setTemporalId(cSliceInfo.cap(1).toInt());
+        pcFrame->setSliceType(cSliceInfo.cap(2).at(0).toLatin1());
+        pcFrame->setQP(cSliceInfo.cap(3).toInt());
+    }
+
+    /// picture bits (pre-scan)
+    QRegExp cPicBits(s_pchPicBitsPattern);
+    if( cPicBits.indexIn(strOneLine) != -1 )
+        pcFrame->setBitCount(cPicBits.cap(1).toInt());
+
+    return pcFrame;
+}
+
+bool DecoderGeneralParser::parseInfoLine(const QString& strOneLine, ComSequence* pcSequence)
+{
+    //HM software: Decoder Version [5.2][Windows][VS 1500][32 bit]
+    QRegExp cMatchTarget("HM software: Decoder Version \\[([0-9.]+)\\].*");
+    if( cMatchTarget.indexIn(strOneLine) != -1 )
+    {
+        pcSequence->setEncoderVersion(cMatchTarget.cap(1));
+        return true;
+    }
+
+    // Total Time:     2070.335 sec.
+    cMatchTarget.setPattern(" Total Time: *([0-9.]+).*");
+    if( cMatchTarget.indexIn(strOneLine) != -1 )
+    {
+        pcSequence->setTotalDecTime(cMatchTarget.cap(1).toDouble());
+        return true;
+    }
+    return false;
+}
+
 void DecoderGeneralParser::xSortByFrameCount( ComSequence* pcSequence )
 {
     /// Get IDR groups
@@ -12,6 +12,13 @@ public:
     explicit DecoderGeneralParser(QObject *parent = 0);
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
 
+    /// create the frame described by one POC line, NULL if it is not a POC line
+    ComFrame* parseFrameLine(const QString& strOneLine, ComSequence* pcSequence);
+    /// decoder version or total decoding time line, false if it is neither
+    bool parseInfoLine(const QString& strOneLine, ComSequence* pcSequence);
+    /// assign the displaying order of frames already in getFramesInDisOrder() (POC order in each IDR group)
+    void sortByFrameCount(ComSequence* pcSequence) { xSortByFrameCount(pcSequence); }
+
 protected:
     void xSortByFrameCount( ComSequence* pcSequence );
 
@@ -0,0 +1,149 @@
+#include "decoderoutputparser.h"
+#include "parsers/spsparser.h"
+#include "parsers/decodergeneralparser.h"
+#include "parsers/lcuinfoparser.h"
+#include "parsers/parallellcuparser.h"
+#include "parsers/tileparser.h"
+#include "parsers/lcuindex.h"
+#include "parsers/analysisbinparser.h"
+#include "gitlupdateuievt.h"
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include <QDebug>
+
+DecoderOutputParser::DecoderOutputParser(QObject *parent) :
+    QObject(parent)
+{
+    m_bLazyLCULoading = false;
+    m_bStageEvents = true;
+}
+
+void DecoderOutputParser::xDispatchStage(GitlUpdateUIEvt& rcEvt)
+{
+    if( m_bStageEvents )
+        dispatchEvt(rcEvt);
+}
+
+bool DecoderOutputParser::parseFolder(const QString& strDecoderOutputPath, ComSequence* pcSequence)
+{
+    GitlUpdateUIEvt cDecodingStageInfo;
+    bool bSuccess = true;
+
+    /// Parse decoder_sps.txt
+    QString strSPSFilename = strDecoderOutputPath + "/decoder_sps.txt";
+    if( bSuccess )
+    {
+        cDecodingStageInfo.setParameter("decoding_progress", "(2/5)Start Parsing Sequence Parameter Set...");
+        xDispatchStage(cDecodingStageInfo);
+        QFile cSPSFile(strSPSFilename);
+        cSPSFile.open(QIODevice::ReadOnly);
+        QTextStream cSPSTextStream(&cSPSFile);
+        SpsParser cSpsParser;
+        bSuccess = cSpsParser.parseFile( &cSPSTextStream, pcSequence );
+        cSPSFile.close();
+        qDebug() << "SPS file parsing finished";
+    }
+    /// Parse decoder_general.txt
+    QString strGeneralFilename = strDecoderOutputPath + "/decoder_general.txt";
+    if( bSuccess )
+    {
+        cDecodingStageInfo.setParameter("message", "(3/5)Start Parsing Decoder Std Output File...");
+        xDispatchStage(cDecodingStageInfo);
+        QFile cGeneralFile(strGeneralFilename);
+        cGeneralFile.open(QIODevice::ReadOnly);
+        QTextStream cGeneralTextStream(&cGeneralFile);
+        DecoderGeneralParser cDecoderGeneralParser;
+        bSuccess = cDecoderGeneralParser.parseFile( &cGeneralTextStream, pcSequence );
+        cGeneralFile.close();
+        qDebug() << "Decoder general file parsing finished";
+    }
+    /// a pre-scan has the frames only, the per-LCU files HM opened are empty
+    if( pcSequence->getPreScan() )
+        return bSuccess;
+
+    /// Parse decoder_analysis.bin
+    /// (if the decoder wrote the binary container, it replaces all the per-LCU txt files below)
+    QString strAnalysisBinFilename = strDecoderOutputPath + "/decoder_analysis.bin";
+    bool bBinaryAnalysis = QFile::exists(strAnalysisBinFilename);
+
+    if( bSuccess && bBinaryAnalysis )
+    {
+        cDecodingStageInfo.setParameter("decoding_progress", "(4/5)Start Parsing Binary Analysis Data...");
+        xDispatchStage(cDecodingStageInfo);
+        QFile cAnalysisBinFile(strAnalysisBinFilename);
+        cAnalysisBinFile.open(QIODevice::ReadOnly);
+        AnalysisBinParser cAnalysisBinParser;
+        bSuccess = cAnalysisBinParser.parseFile( &cAnalysisBinFile, pcSequence );
+        cAnalysisBinFile.close();
+        qDebug() << "Binary analysis file parsing finished";
+    }
+
+    /// Index the per-LCU txt files, the CU trees of a frame are parsed when it is visited
+    bool bIndexed = false;
+    if( bSuccess && !bBinaryAnalysis && m_bLazyLCULoading )
+    {
+        cDecodingStageInfo.setParameter("decoding_progress", "(4/5)Start Indexing LCU Info...");
+        xDispatchStage(cDecodingStageInfo);
+        LCUIndex* pcLCUIndex = new LCUIndex();
+        bIndexed = pcLCUIndex->open( strDecoderOutputPath, pcSequence );
+        if( bIndexed )
+        {
+            pcSequence->setLCULoader(pcLCUIndex);
+            qDebug() << "LCU info files indexing finished";
+        }
+        else
+        {
+            qWarning() << "LCU info files can not be indexed, parse them at once";
+            delete pcLCUIndex;
+        }
+    }
+
+    /// Parse the per-LCU txt files
+    /// (decoder_cupu.txt, decoder_tu.txt, decoder_pred.txt, decoder_mv.txt,
+    ///  decoder_merge.txt, decoder_intra.txt, decoder_bit_lcu.txt, decoder_bit_scu.txt)
+    /// on a thread pool when there are enough cores, otherwise in one fused pass
+    bool bParallelParsing = QThread::idealThreadCount() > 2;
+    if( bSuccess && !bBinaryAnalysis && !bIndexed && bParallelParsing )
+    {
+        cDecodingStageInfo.setParameter("decoding_progress", "(4/5)Start Parsing LCU Info In Parallel...");
+        xDispatchStage(cDecodingStageInfo);
+        ParallelLCUParser cParallelLCUParser;
+        bSuccess = cParallelLCUParser.parseFolder( strDecoderOutputPath, pcSequence );
+        qDebug() << "LCU info files parallel parsing finished";
+    }
+    if( bSuccess && !bBinaryAnalysis && !bIndexed && !bParallelParsing )
+    {
+        cDecodingStageInfo.setParameter("decoding_progress", "(4/5)Start Parsing LCU Info...");
+        xDispatchStage(cDecodingStageInfo);
+        IntTokenizer acLCUTokenizer[LCU_STREAM_NUM];
+        IntTokenizer* apcLCUTokenizer[LCU_STREAM_NUM];
+        for(int i = 0; i < LCU_STREAM_NUM; i++)
+        {
+            acLCUTokenizer[i].openFile(strDecoderOutputPath + g_apchLCUFiles[i]);
+            apcLCUTokenizer[i] = &acLCUTokenizer[i];
+        }
+        LCUInfoParser cLCUInfoParser;
+        bSuccess = cLCUInfoParser.parseFile( apcLCUTokenizer, pcSequence );
+        qDebug() << "LCU info files parsing finished";
+    }
+
+
+    ///parse decoder_tile.txt
+    QString strTileFilename = strDecoderOutputPath + "/decoder_tile.txt";
+    if( bSuccess && !bBinaryAnalysis )
+    {
+        cDecodingStageInfo.setParameter("decoding_progress", "(5/5)Start Parsing Tile Info...");
+        xDispatchStage(cDecodingStageInfo);
+        IntTokenizer cTileTokenizer;
+        if( cTileTokenizer.openFile(strTileFilename) )
+        {
+            TileParser cTileParser;
+            bSuccess = cTileParser.parseFile( &cTileTokenizer, pcSequence );
+            qDebug() << "Tile file parsing finished";
+        }
+
+    }
+
+    return bSuccess;
+}
@@ -0,0 +1,31 @@
+#ifndef DECODEROUTPUTPARSER_H
+#define DECODEROUTPUTPARSER_H
+
+#include <QObject>
+#include "gitlmodual.h"
+#include "gitlupdateuievt.h"
+#include "model/common/comsequence.h"
+
+/*!
+ * \brief The DecoderOutputParser class
+ * builds a sequence from all the files written by a finished decoding
+ * (decoder_sps.txt, decoder_general.txt, then the per-LCU info in decoder_analysis.bin
+ * or in the per-LCU txt files, and decoder_tile.txt; the shared memory transport writes the txt files too).
+ */
+
+class DecoderOutputParser : public QObject, public GitlModual
+{
+    Q_OBJECT
+public:
+    explicit DecoderOutputParser(QObject *parent = 0);
+
+    bool parseFolder(const QString& strDecoderOutputPath, ComSequence* pcSequence);
+
+    ADD_CLASS_FIELD(bool, bLazyLCULoading, getLazyLCULoading, setLazyLCULoading)   ///< index the per-LCU txt files instead of parsing them
+    ADD_CLASS_FIELD(bool, bStageEvents, getStageEvents, setStageEvents)            ///< show the parsing stages, off on a worker thread
+
+protected:
+    void xDispatchStage(GitlUpdateUIEvt& rcEvt);
+};
+
+#endif // DECODEROUTPUTPARSER_H
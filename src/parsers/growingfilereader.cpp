@@ -0,0 +1,36 @@
+#include "growingfilereader.h"
+#include <QDebug>
+
+#define FOLLOW_READ_SIZE        (1 << 20)       ///< bytes read from the file at once
+
+GrowingFileReader::GrowingFileReader()
+{
+    m_bFollowing = true;
+}
+
+bool GrowingFileReader::open(const QString& strFilePath)
+{
+    /// unbuffered, or the end of the file seen once would be cached
+    m_cFile.setFileName(strFilePath);
+    if( !m_cFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered) )
+        return false;
+    m_iBytesRead = 0;
+    return true;
+}
+
+bool GrowingFileReader::readAccessUnit(QByteArray& rcAnnexB)
+{
+    /// a file rewritten from the start is another bitstream
+    if( m_cFile.size() < m_iBytesRead )
+    {
+        qWarning() << "Followed bitstream truncated, stop following" << m_cFile.fileName();
+        m_bFollowing = false;
+        return false;
+    }
+    QByteArray cData = m_cFile.read(FOLLOW_READ_SIZE);
+    if( cData.isEmpty() )
+        return false;
+    m_iBytesRead += cData.size();
+    rcAnnexB.append(cData);
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef GROWINGFILEREADER_H
+#define GROWINGFILEREADER_H
+
+#include "parsers/containerdemuxer.h"
+
+/*!
+ * \brief The GrowingFileReader class
+ * an Annex-B file which is still being written (e.g. by an encoder), followed like "tail -f":
+ * every read returns the bytes appended since the last one, so the decoder gets only the new data.
+ * There is no end of the file while following, BitstreamParser polls again later;
+ * after stopFollowing() the rest of the file is read and the stream ends.
+ */
+
+class GrowingFileReader : public ContainerDemuxer
+{
+public:
+    GrowingFileReader();
+
+    bool open(const QString& strFilePath);
+    /// append the new bytes of the file (not aligned to access units, the decoder waits for the rest)
+    bool readAccessUnit(QByteArray& rcAnnexB);
+    bool isWaiting() const { return m_bFollowing; }
+
+    /// the file is complete, read up to its current end
+    void stopFollowing() { m_bFollowing = false; }
+
+protected:
+    bool m_bFollowing;
+};
+
+#endif // GROWINGFILEREADER_H
@@ -0,0 +1,183 @@
+#include "inprocessdecoder.h"
+#include "parsers/decodergeneralparser.h"
+#include "exceptions/bitstreamnotfoundexception.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDir>
+#include <QApplication>
+#include <QtAlgorithms>
+#include <QDebug>
+
+/// the decoder library keeps global state, one session at a time
+static QMutex s_cSessionMutex;
+
+/// set by TDecGop on a picture hash mismatch, TAppDecoder defines it in decmain.cpp
+bool g_md5_mismatch = false;
+
+InProcessDecoder::InProcessDecoder(QObject *parent) :
+    QThread(parent)
+{
+    m_bSuccessful = false;
+    m_bLCUError = false;
+    m_pcSequence = NULL;
+    m_pcFrame = NULL;
+    connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(cancel()), Qt::DirectConnection);
+}
+
+InProcessDecoder::~InProcessDecoder()
+{
+    cancel();
+    wait();
+    delete m_pcFrame;
+}
+
+bool InProcessDecoder::startDecoding(QString strBitstreamFilePath,
+                                     QString strOutputPath,
+                                     ComSequence* pcSequence)
+{
+    QDir cCurDir = QDir::current();
+    if( (!cCurDir.exists(strBitstreamFilePath)) ||
+        (!cCurDir.isAbsolutePath(strBitstreamFilePath)) )
+    {
+        throw BitstreamNotFoundException();
+    }
+    if( !cCurDir.exists(strOutputPath) )
+    {
+        cCurDir.mkpath(strOutputPath);
+    }
+
+    /// analysis files of a previous decoding would not match decoder_yuv.yuv anymore
+    QDir cOutputDir(strOutputPath);
+    foreach(const QString& strStaleFile, cOutputDir.entryList(QStringList() << "decoder_*.txt" << "decoder_analysis.bin", QDir::Files))
+        cOutputDir.remove(strStaleFile);
+
+    m_cYUVFile.setFileName(strOutputPath + "/decoder_yuv.yuv");
+    if( !m_cYUVFile.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+    {
+        qCritical() << "Can not create" << m_cYUVFile.fileName();
+        return false;
+    }
+
+    m_strBitstreamFilePath = strBitstreamFilePath;
+    m_strOutputPath = strOutputPath;
+    m_pcSequence = pcSequence;
+    m_iCancelled = 0;
+    m_iDecodedFrames = 0;
+    m_bSuccessful = false;
+    m_bLCUError = false;
+
+    start();
+    return true;
+}
+
+bool InProcessDecoder::finishDecoding()
+{
+    m_cYUVFile.close();
+
+    delete m_pcFrame;
+    m_pcFrame = NULL;
+    if( !m_bSuccessful )
+        return false;
+
+    /// same sequence as the decoder_general.txt parsing
+    m_pcSequence->setEncoderVersion("12.0");
+    double dTotalDecTime = 0;
+    foreach(ComFrame* pcFrame, m_pcSequence->getFramesInDecOrder())
+        dTotalDecTime += pcFrame->getTotalDecTime();
+    m_pcSequence->setTotalDecTime(dTotalDecTime);
+    m_pcSequence->setFramesInDisOrder(m_pcSequence->getFramesInDecOrder());
+    m_pcSequence->setTotalFrames(m_pcSequence->getFramesInDisOrder().size());
+    if( m_pcSequence->getTotalFrames() == 0 )
+        return false;
+    DecoderGeneralParser cDecoderGeneralParser;
+    cDecoderGeneralParser.sortByFrameCount(m_pcSequence);
+    m_pcSequence->setDecodingFolder(m_strOutputPath);
+    return true;
+}
+
+void InProcessDecoder::cancel()
+{
+    m_iCancelled = 1;
+}
+
+void InProcessDecoder::run()
+{
+    QMutexLocker cLocker(&s_cSessionMutex);
+    QByteArray cBitstreamFile = QFile::encodeName(m_strBitstreamFilePath);
+    m_bSuccessful = TSysuDecoderSession::decode(cBitstreamFile.constData(), this) && !m_bLCUError;
+}
+
+bool InProcessDecoder::isCancelled()
+{
+    return m_iCancelled != 0;
+}
+
+void InProcessDecoder::onSps(int iWidth, int iHeight, int iMaxCUSize, int iMaxCUDepth,
+                             int iMaxInterTUDepth, int iMaxIntraTUDepth, int iInputBitDepth)
+{
+    m_pcSequence->setWidth(iWidth);
+    m_pcSequence->setHeight(iHeight);
+    m_pcSequence->setMaxCUSize(iMaxCUSize);
+    m_pcSequence->setMaxCUDepth(iMaxCUDepth);
+    m_pcSequence->setMaxInterTUDepth(iMaxInterTUDepth);
+    m_pcSequence->setMaxIntraTUDepth(iMaxIntraTUDepth);
+    m_pcSequence->setInputBitDepth(iInputBitDepth);
+}
+
+ComFrame* InProcessDecoder::xGetCurrentFrame(int iPoc)
+{
+    if( m_pcFrame == NULL )
+    {
+        m_pcFrame = new ComFrame(m_pcSequence);
+        m_pcFrame->setPOC(iPoc);
+    }
+    return m_pcFrame;
+}
+
+void InProcessDecoder::onLCU(int iPoc, int iAddr, const std::vector<int>* paiValues)
+{
+    if( m_bLCUError )
+        return;
+    for(int i = 0; i < SYSU_CAT_NUM; i++)
+        m_aiLCUValues[i] = QVector<int>::fromStdVector(paiValues[i]);
+    if( m_cLCUBuilder.buildLCU(xGetCurrentFrame(iPoc), iAddr, m_aiLCUValues) == NULL )
+    {
+        qCritical() << "In-process decoder Error! Illegal LCU info at POC" << iPoc << "addr" << iAddr;
+        m_bLCUError = true;
+        m_iCancelled = 1;
+    }
+}
+
+void InProcessDecoder::onTile(int iPoc, int iTileNum, int iFirstCUAddr, int iWidth, int iHeight)
+{
+    /// tiles are reported after every slice, keep the first report of the picture
+    ComFrame* pcFrame = xGetCurrentFrame(iPoc);
+    if( pcFrame->getTiles().size() >= iTileNum )
+        return;
+    ComTile* pcTile = new ComTile(pcFrame);
+    pcTile->setFirstCUAddr(iFirstCUAddr);
+    pcTile->setWidth(iWidth);
+    pcTile->setHeight(iHeight);
+    pcFrame->getTiles().push_back(pcTile);
+}
+
+void InProcessDecoder::onFrame(int iPoc, double dDecTime,
+                               const std::vector<int>& raiRefPOCL0, const std::vector<int>& raiRefPOCL1)
+{
+    ComFrame* pcFrame = xGetCurrentFrame(iPoc);
+    m_pcFrame = NULL;
+    pcFrame->setTotalDecTime(dDecTime);
+    pcFrame->getL0List() = QVector<int>::fromStdVector(raiRefPOCL0);
+    pcFrame->getL1List() = QVector<int>::fromStdVector(raiRefPOCL1);
+
+    /// LCUs come in decoding order (tile scan), the views expect raster order
+    qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(),
+          [](const ComCU* pcFirst, const ComCU* pcSecond) { return *pcFirst < *pcSecond; });
+    m_pcSequence->getFramesInDecOrder().push_back(pcFrame);
+    m_iDecodedFrames.ref();
+}
+
+void InProcessDecoder::onPicture(const unsigned char* pucData, unsigned int uiLength)
+{
+    m_cYUVFile.write((const char*)pucData, uiLength);
+}
@@ -0,0 +1,72 @@
+#ifndef INPROCESSDECODER_H
+#define INPROCESSDECODER_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QFile>
+#include "gitldef.h"
+#include "model/common/comsequence.h"
+#include "parsers/analysisbinparser.h"
+#include "TLibSysuAnalyzer/TSysuDecoderSession.h"
+
+/*!
+ * \brief The InProcessDecoder class
+ * this class runs the HM-12.0 decoder library (TSysuDecoderSession) on a worker thread and builds
+ * the sequence straight from the analysis callbacks, no decoder process is started and no
+ * per-LCU text is written or parsed. Only the reconstructed pictures go to decoder_yuv.yuv,
+ * which is read by the YUV buffer as usual.
+ * It is run by a DecodeJob (see DecodeJob::setInProcess()), which polls it and can cancel it.
+ * Available when the analyzer is built with CONFIG+=hm_inprocess (HM_INPROCESS_DECODER).
+ */
+
+class InProcessDecoder : public QThread, public TSysuAnalyzerSink
+{
+    Q_OBJECT
+public:
+    explicit InProcessDecoder(QObject *parent = 0);
+    ~InProcessDecoder();
+
+    /// start decoding the whole bitstream into pcSequence and return at once, wait() for the end
+    bool startDecoding(QString strBitstreamFilePath,
+                       QString strOutputPath,
+                       ComSequence* pcSequence);
+    /// once the thread has finished: put the frames of a successful decoding in display order, false if it failed
+    bool finishDecoding();
+
+    /// pictures decoded so far
+    int getDecodedFrames() const { return m_iDecodedFrames; }
+
+    ADD_CLASS_FIELD_NOSETTER(bool, bSuccessful, isDecodingSuccessful)  ///< decoded to the end and every LCU is legal
+
+public slots:
+    /// stop decoding at the next NAL unit
+    void cancel();
+
+protected:
+    void run();
+
+    /// TSysuAnalyzerSink, called on the worker thread
+    void onSps     ( int iWidth, int iHeight, int iMaxCUSize, int iMaxCUDepth,
+                     int iMaxInterTUDepth, int iMaxIntraTUDepth, int iInputBitDepth );
+    void onFrame   ( int iPoc, double dDecTime, const std::vector<int>& raiRefPOCL0,
+                     const std::vector<int>& raiRefPOCL1 );
+    void onLCU     ( int iPoc, int iAddr, const std::vector<int>* paiValues );
+    void onTile    ( int iPoc, int iTileNum, int iFirstCUAddr, int iWidth, int iHeight );
+    void onPicture ( const unsigned char* pucData, unsigned int uiLength );
+    bool isCancelled();
+
+    ComFrame* xGetCurrentFrame(int iPoc);
+
+    QAtomicInt m_iCancelled;
+    QAtomicInt m_iDecodedFrames;
+    QString m_strOutputPath;
+    bool m_bLCUError;                       ///< illegal LCU info, decoding is cancelled
+    QString m_strBitstreamFilePath;
+    ComSequence* m_pcSequence;
+    ComFrame* m_pcFrame;                    ///< picture being decoded, not in the sequence yet
+    AnalysisBinParser m_cLCUBuilder;
+    QVector<int> m_aiLCUValues[SYSU_CAT_NUM];
+    QFile m_cYUVFile;                       ///< decoder_yuv.yuv
+};
+
+#endif // INPROCESSDECODER_H
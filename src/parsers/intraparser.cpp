@@ -1,5 +1,4 @@
 #include "intraparser.h"
-#include <QRegExp>
 #include <QDebug>
 IntraParser::IntraParser(QObject *parent) :
     QObject(parent)
@@ -8,57 +7,52 @@ IntraParser::IntraParser(QObject *parent) :
 
 bool IntraParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
 {
-    Q_ASSERT( pcSequence != NULL );
-
-    QString strOneLine;
-    QRegExp cMatchTarget;
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
 
+bool IntraParser::parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
 
     /// <0,8> 8 36 31 36 30 36 31 36 0 36 2 36 1 36 0 36 1 36
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-    QTextStream cIntraDirInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-
-            ///
-            QString strIntraDir = cMatchTarget.cap(3);
-            cIntraDirInfoStream.setString( &strIntraDir, QIODevice::ReadOnly );
-            xReadIntraMode(&cIntraDirInfoStream, pcLCU);
-
+            qCritical() << "IntraParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        xReadIntraMode(pcTokenizer, pcLCU);
     }
     return true;
 }
 
 
-bool IntraParser::xReadIntraMode(QTextStream* pcCUInfoStream, ComCU* pcCU)
+bool IntraParser::xReadIntraMode(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     if( !pcCU->getSCUs().empty() )
     {
         /// non-leaf node : recursive reading for children
-        xReadIntraMode(pcCUInfoStream, pcCU->getSCUs().at(0));
-        xReadIntraMode(pcCUInfoStream, pcCU->getSCUs().at(1));
-        xReadIntraMode(pcCUInfoStream, pcCU->getSCUs().at(2));
-        xReadIntraMode(pcCUInfoStream, pcCU->getSCUs().at(3));
+        xReadIntraMode(pcTokenizer, pcCU->getSCUs().at(0));
+        xReadIntraMode(pcTokenizer, pcCU->getSCUs().at(1));
+        xReadIntraMode(pcTokenizer, pcCU->getSCUs().at(2));
+        xReadIntraMode(pcTokenizer, pcCU->getSCUs().at(3));
     }
     else
     {
@@ -67,8 +61,8 @@ bool IntraParser::xReadIntraMode(QTextStream* pcCUInfoStream, ComCU* pcCU)
         int iIntraDirChroma;
         for(int i = 0; i < pcCU->getPUs().size(); i++)
         {
-            Q_ASSERT(pcCUInfoStream->atEnd()==false);
-            *pcCUInfoStream >> iIntraDirLuma >> iIntraDirChroma;
+            if( !pcTokenizer->readInt(iIntraDirLuma) || !pcTokenizer->readInt(iIntraDirChroma) )
+                return false;
             pcCU->getPUs().at(i)->setIntraDirLuma(iIntraDirLuma);
             pcCU->getPUs().at(i)->setIntraDirChroma(iIntraDirChroma);
         }
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 
 class IntraParser : public QObject
 {
@@ -11,9 +12,10 @@ class IntraParser : public QObject
 public:
     explicit IntraParser(QObject *parent = 0);
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 
 protected:
-    bool xReadIntraMode(QTextStream* pcCUInfoStream, ComCU* pcCU);
+    bool xReadIntraMode(IntTokenizer* pcTokenizer, ComCU* pcCU);
 signals:
 
 public slots:
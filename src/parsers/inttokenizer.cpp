@@ -0,0 +1,115 @@
+#include "inttokenizer.h"
+#include <cstring>
+
+IntTokenizer::IntTokenizer() :
+    m_pcCur(NULL),
+    m_pcEnd(NULL),
+    m_bLineStart(true)
+{
+}
+
+IntTokenizer::IntTokenizer(const QByteArray& rcData) :
+    m_pcCur(rcData.constData()),
+    m_pcEnd(rcData.constData() + rcData.size()),
+    m_bLineStart(true)
+{
+}
+
+IntTokenizer::~IntTokenizer()
+{
+    close();
+}
+
+bool IntTokenizer::openFile(const QString& strFilename)
+{
+    close();
+    m_cFile.setFileName(strFilename);
+    if( !m_cFile.open(QIODevice::ReadOnly) )
+        return false;
+
+    qint64 iSize = m_cFile.size();
+    const char* pcData = NULL;
+    if( iSize > 0 )
+        pcData = (const char*)m_cFile.map(0, iSize);
+    if( pcData == NULL )
+    {
+        /// empty file or mapping not supported
+        m_cBuffer = m_cFile.readAll();
+        pcData = m_cBuffer.constData();
+        iSize = m_cBuffer.size();
+    }
+    m_pcCur = pcData;
+    m_pcEnd = pcData + iSize;
+    m_bLineStart = true;
+    return true;
+}
+
+void IntTokenizer::close()
+{
+    /// unmapped automatically
+    if( m_cFile.isOpen() )
+        m_cFile.close();
+    m_cBuffer.clear();
+    m_pcCur = m_pcEnd = NULL;
+    m_bLineStart = true;
+}
+
+bool IntTokenizer::readLCUHeader(int& riPoc, int& riAddr)
+{
+    while( m_pcCur < m_pcEnd )
+    {
+        if( !m_bLineStart )
+        {
+            /// skip the rest of current line
+            const char* pcNewLine = (const char*)memchr(m_pcCur, '\n', m_pcEnd - m_pcCur);
+            m_pcCur = (pcNewLine == NULL) ? m_pcEnd : pcNewLine + 1;
+            m_bLineStart = true;
+            continue;
+        }
+
+        m_bLineStart = false;
+        if( *m_pcCur != '<' )
+            continue;
+        ++m_pcCur;
+        if( !xScanInt(riPoc) || m_pcCur >= m_pcEnd || *m_pcCur != ',' )
+            continue;
+        ++m_pcCur;
+        if( !xScanInt(riAddr) || m_pcCur >= m_pcEnd || *m_pcCur != '>' )
+            continue;
+        ++m_pcCur;
+        return true;
+    }
+    return false;
+}
+
+bool IntTokenizer::readInt(int& riValue)
+{
+    if( m_bLineStart )
+        return false;
+    while( m_pcCur < m_pcEnd && (*m_pcCur == ' ' || *m_pcCur == '\t') )
+        ++m_pcCur;
+    if( m_pcCur >= m_pcEnd || *m_pcCur == '\n' || *m_pcCur == '\r' )
+        return false;
+    return xScanInt(riValue);
+}
+
+bool IntTokenizer::xScanInt(int& riValue)
+{
+    bool bNegative = false;
+    if( m_pcCur < m_pcEnd && *m_pcCur == '-' )
+    {
+        bNegative = true;
+        ++m_pcCur;
+    }
+    const char* pcDigitBegin = m_pcCur;
+    int iValue = 0;
+    while( m_pcCur < m_pcEnd && *m_pcCur >= '0' && *m_pcCur <= '9' )
+    {
+        iValue = iValue * 10 + (*m_pcCur - '0');
+        ++m_pcCur;
+    }
+    if( m_pcCur == pcDigitBegin )
+        return false;
+    riValue = bNegative ? -iValue : iValue;
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef INTTOKENIZER_H
+#define INTTOKENIZER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+
+/*!
+ * \brief The IntTokenizer class
+ * fast integer scanner for the per-LCU decoder output files, e.g.
+ *      <poc,addr> v0 v1 v2 ...
+ * It works directly on a byte range (a memory-mapped file or a QByteArray),
+ * no QString conversion, no regular expression, no copy.
+ */
+
+class IntTokenizer
+{
+public:
+    IntTokenizer();
+    /// scan an existing buffer, the buffer must outlive the tokenizer
+    explicit IntTokenizer(const QByteArray& rcData);
+    ~IntTokenizer();
+
+    /// memory-map the whole file (falls back to reading it if mapping is not possible)
+    bool openFile(const QString& strFilename);
+    void close();
+
+    bool atEnd() const { return m_pcCur >= m_pcEnd; }
+
+    /*!
+     * \brief readLCUHeader skip the rest of the current line and read the next
+     * line header '<poc,addr>', lines without a valid header are skipped
+     */
+    bool readLCUHeader(int& riPoc, int& riAddr);
+
+    /*!
+     * \brief readInt read the next integer of the current line
+     * \return false at the end of the line
+     */
+    bool readInt(int& riValue);
+
+protected:
+    bool xScanInt(int& riValue);
+
+    QFile m_cFile;
+    QByteArray m_cBuffer;           ///< used if the file can not be mapped
+    const char* m_pcCur;
+    const char* m_pcEnd;
+    bool m_bLineStart;              ///< m_pcCur is at the beginning of a line
+
+private:
+    Q_DISABLE_COPY(IntTokenizer)
+};
+
+#endif // INTTOKENIZER_H
@@ -0,0 +1,379 @@
+#include "lcuindex.h"
+#include <QDataStream>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QThread>
+#include <QDebug>
+#include <cstring>
+#include <cstdlib>
+
+#define LCU_INDEX_FILE      "/decoder_lcu_index.bin"
+#define LCU_INDEX_MAGIC     0x58494C53      ///< 'SLIX'
+#define LCU_INDEX_VERSION   3
+
+/// tree summaries of a slice of the frames, see LCUIndex::xSummarizeTrees()
+class FrameSummaryTask : public QRunnable
+{
+public:
+    FrameSummaryTask(const LCUIndex* pcIndex, int iFirst, int iEnd, const char** apcData, ComFrameStatistics* pcResults) :
+        m_pcIndex(pcIndex), m_iFirst(iFirst), m_iEnd(iEnd), m_apcData(apcData), m_pcResults(pcResults)
+    {
+        setAutoDelete(true);
+    }
+    void run()
+    {
+        m_pcIndex->xSummarizeFrames(m_iFirst, m_iEnd, m_apcData, m_pcResults);
+    }
+private:
+    const LCUIndex* m_pcIndex;
+    int m_iFirst;
+    int m_iEnd;
+    const char** m_apcData;
+    ComFrameStatistics* m_pcResults;
+};
+
+static void xWriteStatistics(QDataStream& rcOut, const ComFrameStatistics& rcStatistics)
+{
+    rcOut << (qint32)rcStatistics.iLCUNum << (qint32)rcStatistics.iBits << rcStatistics.bTrees;
+    for(int i = 0; i < STAT_MAX_CU_DEPTH; i++)
+        rcOut << (qint32)rcStatistics.aiCUDepth[i];
+    rcOut << rcStatistics.iIntraArea << rcStatistics.iInterArea << rcStatistics.iSkipArea
+          << (qint32)rcStatistics.iInterPUs << (qint32)rcStatistics.iMergePUs << (qint32)rcStatistics.iMVNum
+          << rcStatistics.dMVLengthSum << rcStatistics.dMaxMVLength;
+}
+
+static void xReadStatistics(QDataStream& rcIn, ComFrameStatistics& rcStatistics)
+{
+    qint32 iLCUNum, iBits, iDepth, iInterPUs, iMergePUs, iMVNum;
+    rcIn >> iLCUNum >> iBits >> rcStatistics.bTrees;
+    rcStatistics.iLCUNum = iLCUNum;
+    rcStatistics.iBits = iBits;
+    for(int i = 0; i < STAT_MAX_CU_DEPTH; i++)
+    {
+        rcIn >> iDepth;
+        rcStatistics.aiCUDepth[i] = iDepth;
+    }
+    rcIn >> rcStatistics.iIntraArea >> rcStatistics.iInterArea >> rcStatistics.iSkipArea
+         >> iInterPUs >> iMergePUs >> iMVNum
+         >> rcStatistics.dMVLengthSum >> rcStatistics.dMaxMVLength;
+    rcStatistics.iInterPUs = iInterPUs;
+    rcStatistics.iMergePUs = iMergePUs;
+    rcStatistics.iMVNum = iMVNum;
+}
+
+LCUIndex::LCUIndex()
+{
+    m_pcSequence = NULL;
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+        m_aiFileSize[i] = 0;
+}
+
+LCUIndex::~LCUIndex()
+{
+}
+
+bool LCUIndex::open(const QString& strFolder, ComSequence* pcSequence)
+{
+    m_pcSequence = pcSequence;
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        m_acFile[i].setFileName(strFolder + g_apchLCUFiles[i]);
+        m_aiFileSize[i] = 0;
+        /// category the decoder was told not to write (AnalysisCategories), same as an empty file
+        if( !m_acFile[i].exists() )
+            continue;
+        if( !m_acFile[i].open(QIODevice::ReadOnly) )
+            return false;
+        m_aiFileSize[i] = m_acFile[i].size();
+    }
+
+    /// an index of other files (or of another decoding) is rebuilt
+    QString strIndexFile = strFolder + LCU_INDEX_FILE;
+    if( !xLoad(strIndexFile) )
+    {
+        if( !xBuild() )
+            return false;
+        xSummarizeTrees();
+        if( !xSave(strIndexFile) )
+            qWarning() << "LCU index can not be saved to" << strIndexFile;
+    }
+
+    /// the files may hold a POC window of the decoding only
+    const QVector<ComFrame*>& rcDecOrder = pcSequence->getFramesInDecOrder();
+    m_cEntry.clear();
+    int iDecOrder = -1;
+    for(int i = 0; i < m_acFrames.size(); i++)
+    {
+        iDecOrder = pcSequence->findDecOrder(m_acFrames[i].iPoc, iDecOrder+1);
+        if( iDecOrder < 0 )
+        {
+            qCritical() << "LCUIndex Error! POC" << m_acFrames[i].iPoc
+                        << "of the LCU files is not in decoder general info";
+            return false;
+        }
+        m_acFrames[i].iDecOrder = iDecOrder;
+        m_cEntry.insert(rcDecOrder[iDecOrder], i);
+        rcDecOrder[iDecOrder]->setBitCount(m_acFrames[i].iBitCount);
+        rcDecOrder[iDecOrder]->getStatistics() = m_acFrames[i].cStatistics;
+    }
+    return true;
+}
+
+bool LCUIndex::loadLCUs(ComFrame* pcFrame)
+{
+    /// not in the files: out of the decoder's POC window, the frame has no LCU
+    QHash<const ComFrame*, int>::const_iterator cIter = m_cEntry.constFind(pcFrame);
+    if( cIter == m_cEntry.constEnd() )
+        return true;
+    int iEntry = cIter.value();
+
+    /// the same lines of every file as a whole-file parse would see for this frame
+    QByteArray acFrameData[LCU_STREAM_NUM];
+    IntTokenizer* apcTokenizer[LCU_STREAM_NUM];
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        if( m_aiFileSize[i] == 0 )
+            continue;
+        qint64 iStart = m_acFrames[iEntry].aiOffset[i];
+        if( !m_acFile[i].seek(iStart) )
+            return false;
+        acFrameData[i] = m_acFile[i].read(xFrameEnd(iEntry, i) - iStart);
+    }
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+        apcTokenizer[i] = new IntTokenizer(acFrameData[i]);
+
+    /// LCUInfoParser adds the LCU bits up again
+    pcFrame->setBitCount(0);
+    LCUInfoParser cLCUInfoParser;
+    bool bSuccess = cLCUInfoParser.parseFile( apcTokenizer, m_pcSequence, m_acFrames[iEntry].iDecOrder );
+
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+        delete apcTokenizer[i];
+    return bSuccess;
+}
+
+void LCUIndex::xSummarizeTrees()
+{
+    /// the whole files, mapped (or read) once for all the tasks
+    QByteArray acBuffer[LCU_STREAM_NUM];
+    const char* apcData[LCU_STREAM_NUM];
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        apcData[i] = NULL;
+        if( m_aiFileSize[i] == 0 )
+            continue;
+        apcData[i] = (const char*)m_acFile[i].map(0, m_aiFileSize[i]);
+        if( apcData[i] == NULL )
+        {
+            m_acFile[i].seek(0);
+            acBuffer[i] = m_acFile[i].readAll();
+            apcData[i] = acBuffer[i].constData();
+        }
+    }
+
+    QVector<ComFrameStatistics> acResults(m_acFrames.size());
+    QThreadPool cPool;
+    cPool.setMaxThreadCount(QThread::idealThreadCount());
+    int iTaskNum = qMin(cPool.maxThreadCount(), m_acFrames.size());
+    for(int i = 0; i < iTaskNum; i++)
+    {
+        int iFirst = m_acFrames.size()*i/iTaskNum;
+        int iEnd = m_acFrames.size()*(i+1)/iTaskNum;
+        cPool.start(new FrameSummaryTask(this, iFirst, iEnd, apcData, acResults.data()));
+    }
+    cPool.waitForDone();
+
+    for(int i = 0; i < m_acFrames.size(); i++)
+        m_acFrames[i].cStatistics = acResults[i];
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        if( apcData[i] != NULL && acBuffer[i].isEmpty() )
+            m_acFile[i].unmap((uchar*)apcData[i]);
+    }
+}
+
+void LCUIndex::xSummarizeFrames(int iFirst, int iEnd, const char* apcData[LCU_STREAM_NUM], ComFrameStatistics* pcResults) const
+{
+    for(int iEntry = iFirst; iEntry < iEnd; iEntry++)
+    {
+        /// a sequence of this frame only, the trees go with it
+        ComSequence cScratch;
+        cScratch.setWidth(m_pcSequence->getWidth());
+        cScratch.setHeight(m_pcSequence->getHeight());
+        cScratch.setMaxCUSize(m_pcSequence->getMaxCUSize());
+        cScratch.setMaxCUDepth(m_pcSequence->getMaxCUDepth());
+        ComFrame* pcFrame = new ComFrame(&cScratch);
+        pcFrame->setPOC(m_acFrames[iEntry].iPoc);
+        cScratch.getFramesInDecOrder().push_back(pcFrame);
+
+        IntTokenizer* apcTokenizer[LCU_STREAM_NUM];
+        for(int i = 0; i < LCU_STREAM_NUM; i++)
+        {
+            QByteArray cFrameData;
+            if( apcData[i] != NULL )
+            {
+                qint64 iStart = m_acFrames[iEntry].aiOffset[i];
+                cFrameData = QByteArray::fromRawData(apcData[i] + iStart, int(xFrameEnd(iEntry, i) - iStart));
+            }
+            apcTokenizer[i] = new IntTokenizer(cFrameData);
+        }
+        LCUInfoParser cLCUInfoParser;
+        if( cLCUInfoParser.parseFile(apcTokenizer, &cScratch) )
+        {
+            ComStatistics::computeFrame(pcFrame);
+            pcResults[iEntry] = pcFrame->getStatistics();
+        }
+        for(int i = 0; i < LCU_STREAM_NUM; i++)
+            delete apcTokenizer[i];
+    }
+}
+
+qint64 LCUIndex::xFrameEnd(int iEntry, int iStream) const
+{
+    if( iEntry+1 < m_acFrames.size() )
+        return m_acFrames[iEntry+1].aiOffset[iStream];
+    return m_aiFileSize[iStream];
+}
+
+bool LCUIndex::xBuild()
+{
+    QVector<qint64> aaiOffsets[LCU_STREAM_NUM];
+    QVector<int> aiBitCounts;
+    QVector<int> aiPocs;
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        if( !xScanStream(i, aaiOffsets[i], i == LCU_STREAM_BIT_LCU ? &aiBitCounts : NULL,
+                         i == LCU_STREAM_CUPU ? &aiPocs : NULL) )
+            return false;
+        if( m_aiFileSize[i] == 0 )
+            continue;
+        if( aaiOffsets[i].size() != aaiOffsets[LCU_STREAM_CUPU].size() )
+        {
+            qCritical() << "LCUIndex Error! Decoder output files do not have the same frames";
+            return false;
+        }
+    }
+
+    m_acFrames.resize(aaiOffsets[LCU_STREAM_CUPU].size());
+    for(int iFrame = 0; iFrame < m_acFrames.size(); iFrame++)
+    {
+        for(int i = 0; i < LCU_STREAM_NUM; i++)
+            m_acFrames[iFrame].aiOffset[i] = m_aiFileSize[i] == 0 ? 0 : aaiOffsets[i][iFrame];
+        m_acFrames[iFrame].iBitCount = aiBitCounts.empty() ? 0 : aiBitCounts[iFrame];
+        m_acFrames[iFrame].iPoc = aiPocs[iFrame];
+        m_acFrames[iFrame].iDecOrder = -1;
+    }
+    return true;
+}
+
+bool LCUIndex::xScanStream(int iStream, QVector<qint64>& raiOffsets, QVector<int>* paiBitCounts, QVector<int>* paiPocs)
+{
+    QFile& rcFile = m_acFile[iStream];
+    qint64 iSize = m_aiFileSize[iStream];
+    raiOffsets.clear();
+    if( iSize == 0 )
+        return true;
+
+    /// memory-map the whole file if possible (same as IntTokenizer)
+    QByteArray cBuffer;
+    const char* pcData = (const char*)rcFile.map(0, iSize);
+    if( pcData == NULL )
+    {
+        rcFile.seek(0);
+        cBuffer = rcFile.readAll();
+        pcData = cBuffer.constData();
+    }
+
+    /// <poc,addr> ... a new POC starts a new frame (same as the parsers)
+    const char* pcEnd = pcData + iSize;
+    const char* pcLine = pcData;
+    int iLastPOC = 0;
+    while( pcLine < pcEnd )
+    {
+        const char* pcLineEnd = (const char*)memchr(pcLine, '\n', pcEnd-pcLine);
+        if( pcLineEnd == NULL )
+            pcLineEnd = pcEnd;
+        if( *pcLine == '<' )
+        {
+            int iPoc = (int)strtol(pcLine+1, NULL, 10);
+            if( raiOffsets.empty() || iPoc != iLastPOC )
+            {
+                raiOffsets.push_back(pcLine - pcData);
+                if( paiBitCounts )
+                    paiBitCounts->push_back(0);
+                if( paiPocs )
+                    paiPocs->push_back(iPoc);
+            }
+            iLastPOC = iPoc;
+            const char* pcHeaderEnd = (const char*)memchr(pcLine, '>', pcLineEnd-pcLine);
+            if( paiBitCounts && pcHeaderEnd )
+                paiBitCounts->back() += (int)strtol(pcHeaderEnd+1, NULL, 10);
+        }
+        pcLine = pcLineEnd + 1;
+    }
+
+    if( cBuffer.isEmpty() )
+        rcFile.unmap((uchar*)pcData);
+    return true;
+}
+
+bool LCUIndex::xLoad(const QString& strIndexFile)
+{
+    QFile cIndexFile(strIndexFile);
+    if( !cIndexFile.open(QIODevice::ReadOnly) )
+        return false;
+    QDataStream cIn(&cIndexFile);
+
+    quint32 uiMagic, uiVersion, uiStreamNum, uiFrameNum;
+    cIn >> uiMagic >> uiVersion >> uiStreamNum;
+    if( uiMagic != LCU_INDEX_MAGIC || uiVersion != LCU_INDEX_VERSION || uiStreamNum != LCU_STREAM_NUM )
+        return false;
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        qint64 iFileSize;
+        cIn >> iFileSize;
+        if( iFileSize != m_aiFileSize[i] )
+            return false;
+    }
+    cIn >> uiFrameNum;
+    if( cIn.status() != QDataStream::Ok )
+        return false;
+
+    QVector<FrameEntry> acFrames(uiFrameNum);
+    for(quint32 iFrame = 0; iFrame < uiFrameNum; iFrame++)
+    {
+        for(int i = 0; i < LCU_STREAM_NUM; i++)
+            cIn >> acFrames[iFrame].aiOffset[i];
+        qint32 iBitCount, iPoc;
+        cIn >> iBitCount >> iPoc;
+        acFrames[iFrame].iBitCount = iBitCount;
+        acFrames[iFrame].iPoc = iPoc;
+        acFrames[iFrame].iDecOrder = -1;
+        xReadStatistics(cIn, acFrames[iFrame].cStatistics);
+    }
+    if( cIn.status() != QDataStream::Ok )
+        return false;
+    m_acFrames = acFrames;
+    return true;
+}
+
+bool LCUIndex::xSave(const QString& strIndexFile)
+{
+    QFile cIndexFile(strIndexFile);
+    if( !cIndexFile.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+        return false;
+    QDataStream cOut(&cIndexFile);
+
+    cOut << (quint32)LCU_INDEX_MAGIC << (quint32)LCU_INDEX_VERSION << (quint32)LCU_STREAM_NUM;
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+        cOut << m_aiFileSize[i];
+    cOut << (quint32)m_acFrames.size();
+    foreach(const FrameEntry& rcFrame, m_acFrames)
+    {
+        for(int i = 0; i < LCU_STREAM_NUM; i++)
+            cOut << rcFrame.aiOffset[i];
+        cOut << (qint32)rcFrame.iBitCount << (qint32)rcFrame.iPoc;
+        xWriteStatistics(cOut, rcFrame.cStatistics);
+    }
+    return cOut.status() == QDataStream::Ok;
+}
@@ -0,0 +1,69 @@
+#ifndef LCUINDEX_H
+#define LCUINDEX_H
+
+#include <QFile>
+#include <QVector>
+#include <QHash>
+#include "model/common/comsequence.h"
+#include "model/common/comlculoader.h"
+#include "parsers/lcuinfoparser.h"
+
+/*!
+ * \brief The LCUIndex class
+ * byte offset of each frame in every per-LCU decoder output file (decoder_cupu.txt, ...),
+ * so the CU trees of a frame can be parsed when the frame is visited instead of at open time.
+ * The index is built by one scan over the files and saved to decoder_lcu_index.bin next to them,
+ * a later open of the same (cached) output reads it back. The frame bit counts are kept
+ * in the index as well, they are known before any tree is loaded. So are the tree summaries of
+ * the frames (see ComStatistics): when the index is built every frame is parsed once, in parallel,
+ * into a scratch sequence which is dropped right after.
+ * Missing files (categories the decoder did not write) are skipped, and a frame out of
+ * the decoder's POC window has no entry: it is loaded without any LCU.
+ */
+
+class LCUIndex : public ComLCULoader
+{
+public:
+    LCUIndex();
+    ~LCUIndex();
+
+    /*!
+     * \brief open read or build the index of the files in strFolder
+     * \param pcSequence frames in decoding order must be known, their bit counts and statistics are set here
+     */
+    bool open(const QString& strFolder, ComSequence* pcSequence);
+
+    /// parse the byte range of pcFrame in every file
+    bool loadLCUs(ComFrame* pcFrame);
+
+protected:
+    friend class FrameSummaryTask;
+
+    /// one frame: where it starts in every file (it ends where the next frame starts)
+    struct FrameEntry
+    {
+        qint64 aiOffset[LCU_STREAM_NUM];
+        int iBitCount;
+        int iPoc;
+        int iDecOrder;                              ///< in the sequence, not saved
+        ComFrameStatistics cStatistics;             ///< of its CU trees, see xSummarizeTrees()
+    };
+
+    bool xBuild();
+    /// parse every frame once to get its statistics (in parallel)
+    void xSummarizeTrees();
+    /// frames [iFirst, iEnd), apcData are the whole files, one summary per frame into pcResults
+    void xSummarizeFrames(int iFirst, int iEnd, const char* apcData[LCU_STREAM_NUM], ComFrameStatistics* pcResults) const;
+    bool xScanStream(int iStream, QVector<qint64>& raiOffsets, QVector<int>* paiBitCounts, QVector<int>* paiPocs);
+    bool xLoad(const QString& strIndexFile);
+    bool xSave(const QString& strIndexFile);
+    qint64 xFrameEnd(int iEntry, int iStream) const;
+
+    ComSequence* m_pcSequence;
+    QFile m_acFile[LCU_STREAM_NUM];
+    qint64 m_aiFileSize[LCU_STREAM_NUM];
+    QVector<FrameEntry> m_acFrames;                 ///< frames of the files, in decoding order
+    QHash<const ComFrame*, int> m_cEntry;           ///< entry of each frame in m_acFrames
+};
+
+#endif // LCUINDEX_H
@@ -0,0 +1,267 @@
+#include "lcuinfoparser.h"
+#include <QtAlgorithms>
+#include <QDebug>
+
+#define CU_SLIPT_FLAG 99      ///< CU splitting flag in file
+#define TU_SLIPT_FLAG 99      ///< TU splitting flag in file
+
+const char* g_apchLCUFiles[LCU_STREAM_NUM] =
+{
+    "/decoder_cupu.txt", "/decoder_tu.txt", "/decoder_pred.txt", "/decoder_mv.txt",
+    "/decoder_merge.txt", "/decoder_intra.txt", "/decoder_bit_lcu.txt", "/decoder_bit_scu.txt"
+};
+
+/// for CU sorting in Addr ascending order
+static bool xCUSortingOrder(const ComCU* pcCUFirst, const ComCU* pcCUSecond)
+{
+    return (*pcCUFirst < *pcCUSecond);
+}
+
+LCUInfoParser::LCUInfoParser(QObject *parent) :
+    QObject(parent),
+    m_apcTokenizers(NULL)
+{
+}
+
+
+bool LCUInfoParser::parseFile(IntTokenizer* apcTokenizers[LCU_STREAM_NUM], ComSequence* pcSequence, int iFirstDecOrder)
+{
+    Q_ASSERT( pcSequence != NULL );
+
+    int iSeqWidth = pcSequence->getWidth();
+    int iMaxCUSize = pcSequence->getMaxCUSize();
+    int iCUOneRow = (iSeqWidth+iMaxCUSize-1)/iMaxCUSize;
+
+    m_apcTokenizers = apcTokenizers;
+    /// a category the decoder was told not to write has no line at all, its attributes keep their defaults
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+        m_abStreamPresent[i] = !apcTokenizers[i]->atEnd();
+
+    ComFrame* pcFrame = NULL;
+    int iDecOrder = iFirstDecOrder-1;
+    int iLastPOC  = -1;
+    int iPoc, iAddr;
+    while( apcTokenizers[LCU_STREAM_CUPU]->readLCUHeader(iPoc, iAddr) )
+    {
+        /// read the line of the same LCU from every file
+        for(int i = LCU_STREAM_CUPU+1; i < LCU_STREAM_NUM; i++)
+        {
+            if( !m_abStreamPresent[i] )
+                continue;
+            int iStreamPoc = 0, iStreamAddr = 0;
+            if( !apcTokenizers[i]->readLCUHeader(iStreamPoc, iStreamAddr) ||
+                iStreamPoc != iPoc || iStreamAddr != iAddr )
+            {
+                qCritical() << "LCUInfoParser Error! Decoder output files out of sync at LCU"
+                            << iPoc << iAddr;
+                m_apcTokenizers = NULL;
+                return false;
+            }
+        }
+
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+        {
+            /// sort LCU of the finished frame in ascending order
+            if( pcFrame != NULL )
+                qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(), xCUSortingOrder);
+            /// frames out of the decoder's POC window have no line
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+            iLastPOC = iPoc;
+            if( iDecOrder < 0 )
+            {
+                qCritical() << "LCUInfoParser Error! No frame of POC" << iPoc;
+                m_apcTokenizers = NULL;
+                return false;
+            }
+            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        }
+
+        ComCU* pcLCU = pcFrame->getArena().newCUs(pcFrame, 1);
+        pcLCU->setAddr(iAddr);
+        pcLCU->setFrame(pcFrame);
+        pcLCU->setDepth(0);
+        pcLCU->setZorder(0);
+        pcLCU->setSize(iMaxCUSize);
+        pcLCU->setX((iAddr%iCUOneRow)*iMaxCUSize);
+        pcLCU->setY((iAddr/iCUOneRow)*iMaxCUSize);
+        pcFrame->getLCUs().push_back(pcLCU);
+
+        /// CU&PU quad-tree with all attributes in one walk
+        if( xReadCU(pcLCU) == false )
+        {
+            m_apcTokenizers = NULL;
+            return false;
+        }
+
+        /// LCU bits
+        int iLCUBit = 0;
+        if( m_abStreamPresent[LCU_STREAM_BIT_LCU] )
+            apcTokenizers[LCU_STREAM_BIT_LCU]->readInt(iLCUBit);
+        pcLCU->setBitCount(iLCUBit);
+        pcFrame->getBitCount() += iLCUBit;
+    }
+
+    if( pcFrame != NULL )
+        qSort(pcFrame->getLCUs().begin(), pcFrame->getLCUs().end(), xCUSortingOrder);
+
+    m_apcTokenizers = NULL;
+    return true;
+}
+
+
+bool LCUInfoParser::xReadCU(ComCU* pcCU)
+{
+    int iCUMode;
+    if( !m_apcTokenizers[LCU_STREAM_CUPU]->readInt(iCUMode) )
+    {
+        qCritical() << "LCUInfoParser Error! Illegal CU/PU Mode!";
+        return false;
+    }
+
+    if( iCUMode == CU_SLIPT_FLAG )
+    {
+        int iMaxDepth = pcCU->getFrame()->getSequence()->getMaxCUDepth();
+        int iTotalNumPart = 1 << ( (iMaxDepth-pcCU->getDepth()) << 1 );
+        /// non-leaf node : add 4 children CUs
+        ComCU* pcChildren = pcCU->getFrame()->getArena().newCUs(pcCU->getFrame(), 4);
+        pcCU->setSCUs(pcChildren, 4);
+        for(int i = 0; i < 4; i++)
+        {
+            ComCU* pcChildNode = &pcChildren[i];
+            pcChildNode->setAddr(pcCU->getAddr());
+            pcChildNode->setDepth(pcCU->getDepth()+1);
+            pcChildNode->setZorder( pcCU->getZorder() + (iTotalNumPart/4)*i );
+            pcChildNode->setSize(pcCU->getSize()/2);
+            pcChildNode->setX(pcCU->getX() + i%2 * (pcCU->getSize()/2));
+            pcChildNode->setY(pcCU->getY() + i/2 * (pcCU->getSize()/2));
+            if( xReadCU(pcChildNode) == false )
+                return false;
+        }
+        return true;
+    }
+
+    /// leaf node : PUs
+    pcCU->setPartSize((PartSize)iCUMode);
+    int iPUCount = ComCU::getPUNum((PartSize)iCUMode);
+    ComPU* pcPUs = pcCU->getFrame()->getArena().newPUs(pcCU, iPUCount);
+    pcCU->setPUs(pcPUs, iPUCount);
+    for(int i = 0; i < iPUCount; i++)
+    {
+        ComPU* pcPU = &pcPUs[i];
+        int iPUOffsetX, iPUOffsetY, iPUWidth, iPUHeight;
+        ComCU::getPUOffsetAndSize(pcCU->getSize(), (PartSize)iCUMode, i, iPUOffsetX, iPUOffsetY, iPUWidth, iPUHeight);
+        pcPU->setX(pcCU->getX() + iPUOffsetX);
+        pcPU->setY(pcCU->getY() + iPUOffsetY);
+        pcPU->setWidth(iPUWidth);
+        pcPU->setHeight(iPUHeight);
+    }
+
+    /// leaf node : TU quad-tree
+    ComTU* pcTURoot = &pcCU->getTURoot();
+    pcTURoot->setX(pcCU->getX());
+    pcTURoot->setY(pcCU->getY());
+    pcTURoot->setSize(pcCU->getSize());
+    if( m_abStreamPresent[LCU_STREAM_TU] && xReadTU(&pcCU->getFrame()->getArena(), pcTURoot) == false )
+        return false;
+
+    /// leaf node : PU attributes
+    for(int i = 0; i < pcCU->getPUs().size(); i++)
+    {
+        if( xReadPU(pcCU->getPUs().at(i)) == false )
+            return false;
+    }
+
+    /// leaf node : bits
+    int iSCUBit;
+    if( m_abStreamPresent[LCU_STREAM_BIT_SCU] )
+    {
+        if( !m_apcTokenizers[LCU_STREAM_BIT_SCU]->readInt(iSCUBit) )
+            return false;
+        pcCU->setBitCount(iSCUBit);
+    }
+
+    return true;
+}
+
+
+bool LCUInfoParser::xReadTU(ComArena* pcArena, ComTU* pcTU)
+{
+    int iTUMode;
+    if( !m_apcTokenizers[LCU_STREAM_TU]->readInt(iTUMode) )
+    {
+        qCritical() << "LCUInfoParser Error! Illegal TU Mode!";
+        return false;
+    }
+
+    if( iTUMode == TU_SLIPT_FLAG )
+    {
+        /// non-leaf node : add 4 children TUs
+        ComTU* pcChildren = pcArena->newTUs(4);
+        pcTU->setTUs(pcChildren, 4);
+        for(int i = 0; i < 4; i++)
+        {
+            ComTU* pcChildNode = &pcChildren[i];
+            pcChildNode->setSize(pcTU->getSize()/2);
+            pcChildNode->setX(pcTU->getX() + i%2 * (pcTU->getSize()/2));
+            pcChildNode->setY(pcTU->getY() + i/2 * (pcTU->getSize()/2));
+            if( xReadTU(pcArena, pcChildNode) == false )
+                return false;
+        }
+    }
+    return true;
+}
+
+
+bool LCUInfoParser::xReadPU(ComPU* pcPU)
+{
+    /// prediction mode
+    int iPredMode;
+    if( m_abStreamPresent[LCU_STREAM_PRED] )
+    {
+        if( !m_apcTokenizers[LCU_STREAM_PRED]->readInt(iPredMode) )
+            return false;
+        pcPU->setPredMode((PredMode)iPredMode);
+    }
+
+    /// motion vectors
+    IntTokenizer* pcMVTokenizer = m_apcTokenizers[LCU_STREAM_MV];
+    int iInterDir = 0;
+    if( m_abStreamPresent[LCU_STREAM_MV] )
+    {
+        if( !pcMVTokenizer->readInt(iInterDir) )
+            return false;
+        pcPU->setInterDir(iInterDir);
+    }
+    int iMVNum = (iInterDir == 3) ? 2 : ((iInterDir == 1 || iInterDir == 2) ? 1 : 0);
+    for(int i = 0; i < iMVNum; i++)
+    {
+        int iRefPOC, iHor, iVer;
+        if( !pcMVTokenizer->readInt(iRefPOC) || !pcMVTokenizer->readInt(iHor) || !pcMVTokenizer->readInt(iVer) )
+            return false;
+        ComMV cReadMV(iHor, iVer);
+        cReadMV.setRefPOC(iRefPOC);
+        pcPU->getMVs().push_back(cReadMV);
+    }
+
+    /// merge index
+    int iMergeIndex;
+    if( m_abStreamPresent[LCU_STREAM_MERGE] )
+    {
+        if( !m_apcTokenizers[LCU_STREAM_MERGE]->readInt(iMergeIndex) )
+            return false;
+        pcPU->setMergeIndex(iMergeIndex);
+    }
+
+    /// intra direction
+    IntTokenizer* pcIntraTokenizer = m_apcTokenizers[LCU_STREAM_INTRA];
+    if( !m_abStreamPresent[LCU_STREAM_INTRA] )
+        return true;
+    int iIntraDirLuma, iIntraDirChroma;
+    if( !pcIntraTokenizer->readInt(iIntraDirLuma) || !pcIntraTokenizer->readInt(iIntraDirChroma) )
+        return false;
+    pcPU->setIntraDirLuma(iIntraDirLuma);
+    pcPU->setIntraDirChroma(iIntraDirChroma);
+
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef LCUINFOPARSER_H
+#define LCUINFOPARSER_H
+
+#include <QObject>
+#include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
+
+/// per-LCU decoder output files, one line per LCU in each of them
+enum LCUInfoStream
+{
+    LCU_STREAM_CUPU = 0,    ///< decoder_cupu.txt
+    LCU_STREAM_TU,          ///< decoder_tu.txt
+    LCU_STREAM_PRED,        ///< decoder_pred.txt
+    LCU_STREAM_MV,          ///< decoder_mv.txt
+    LCU_STREAM_MERGE,       ///< decoder_merge.txt
+    LCU_STREAM_INTRA,       ///< decoder_intra.txt
+    LCU_STREAM_BIT_LCU,     ///< decoder_bit_lcu.txt
+    LCU_STREAM_BIT_SCU,     ///< decoder_bit_scu.txt
+    LCU_STREAM_NUM
+};
+
+/// file name of each LCUInfoStream, with a leading '/' (defined in lcuinfoparser.cpp)
+extern const char* g_apchLCUFiles[LCU_STREAM_NUM];
+
+/*!
+ * \brief The LCUInfoParser class
+ * this class parses all the per-LCU decoder output files in one pass.
+ * The files are advanced in lockstep (line N of every file describes the same LCU),
+ * each LCU is built from the CU&PU structure and the TU, prediction, MV, merge,
+ * intra and bit info are attached in the same tree walk.
+ * It produces the same result as running CUPUParser, TUParser, PredParser, MVParser,
+ * MergeParser, IntraParser and BitParser one after another.
+ * An empty stream is a category the decoder did not write, it is skipped.
+ */
+
+class LCUInfoParser : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LCUInfoParser(QObject *parent = 0);
+    /*!
+     * \brief parseFile
+     * \param apcTokenizers input file tokenizers, indexed by LCUInfoStream
+     * \param pcSequence output sequence
+     * \param iFirstDecOrder decoding order of the first frame in the files
+     * \return
+     */
+    bool parseFile(IntTokenizer* apcTokenizers[LCU_STREAM_NUM], ComSequence* pcSequence, int iFirstDecOrder = 0);
+
+protected:
+    bool xReadCU(ComCU* pcCU);
+    bool xReadTU(ComArena* pcArena, ComTU* pcTU);
+    bool xReadPU(ComPU* pcPU);
+
+    IntTokenizer** m_apcTokenizers;                 ///< tokenizers of the current parseFile() call
+    bool m_abStreamPresent[LCU_STREAM_NUM];          ///< the decoder wrote this category (see AnalysisCategories)
+
+signals:
+
+public slots:
+
+};
+
+#endif // LCUINFOPARSER_H
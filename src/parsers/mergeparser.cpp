@@ -1,61 +1,58 @@
 #include "mergeparser.h"
-#include <QRegExp>
+#include <QDebug>
 
 MergeParser::MergeParser(QObject *parent) :
     QObject(parent)
 {
 }
+
 bool MergeParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
 {
-    Q_ASSERT( pcSequence != NULL );
-
-    QString strOneLine;
-    QRegExp cMatchTarget;
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
 
+bool MergeParser::parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
 
     /// <1,0> -1 0 0 -1 1
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-    QTextStream cMergeInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-            ///
-            QString strMergeInfo = cMatchTarget.cap(3);
-            cMergeInfoStream.setString( &strMergeInfo, QIODevice::ReadOnly );
-            xReadMergeIndex(&cMergeInfoStream, pcLCU);
-
+            qCritical() << "MergeParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        xReadMergeIndex(pcTokenizer, pcLCU);
     }
     return true;
 }
 
-bool MergeParser::xReadMergeIndex(QTextStream* pcMergeIndexStream, ComCU* pcCU)
+bool MergeParser::xReadMergeIndex(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     if( !pcCU->getSCUs().empty() )
     {
         /// non-leaf node : recursive reading for children
-        xReadMergeIndex(pcMergeIndexStream, pcCU->getSCUs().at(0));
-        xReadMergeIndex(pcMergeIndexStream, pcCU->getSCUs().at(1));
-        xReadMergeIndex(pcMergeIndexStream, pcCU->getSCUs().at(2));
-        xReadMergeIndex(pcMergeIndexStream, pcCU->getSCUs().at(3));
+        xReadMergeIndex(pcTokenizer, pcCU->getSCUs().at(0));
+        xReadMergeIndex(pcTokenizer, pcCU->getSCUs().at(1));
+        xReadMergeIndex(pcTokenizer, pcCU->getSCUs().at(2));
+        xReadMergeIndex(pcTokenizer, pcCU->getSCUs().at(3));
     }
     else
     {
@@ -63,8 +60,8 @@ bool MergeParser::xReadMergeIndex(QTextStream* pcMergeIndexStream, ComCU* pcCU)
         int iMergeIndex;
         for(int i = 0; i < pcCU->getPUs().size(); i++)
         {
-            Q_ASSERT(pcMergeIndexStream->atEnd() == false);
-            *pcMergeIndexStream >> iMergeIndex;
+            if( !pcTokenizer->readInt(iMergeIndex) )
+                return false;
             pcCU->getPUs().at(i)->setMergeIndex(iMergeIndex);
         }
     }
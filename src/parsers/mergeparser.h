@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 
 class MergeParser : public QObject
 {
@@ -11,8 +12,9 @@ class MergeParser : public QObject
 public:
     explicit MergeParser(QObject *parent = 0);
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 protected:
-    bool xReadMergeIndex(QTextStream* pcMergeIndexStream, ComCU* pcCU);
+    bool xReadMergeIndex(IntTokenizer* pcTokenizer, ComCU* pcCU);
 signals:
 
 public slots:
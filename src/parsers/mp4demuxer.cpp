@@ -0,0 +1,385 @@
+#include "mp4demuxer.h"
+#include <QList>
+#include <QPair>
+#include <QDebug>
+
+#define MP4_FOURCC(a, b, c, d)  ((quint32(a) << 24) | (quint32(b) << 16) | (quint32(c) << 8) | quint32(d))
+#define MP4_MAX_HEADER_BOX      (256 << 20)     ///< largest moov or moof box read into memory
+#define MP4_VISUAL_ENTRY_SIZE   78              ///< VisualSampleEntry fields in front of its child boxes
+
+static quint32 xU16(const uchar* puc) { return (quint32(puc[0]) << 8) | puc[1]; }
+static quint32 xU32(const uchar* puc) { return (quint32(puc[0]) << 24) | (quint32(puc[1]) << 16) | (quint32(puc[2]) << 8) | puc[3]; }
+static quint64 xU64(const uchar* puc) { return (quint64(xU32(puc)) << 32) | xU32(puc+4); }
+
+/// the box at riPos in [riPos, iEnd), riPos moves behind it
+static bool xNextBox(const uchar* pucData, int& riPos, int iEnd, quint32& ruiType, int& riBody, int& riBoxEnd)
+{
+    if( riPos + 8 > iEnd )
+        return false;
+    quint64 uiSize = xU32(pucData + riPos);
+    ruiType = xU32(pucData + riPos + 4);
+    riBody = riPos + 8;
+    if( uiSize == 1 )
+    {
+        if( riPos + 16 > iEnd )
+            return false;
+        uiSize = xU64(pucData + riPos + 8);
+        riBody += 8;
+    }
+    else if( uiSize == 0 )      ///< up to the end
+    {
+        uiSize = iEnd - riPos;
+    }
+    if( uiSize < quint64(riBody - riPos) || uiSize > quint64(iEnd - riPos) )
+        return false;
+    riBoxEnd = riPos + int(uiSize);
+    riPos = riBoxEnd;
+    return true;
+}
+
+/// body of the first box at pchPath (e.g. "mdia/minf/stbl/stsz") below [iStart, iEnd)
+static bool xFindBox(const uchar* pucData, int iStart, int iEnd, const char* pchPath, int& riBody, int& riBodyEnd)
+{
+    quint32 uiWanted = MP4_FOURCC(pchPath[0], pchPath[1], pchPath[2], pchPath[3]);
+    int iPos = iStart;
+    quint32 uiType;
+    int iBody, iBoxEnd;
+    while( xNextBox(pucData, iPos, iEnd, uiType, iBody, iBoxEnd) )
+    {
+        if( uiType != uiWanted )
+            continue;
+        if( pchPath[4] == '\0' )
+        {
+            riBody = iBody;
+            riBodyEnd = iBoxEnd;
+            return true;
+        }
+        return xFindBox(pucData, iBody, iBoxEnd, pchPath + 5, riBody, riBodyEnd);
+    }
+    return false;
+}
+
+MP4Demuxer::MP4Demuxer()
+{
+    m_iLengthSize = 4;
+    m_iTrackId = -1;
+    m_iNextSample = 0;
+}
+
+bool MP4Demuxer::open(const QString& strFilePath)
+{
+    m_cFile.setFileName(strFilePath);
+    if( !m_cFile.open(QIODevice::ReadOnly) )
+        return false;
+
+    /// top level boxes, the media data is skipped
+    QList< QPair<qint64, QByteArray> > acMoofs;
+    qint64 iFileSize = m_cFile.size();
+    qint64 iPos = 0;
+    while( iPos + 8 <= iFileSize )
+    {
+        m_cFile.seek(iPos);
+        QByteArray cHeader = m_cFile.read(16);
+        const uchar* pucHeader = (const uchar*)cHeader.constData();
+        quint64 uiSize = xU32(pucHeader);
+        quint32 uiType = xU32(pucHeader + 4);
+        int iHeader = 8;
+        if( uiSize == 1 && cHeader.size() == 16 )
+        {
+            uiSize = xU64(pucHeader + 8);
+            iHeader = 16;
+        }
+        else if( uiSize == 0 )
+        {
+            uiSize = iFileSize - iPos;
+        }
+        if( uiSize < quint64(iHeader) )
+        {
+            qWarning() << "Broken MP4 box at" << iPos;
+            break;
+        }
+
+        if( uiType == MP4_FOURCC('m','o','o','v') || uiType == MP4_FOURCC('m','o','o','f') )
+        {
+            if( uiSize > MP4_MAX_HEADER_BOX )
+            {
+                qCritical() << "MP4 header box too large at" << iPos;
+                return false;
+            }
+            m_cFile.seek(iPos);
+            QByteArray cBox = m_cFile.read(int(uiSize));
+            if( cBox.size() != int(uiSize) )
+                break;
+            if( uiType == MP4_FOURCC('m','o','o','v') )
+                xParseMoov(cBox, iHeader);
+            else
+                acMoofs.push_back(qMakePair(iPos, cBox));
+        }
+        iPos += uiSize;
+    }
+    if( m_iTrackId < 0 )
+    {
+        qCritical() << "No HEVC track in" << strFilePath;
+        return false;
+    }
+
+    /// movie fragments need the track (and its defaults) of the moov box
+    for(int i = 0; i < acMoofs.size(); i++)
+        xParseMoof(acMoofs[i].second, 8, acMoofs[i].first);
+    if( m_acSamples.empty() )
+    {
+        qCritical() << "HEVC track without samples in" << strFilePath;
+        return false;
+    }
+    m_iNextSample = 0;
+    m_iBytesRead = 0;
+    return true;
+}
+
+bool MP4Demuxer::readAccessUnit(QByteArray& rcAnnexB)
+{
+    if( m_iNextSample >= m_acSamples.size() )
+        return false;
+    const Sample& rcSample = m_acSamples[m_iNextSample++];
+    if( m_iNextSample == 1 )
+        rcAnnexB.append(m_cParamSets);
+
+    if( !m_cFile.seek(rcSample.iOffset) )
+        return false;
+    QByteArray cData = m_cFile.read(rcSample.uiSize);
+    if( cData.size() != int(rcSample.uiSize) )
+    {
+        qCritical() << "MP4 file truncated at sample" << m_iNextSample-1;
+        return false;
+    }
+
+    /// length prefixes to start codes
+    const uchar* pucData = (const uchar*)cData.constData();
+    int iPos = 0;
+    while( iPos + m_iLengthSize <= cData.size() )
+    {
+        quint32 uiLength = 0;
+        for(int i = 0; i < m_iLengthSize; i++)
+            uiLength = (uiLength << 8) | pucData[iPos+i];
+        iPos += m_iLengthSize;
+        if( uiLength > quint32(cData.size() - iPos) )
+        {
+            qWarning() << "Broken NAL unit length in sample" << m_iNextSample-1;
+            break;
+        }
+        rcAnnexB.append("\0\0\0\1", 4);
+        rcAnnexB.append(cData.constData() + iPos, int(uiLength));
+        iPos += uiLength;
+    }
+    m_iBytesRead = rcSample.iOffset + rcSample.uiSize;
+    return true;
+}
+
+bool MP4Demuxer::xParseMoov(const QByteArray& rcMoov, int iBody)
+{
+    const uchar* pucData = (const uchar*)rcMoov.constData();
+    int iPos = iBody;
+    quint32 uiType;
+    int iBoxBody, iBoxEnd;
+    while( xNextBox(pucData, iPos, rcMoov.size(), uiType, iBoxBody, iBoxEnd) )
+    {
+        if( uiType == MP4_FOURCC('t','r','a','k') && m_iTrackId < 0 )
+        {
+            xParseTrak(pucData, iBoxBody, iBoxEnd);
+        }
+        else if( uiType == MP4_FOURCC('m','v','e','x') )
+        {
+            /// trex: version & flags, track_ID, default_sample_description_index, _duration, _size, _flags
+            int iExPos = iBoxBody;
+            quint32 uiExType;
+            int iExBody, iExEnd;
+            while( xNextBox(pucData, iExPos, iBoxEnd, uiExType, iExBody, iExEnd) )
+            {
+                if( uiExType == MP4_FOURCC('t','r','e','x') && iExBody + 20 <= iExEnd )
+                    m_cDefaultSizes[xU32(pucData + iExBody + 4)] = xU32(pucData + iExBody + 16);
+            }
+        }
+    }
+    return m_iTrackId >= 0;
+}
+
+bool MP4Demuxer::xParseTrak(const uchar* pucData, int iStart, int iEnd)
+{
+    int iBody, iEnd2;
+
+    /// a video track with an HEVC sample entry
+    if( !xFindBox(pucData, iStart, iEnd, "mdia/hdlr", iBody, iEnd2) || iBody + 12 > iEnd2 ||
+        xU32(pucData + iBody + 8) != MP4_FOURCC('v','i','d','e') )
+        return false;
+    if( !xFindBox(pucData, iStart, iEnd, "mdia/minf/stbl/stsd", iBody, iEnd2) || iBody + 16 > iEnd2 )
+        return false;
+    int iEntry = iBody + 8;
+    int iEntryEnd = iEntry + int(xU32(pucData + iEntry));
+    quint32 uiFormat = xU32(pucData + iEntry + 4);
+    if( uiFormat != MP4_FOURCC('h','v','c','1') && uiFormat != MP4_FOURCC('h','e','v','1') )
+        return false;
+    if( iEntryEnd > iEnd2 ||
+        !xFindBox(pucData, iEntry + 8 + MP4_VISUAL_ENTRY_SIZE, iEntryEnd, "hvcC", iBody, iEnd2) ||
+        !xParseHvcC(pucData + iBody, iEnd2 - iBody) )
+        return false;
+
+    /// track id (tkhd version 0: 32-bit times, version 1: 64-bit times)
+    if( !xFindBox(pucData, iStart, iEnd, "tkhd", iBody, iEnd2) || iBody + 24 > iEnd2 )
+        return false;
+    m_iTrackId = int(xU32(pucData + iBody + (pucData[iBody] == 1 ? 20 : 12)));
+
+    /// the samples of the moov box (none in a fragmented file)
+    int iSzBody, iSzEnd, iScBody, iScEnd, iCoBody, iCoEnd;
+    bool bCo64 = false;
+    if( !xFindBox(pucData, iStart, iEnd, "mdia/minf/stbl/stsz", iSzBody, iSzEnd) ||
+        !xFindBox(pucData, iStart, iEnd, "mdia/minf/stbl/stsc", iScBody, iScEnd) )
+        return true;
+    if( !xFindBox(pucData, iStart, iEnd, "mdia/minf/stbl/stco", iCoBody, iCoEnd) )
+    {
+        if( !xFindBox(pucData, iStart, iEnd, "mdia/minf/stbl/co64", iCoBody, iCoEnd) )
+            return true;
+        bCo64 = true;
+    }
+    if( iSzBody + 12 > iSzEnd || iScBody + 8 > iScEnd || iCoBody + 8 > iCoEnd )
+        return true;
+
+    quint32 uiConstSize = xU32(pucData + iSzBody + 4);
+    int iSampleNum = int(xU32(pucData + iSzBody + 8));
+    int iStscNum = int(xU32(pucData + iScBody + 4));
+    int iChunkNum = int(xU32(pucData + iCoBody + 4));
+    if( (uiConstSize == 0 && iSzBody + 12 + qint64(iSampleNum)*4 > iSzEnd) ||
+        iScBody + 8 + qint64(iStscNum)*12 > iScEnd ||
+        iCoBody + 8 + qint64(iChunkNum)*(bCo64 ? 8 : 4) > iCoEnd )
+    {
+        qWarning() << "Broken MP4 sample table";
+        return true;
+    }
+    m_acSamples.reserve(iSampleNum);
+    int iSample = 0;
+    int iStsc = 0;
+    for(int iChunk = 0; iChunk < iChunkNum && iSample < iSampleNum; iChunk++)
+    {
+        /// stsc entries: first_chunk (1-based), samples_per_chunk, sample_description_index
+        while( iStsc+1 < iStscNum && int(xU32(pucData + iScBody + 8 + (iStsc+1)*12)) <= iChunk+1 )
+            iStsc++;
+        int iPerChunk = iStscNum > 0 ? int(xU32(pucData + iScBody + 8 + iStsc*12 + 4)) : 0;
+        qint64 iOffset = bCo64 ? qint64(xU64(pucData + iCoBody + 8 + iChunk*8))
+                               : qint64(xU32(pucData + iCoBody + 8 + iChunk*4));
+        for(int i = 0; i < iPerChunk && iSample < iSampleNum; i++, iSample++)
+        {
+            Sample cSample;
+            cSample.iOffset = iOffset;
+            cSample.uiSize = uiConstSize ? uiConstSize : xU32(pucData + iSzBody + 12 + iSample*4);
+            m_acSamples.push_back(cSample);
+            iOffset += cSample.uiSize;
+        }
+    }
+    return true;
+}
+
+bool MP4Demuxer::xParseHvcC(const uchar* pucData, int iSize)
+{
+    /// HEVCDecoderConfigurationRecord: 21 bytes of profile info, lengthSizeMinusOne, numOfArrays
+    if( iSize < 23 )
+        return false;
+    m_iLengthSize = (pucData[21] & 3) + 1;
+    int iArrayNum = pucData[22];
+    int iPos = 23;
+    m_cParamSets.clear();
+    for(int i = 0; i < iArrayNum; i++)
+    {
+        if( iPos + 3 > iSize )
+            return false;
+        int iNalNum = int(xU16(pucData + iPos + 1));
+        iPos += 3;
+        for(int j = 0; j < iNalNum; j++)
+        {
+            if( iPos + 2 > iSize )
+                return false;
+            int iLength = int(xU16(pucData + iPos));
+            iPos += 2;
+            if( iPos + iLength > iSize )
+                return false;
+            m_cParamSets.append("\0\0\0\1", 4);
+            m_cParamSets.append((const char*)pucData + iPos, iLength);
+            iPos += iLength;
+        }
+    }
+    return true;
+}
+
+void MP4Demuxer::xParseMoof(const QByteArray& rcMoof, int iBody, qint64 iMoofOffset)
+{
+    const uchar* pucData = (const uchar*)rcMoof.constData();
+    int iPos = iBody;
+    quint32 uiType;
+    int iTrafBody, iTrafEnd;
+    while( xNextBox(pucData, iPos, rcMoof.size(), uiType, iTrafBody, iTrafEnd) )
+    {
+        if( uiType != MP4_FOURCC('t','r','a','f') )
+            continue;
+
+        /// tfhd: track, base data offset and default sample size of the runs
+        int iTfhd, iTfhdEnd;
+        if( !xFindBox(pucData, iTrafBody, iTrafEnd, "tfhd", iTfhd, iTfhdEnd) || iTfhd + 8 > iTfhdEnd )
+            continue;
+        quint32 uiFlags = xU32(pucData + iTfhd) & 0xffffff;
+        if( int(xU32(pucData + iTfhd + 4)) != m_iTrackId )
+            continue;
+        qint64 iBase = iMoofOffset;
+        quint32 uiDefaultSize = m_cDefaultSizes.value(quint32(m_iTrackId), 0);
+        int iField = iTfhd + 8;
+        if( uiFlags & 0x01 )
+        {
+            if( iField + 8 > iTfhdEnd )
+                continue;
+            iBase = qint64(xU64(pucData + iField));
+            iField += 8;
+        }
+        if( uiFlags & 0x02 )
+            iField += 4;
+        if( uiFlags & 0x08 )
+            iField += 4;
+        if( (uiFlags & 0x10) && iField + 4 <= iTfhdEnd )
+            uiDefaultSize = xU32(pucData + iField);
+
+        /// trun: the samples, a run without data offset follows the last one
+        qint64 iNextOffset = iBase;
+        int iRunPos = iTrafBody;
+        quint32 uiRunType;
+        int iRun, iRunEnd;
+        while( xNextBox(pucData, iRunPos, iTrafEnd, uiRunType, iRun, iRunEnd) )
+        {
+            if( uiRunType != MP4_FOURCC('t','r','u','n') || iRun + 8 > iRunEnd )
+                continue;
+            quint32 uiRunFlags = xU32(pucData + iRun) & 0xffffff;
+            int iSampleNum = int(xU32(pucData + iRun + 4));
+            int iField = iRun + 8;
+            qint64 iOffset = iNextOffset;
+            if( uiRunFlags & 0x01 )
+            {
+                iOffset = iBase + qint32(xU32(pucData + iField));
+                iField += 4;
+            }
+            if( uiRunFlags & 0x04 )
+                iField += 4;
+            int iEntrySize = 4 * ( ((uiRunFlags & 0x100) ? 1 : 0) + ((uiRunFlags & 0x200) ? 1 : 0) +
+                                   ((uiRunFlags & 0x400) ? 1 : 0) + ((uiRunFlags & 0x800) ? 1 : 0) );
+            if( iField + qint64(iSampleNum)*iEntrySize > iRunEnd )
+            {
+                qWarning() << "Broken MP4 track run at" << iMoofOffset;
+                continue;
+            }
+            for(int i = 0; i < iSampleNum; i++, iField += iEntrySize)
+            {
+                int iSizeField = iField + ((uiRunFlags & 0x100) ? 4 : 0);
+                Sample cSample;
+                cSample.iOffset = iOffset;
+                cSample.uiSize = (uiRunFlags & 0x200) ? xU32(pucData + iSizeField) : uiDefaultSize;
+                m_acSamples.push_back(cSample);
+                iOffset += cSample.uiSize;
+            }
+            iNextOffset = iOffset;
+        }
+    }
+}
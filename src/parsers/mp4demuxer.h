@@ -0,0 +1,44 @@
+#ifndef MP4DEMUXER_H
+#define MP4DEMUXER_H
+
+#include <QVector>
+#include <QMap>
+#include "parsers/containerdemuxer.h"
+
+/*!
+ * \brief The MP4Demuxer class
+ * the first HEVC track ('hvc1' or 'hev1' sample entry) of an ISO base media file (MP4, MOV, fragmented MP4).
+ * The sample positions come from the sample table of the track and from the track fragment runs of every
+ * movie fragment; a sample is read when it is demuxed, the NAL unit lengths are replaced by start codes and
+ * the parameter sets of the hvcC box go in front of the first sample.
+ */
+
+class MP4Demuxer : public ContainerDemuxer
+{
+public:
+    MP4Demuxer();
+
+    bool open(const QString& strFilePath);
+    bool readAccessUnit(QByteArray& rcAnnexB);
+
+protected:
+    struct Sample
+    {
+        qint64 iOffset;
+        quint32 uiSize;
+    };
+
+    bool xParseMoov(const QByteArray& rcMoov, int iBody);
+    bool xParseTrak(const uchar* pucData, int iStart, int iEnd);
+    bool xParseHvcC(const uchar* pucData, int iSize);
+    void xParseMoof(const QByteArray& rcMoof, int iBody, qint64 iMoofOffset);
+
+    QVector<Sample> m_acSamples;                ///< in decoding order
+    QByteArray m_cParamSets;                    ///< parameter sets of the hvcC box, Annex-B
+    int m_iLengthSize;                          ///< bytes of the NAL unit lengths
+    int m_iTrackId;                             ///< -1 before the HEVC track is found
+    QMap<quint32, quint32> m_cDefaultSizes;     ///< default sample size of every track (trex boxes)
+    int m_iNextSample;
+};
+
+#endif // MP4DEMUXER_H
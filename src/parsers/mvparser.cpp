@@ -1,5 +1,5 @@
 #include "mvparser.h"
-#include <QRegExp>
+#include <QDebug>
 
 MVParser::MVParser(QObject *parent) :
     QObject(parent)
@@ -8,57 +8,50 @@ MVParser::MVParser(QObject *parent) :
 
 bool MVParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
 {
-    Q_ASSERT( pcSequence != NULL );
-
-    QString strOneLine;
-    QRegExp cMatchTarget;
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
 
+bool MVParser::parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
 
     /// <1,1> 1 -3 0 1 -3 0 1 -3 0 1 1 0 1 -3 0
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-    QTextStream cMVInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-
-            ///
-            QString strMVInfo = cMatchTarget.cap(3);
-            cMVInfoStream.setString( &strMVInfo, QIODevice::ReadOnly );
-
-
-            xReadMV(&cMVInfoStream, pcLCU);
-
+            qCritical() << "MVParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        xReadMV(pcTokenizer, pcLCU);
     }
     return true;
 }
-bool MVParser::xReadMV(QTextStream* pcMVInfoStream, ComCU* pcCU)
+bool MVParser::xReadMV(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     if( !pcCU->getSCUs().empty() )
     {
         /// non-leaf node : recursive reading for children
-        xReadMV(pcMVInfoStream, pcCU->getSCUs().at(0));
-        xReadMV(pcMVInfoStream, pcCU->getSCUs().at(1));
-        xReadMV(pcMVInfoStream, pcCU->getSCUs().at(2));
-        xReadMV(pcMVInfoStream, pcCU->getSCUs().at(3));
+        xReadMV(pcTokenizer, pcCU->getSCUs().at(0));
+        xReadMV(pcTokenizer, pcCU->getSCUs().at(1));
+        xReadMV(pcTokenizer, pcCU->getSCUs().at(2));
+        xReadMV(pcTokenizer, pcCU->getSCUs().at(3));
     }
     else
     {
@@ -66,38 +59,22 @@ bool MVParser::xReadMV(QTextStream* pcMVInfoStream, ComCU* pcCU)
         int iInterDir;
         for(int i = 0; i < pcCU->getPUs().size(); i++)
         {
-            Q_ASSERT(!pcMVInfoStream->atEnd());
-            *pcMVInfoStream >> iInterDir;
+            if( !pcTokenizer->readInt(iInterDir) )
+                return false;
             ComPU* pcPU = pcCU->getPUs().at(i);
             pcPU->setInterDir(iInterDir);
 
-            int iRefPOC;
-            int iHor, iVer;
-            ComMV* pcReadMV = NULL;
-            if( iInterDir == 1 || iInterDir == 2)   //uni-prediction, 1 MV
-            {
-                *pcMVInfoStream >> iRefPOC >> iHor >> iVer;
-                pcReadMV = new ComMV();
-                pcReadMV->setRefPOC(iRefPOC);
-                pcReadMV->setHor(iHor);
-                pcReadMV->setVer(iVer);
-                pcPU->getMVs().push_back(pcReadMV);
-            }
-            else if( iInterDir == 3 )               //bi-prediction, 2 MVs
+            /// uni-prediction 1 MV, bi-prediction 2 MVs
+            int iMVNum = (iInterDir == 3) ? 2 : ((iInterDir == 1 || iInterDir == 2) ? 1 : 0);
+            for(int j = 0; j < iMVNum; j++)
             {
-                *pcMVInfoStream >> iRefPOC >> iHor >> iVer;
-                pcReadMV = new ComMV();
-                pcReadMV->setRefPOC(iRefPOC);
-                pcReadMV->setHor(iHor);
-                pcReadMV->setVer(iVer);
-                pcPU->getMVs().push_back(pcReadMV);
-
-                *pcMVInfoStream >> iRefPOC >> iHor >> iVer;
-                pcReadMV = new ComMV();
-                pcReadMV->setRefPOC(iRefPOC);
-                pcReadMV->setHor(iHor);
-                pcReadMV->setVer(iVer);
-                pcPU->getMVs().push_back(pcReadMV);
+                int iRefPOC;
+                int iHor, iVer;
+                if( !pcTokenizer->readInt(iRefPOC) || !pcTokenizer->readInt(iHor) || !pcTokenizer->readInt(iVer) )
+                    return false;
+                ComMV cReadMV(iHor, iVer);
+                cReadMV.setRefPOC(iRefPOC);
+                pcPU->getMVs().push_back(cReadMV);
             }
         }
     }
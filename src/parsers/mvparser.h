@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 
 class MVParser : public QObject
 {
@@ -11,8 +12,9 @@ class MVParser : public QObject
 public:
     explicit MVParser(QObject *parent = 0);
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 protected:
-    bool xReadMV(QTextStream* pcCUInfoStream, ComCU* pcCU);
+    bool xReadMV(IntTokenizer* pcTokenizer, ComCU* pcCU);
 signals:
 
 public slots:
@@ -0,0 +1,283 @@
+#include "parallelbitstreamparser.h"
+#include "parsers/bitstreamparser.h"
+#include "exceptions/bitstreamnotfoundexception.h"
+#include "gitlupdateuievt.h"
+#include <QFile>
+#include <QDir>
+#include <QTime>
+#include <QThread>
+#include <QRegExp>
+#include <QtEndian>
+#include <QDebug>
+
+#define PARALLEL_POLL_INTERVAL  10          ///< ms, wait for one decoder before looking at the next one
+#define PARALLEL_COPY_BLOCK     (1 << 20)   ///< bytes copied per read when joining the output
+
+/// binary container constants (see TSysuAnalyzerOutput.h)
+#define BIN_HEADER_SIZE     16
+#define BIN_TAG_INDEX       0x58444E49    ///< 'INDX'
+
+/// files of every segment which are joined by appending them in segment order
+static const char* s_apchJoinedFiles[] =
+{
+    "decoder_yuv.yuv", "decoder_cupu.txt", "decoder_tu.txt", "decoder_pred.txt", "decoder_mv.txt",
+    "decoder_merge.txt", "decoder_intra.txt", "decoder_bit_lcu.txt", "decoder_bit_scu.txt", "decoder_tile.txt"
+};
+
+ParallelBitstreamParser::ParallelBitstreamParser(QObject *parent) :
+    QObject(parent)
+{
+    m_iMaxSegments = QThread::idealThreadCount();
+}
+
+bool ParallelBitstreamParser::isSupported(int iEncoderVersion)
+{
+    return AnnexBIndex::isSupported(iEncoderVersion);
+}
+
+bool ParallelBitstreamParser::parseFile(QString strDecoderFolder,
+                                        int iEncoderVersion,
+                                        QString strBitstreamFilePath,
+                                        QString strOutputPath,
+                                        ComSequence* pcSequence)
+{
+    /// find the cut points, where the segment decodes the same POCs as the whole bitstream
+    if( !m_cIndex.open(strBitstreamFilePath, m_strIndexFile) )
+        throw BitstreamNotFoundException();
+    QVector<qint64> aiCutPoints;
+    foreach(const AnnexBPicture& rcPicture, m_cIndex.getPictures())
+    {
+        if( rcPicture.bCutPoint && AnnexBIndex::isPocReset(rcPicture.iNalType) && rcPicture.iStart > 0 )
+            aiCutPoints.push_back(rcPicture.iStart);
+    }
+    xSplit(m_cIndex.getSize(), aiCutPoints);
+
+    if( m_acSegments.size() < 2 )
+    {
+        qDebug() << "No IDR or BLA picture to split the bitstream at, decode it as a whole";
+        /// txt files, same as the segments (they can be indexed for the lazy LCU loading)
+        BitstreamParser cBitstreamParser;
+        return cBitstreamParser.parseFile(strDecoderFolder, iEncoderVersion, strBitstreamFilePath,
+                                          strOutputPath, pcSequence, false);
+    }
+
+    QVector<BitstreamParser*> apcDecoders;
+    SCOPE_EXIT(qDeleteAll(apcDecoders);
+               foreach(const QString& strFolder, m_astrSegmentFolders)
+                   QDir(strFolder).removeRecursively();
+               );
+
+    /// write the segments
+    m_astrSegmentFolders.clear();
+    for(int i = 0; i < m_acSegments.size(); i++)
+    {
+        QString strFolder = strOutputPath + QString("/segment_%1").arg(i);
+        QDir::current().mkpath(strFolder);
+        m_astrSegmentFolders.push_back(strFolder);
+        if( !m_cIndex.writeRange(strBitstreamFilePath, m_acSegments[i].iStart, m_acSegments[i].iEnd, strFolder + "/segment.bin") )
+        {
+            qCritical() << "Bitstream segment can not be written to" << strFolder;
+            return false;
+        }
+    }
+
+    /// decode all of them at once
+    GitlUpdateUIEvt cEvt;
+    cEvt.setParameter("decoding_progress", QString("Decoding %1 Bitstream Segments In Parallel...").arg(m_acSegments.size()));
+    dispatchEvt(cEvt);
+    QTime cTimer;
+    cTimer.start();
+    for(int i = 0; i < m_astrSegmentFolders.size(); i++)
+    {
+        BitstreamParser* pcDecoder = new BitstreamParser();
+        apcDecoders.push_back(pcDecoder);
+        if( !pcDecoder->startDecoding(strDecoderFolder, iEncoderVersion, m_astrSegmentFolders[i] + "/segment.bin",
+                                      m_astrSegmentFolders[i], false) )
+        {
+            /// the segments are useless without this one
+            qCritical() << "Decoder of bitstream segment" << i << "can not be started";
+            foreach(BitstreamParser* pcStarted, apcDecoders)
+                pcStarted->cancel();
+            return false;
+        }
+    }
+    bool bAllFinished = false;
+    while( !bAllFinished )
+    {
+        /// every decoder's stdout has to be read now and then, or its pipe fills up
+        bAllFinished = true;
+        foreach(BitstreamParser* pcDecoder, apcDecoders)
+            bAllFinished = pcDecoder->waitForDecoding(PARALLEL_POLL_INTERVAL) && bAllFinished;
+    }
+    for(int i = 0; i < apcDecoders.size(); i++)
+    {
+        if( !apcDecoders[i]->isDecodingSuccessful() )
+        {
+            qCritical() << "Decoding of bitstream segment" << i << "failed";
+            return false;
+        }
+    }
+
+    /// one decoder output for the whole bitstream
+    if( !joinOutput(m_astrSegmentFolders, strOutputPath, cTimer.elapsed() / 1000.0) )
+        return false;
+    pcSequence->setDecodingFolder(strOutputPath);
+    return true;
+}
+
+void ParallelBitstreamParser::xSplit(qint64 iSize, const QVector<qint64>& raiCutPoints)
+{
+    m_acSegments.clear();
+    int iSegmentNum = qMin(qMax(m_iMaxSegments, 1), raiCutPoints.size()+1);
+
+    /// segments of about the same size, each cut at the cut point nearest to its share
+    QVector<qint64> aiCuts;
+    int iCut = 0;
+    for(int k = 1; k < iSegmentNum; k++)
+    {
+        qint64 iTarget = iSize * k / iSegmentNum;
+        while( iCut+1 < raiCutPoints.size() && raiCutPoints[iCut+1] <= iTarget )
+            iCut++;
+        if( iCut+1 < raiCutPoints.size() &&
+            raiCutPoints[iCut+1] - iTarget < iTarget - raiCutPoints[iCut] )
+            iCut++;
+        if( iCut < raiCutPoints.size() && (aiCuts.empty() || raiCutPoints[iCut] > aiCuts.back()) )
+            aiCuts.push_back(raiCutPoints[iCut]);
+    }
+    aiCuts.push_back(iSize);
+
+    qint64 iStart = 0;
+    foreach(qint64 iEnd, aiCuts)
+    {
+        Segment cSegment = { iStart, iEnd };
+        m_acSegments.push_back(cSegment);
+        iStart = iEnd;
+    }
+}
+
+bool ParallelBitstreamParser::joinOutput(const QStringList& astrSegmentFolders, const QString& strOutputPath, double dDecodingTime)
+{
+    QDir cOutputDir(strOutputPath);
+    cOutputDir.remove("decoder_analysis.bin");
+    cOutputDir.remove("decoder_lcu_index.bin");
+
+    /// SPS of the first segment (all segments have the same)
+    cOutputDir.remove("decoder_sps.txt");
+    if( !QFile::copy(astrSegmentFolders.front() + "/decoder_sps.txt", strOutputPath + "/decoder_sps.txt") )
+        return false;
+
+    /// binary container instead of the per-LCU txt files
+    if( QFile::exists(astrSegmentFolders.front() + "/decoder_analysis.bin") )
+    {
+        QFile cTarget(strOutputPath + "/decoder_analysis.bin");
+        if( !cTarget.open(QIODevice::WriteOnly | QIODevice::Truncate) || !xJoinAnalysisBin(&cTarget, astrSegmentFolders) )
+        {
+            qCritical() << "Decoder output can not be joined:" << cTarget.fileName();
+            return false;
+        }
+    }
+
+    for(size_t i = 0; i < sizeof(s_apchJoinedFiles)/sizeof(s_apchJoinedFiles[0]); i++)
+    {
+        /// categories the decoder did not write
+        cOutputDir.remove(s_apchJoinedFiles[i]);
+        if( !QFile::exists(astrSegmentFolders.front() + "/" + s_apchJoinedFiles[i]) )
+            continue;
+        QFile cTarget(strOutputPath + "/" + s_apchJoinedFiles[i]);
+        if( !cTarget.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+            return false;
+        foreach(const QString& strFolder, astrSegmentFolders)
+        {
+            if( !xAppendFile(&cTarget, strFolder + "/" + s_apchJoinedFiles[i]) )
+            {
+                qCritical() << "Decoder output can not be joined:" << strFolder + "/" + s_apchJoinedFiles[i];
+                return false;
+            }
+        }
+    }
+
+    /// stdout: the header of the first decoder, the POC lines of all, then the time of the whole decoding
+    QFile cGeneral(strOutputPath + "/decoder_general.txt");
+    if( !cGeneral.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+        return false;
+    double dSegmentTime = 0;
+    QRegExp cTimeLine("Total Time: *([0-9.]+)");
+    for(int i = 0; i < astrSegmentFolders.size(); i++)
+    {
+        QFile cSegmentGeneral(astrSegmentFolders[i] + "/decoder_general.txt");
+        if( !cSegmentGeneral.open(QIODevice::ReadOnly) )
+            return false;
+        while( !cSegmentGeneral.atEnd() )
+        {
+            QByteArray cLine = cSegmentGeneral.readLine();
+            if( cTimeLine.indexIn(QString::fromLatin1(cLine)) >= 0 )
+                dSegmentTime += cTimeLine.cap(1).toDouble();
+            else if( i == 0 || cLine.startsWith("POC") )
+                cGeneral.write(cLine);
+        }
+    }
+    if( dDecodingTime < 0 )
+        dDecodingTime = dSegmentTime;
+    cGeneral.write(QString("\n Total Time: %1 sec.\n").arg(dDecodingTime, 12, 'f', 3).toLatin1());
+    return true;
+}
+
+bool ParallelBitstreamParser::xAppendFile(QFile* pcTarget, const QString& strSourceFile)
+{
+    QFile cSource(strSourceFile);
+    if( !cSource.open(QIODevice::ReadOnly) )
+        return false;
+    while( !cSource.atEnd() )
+    {
+        QByteArray cBlock = cSource.read(PARALLEL_COPY_BLOCK);
+        if( cBlock.isEmpty() || pcTarget->write(cBlock) != cBlock.size() )
+            return false;
+    }
+    return true;
+}
+
+bool ParallelBitstreamParser::xJoinAnalysisBin(QFile* pcTarget, const QStringList& astrSegmentFolders)
+{
+    /// the header of the first container, then the frame chunks of all of them;
+    /// the index chunks are left out (the parser walks the frame chunks)
+    for(int i = 0; i < astrSegmentFolders.size(); i++)
+    {
+        QFile cSource(astrSegmentFolders[i] + "/decoder_analysis.bin");
+        if( !cSource.open(QIODevice::ReadOnly) )
+            return false;
+        QByteArray cHeader = cSource.read(BIN_HEADER_SIZE);
+        if( cHeader.size() != BIN_HEADER_SIZE )
+            return false;
+        if( i == 0 )
+            pcTarget->write(cHeader);
+
+        qint64 iChunkStart = cSource.pos();
+        qint64 iChunksEnd = cSource.size();
+        while( iChunkStart + 8 <= cSource.size() )
+        {
+            cSource.seek(iChunkStart);
+            QByteArray cChunkHeader = cSource.read(8);
+            if( cChunkHeader.size() != 8 )
+                return false;
+            if( qFromLittleEndian<quint32>((const uchar*)cChunkHeader.constData()) == BIN_TAG_INDEX )
+            {
+                iChunksEnd = iChunkStart;
+                break;
+            }
+            iChunkStart += 8 + qFromLittleEndian<quint32>((const uchar*)cChunkHeader.constData()+4);
+        }
+        if( iChunkStart > iChunksEnd )
+            return false;       ///< truncated chunk
+
+        cSource.seek(BIN_HEADER_SIZE);
+        qint64 iLeft = iChunksEnd - BIN_HEADER_SIZE;
+        while( iLeft > 0 )
+        {
+            QByteArray cBlock = cSource.read(qMin<qint64>(iLeft, PARALLEL_COPY_BLOCK));
+            if( cBlock.isEmpty() || pcTarget->write(cBlock) != cBlock.size() )
+                return false;
+            iLeft -= cBlock.size();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef PARALLELBITSTREAMPARSER_H
+#define PARALLELBITSTREAMPARSER_H
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+#include <QByteArray>
+#include <QFile>
+#include <QStringList>
+#include "gitlmodual.h"
+#include "model/common/comsequence.h"
+#include "parsers/annexbindex.h"
+
+/*!
+ * \brief The ParallelBitstreamParser class
+ * this class cuts an HEVC Annex-B bitstream at IDR and BLA pictures into segments which can be decoded
+ * on their own, decodes them with one decoder process each at the same time, then joins their output in
+ * strOutputPath as if the whole bitstream had been decoded once (decoder_general.txt, decoder_yuv.yuv,
+ * per-LCU txt files, ...), to be parsed as usual. Every segment starts with the parameter sets seen before
+ * it in the bitstream. CRA pictures are not cut at: their segment would restart the POC MSB at 0, and the
+ * joined output is copied with the POCs as written.
+ */
+
+class ParallelBitstreamParser : public QObject, public GitlModual
+{
+    Q_OBJECT
+public:
+    explicit ParallelBitstreamParser(QObject *parent = 0);
+
+    /// same as BitstreamParser::parseFile, but the per-LCU info is always written in txt files
+    bool parseFile(QString strDecoderFolder,
+                   int iEncoderVersion,
+                   QString strBitstreamFilePath,
+                   QString strOutputPath,
+                   ComSequence* pcSequence);
+
+    /// the decoder writes NAL unit types of the final HEVC spec (HM-10.0 and later)
+    static bool isSupported(int iEncoderVersion);
+
+    /*!
+     * \brief joinOutput join the decoder output of consecutive bitstream segments (each one cut at an IDR
+     * or BLA picture, see AnnexBIndex::isPocReset, the POCs are not rewritten)
+     * into strOutputPath, as if the whole bitstream had been decoded once (see DecodeJob for another user)
+     * \param dDecodingTime for the last line of decoder_general.txt, < 0 for the sum of the segments' times
+     */
+    static bool joinOutput(const QStringList& astrSegmentFolders, const QString& strOutputPath, double dDecodingTime);
+
+    ADD_CLASS_FIELD(int, iMaxSegments, getMaxSegments, setMaxSegments)  ///< decoder processes, QThread::idealThreadCount() by default
+    ADD_CLASS_FIELD(QString, strIndexFile, getIndexFile, setIndexFile)  ///< cache file of the AnnexBIndex, none if empty
+
+protected:
+    /// bytes [iStart, iEnd) of the bitstream, preceded by the parameter sets sent before iStart (AnnexBIndex::writeRange)
+    struct Segment
+    {
+        qint64 iStart;
+        qint64 iEnd;
+    };
+
+    void xSplit(qint64 iSize, const QVector<qint64>& raiCutPoints);
+    static bool xAppendFile(QFile* pcTarget, const QString& strSourceFile);
+    static bool xJoinAnalysisBin(QFile* pcTarget, const QStringList& astrSegmentFolders);
+
+    QVector<Segment> m_acSegments;
+    AnnexBIndex m_cIndex;
+    QStringList m_astrSegmentFolders;
+};
+
+#endif // PARALLELBITSTREAMPARSER_H
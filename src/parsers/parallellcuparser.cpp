@@ -0,0 +1,102 @@
+#include "parallellcuparser.h"
+#include "parsers/cupuparser.h"
+#include "parsers/tuparser.h"
+#include "parsers/predparser.h"
+#include "parsers/mvparser.h"
+#include "parsers/mergeparser.h"
+#include "parsers/intraparser.h"
+#include "parsers/bitparser.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QThread>
+#include <QDebug>
+#include <functional>
+
+/// one attribute parsing job, the result is written to its own slot
+class AttributeParseTask : public QRunnable
+{
+public:
+    AttributeParseTask(std::function<bool()> cJob, bool* pbResult) :
+        m_cJob(cJob), m_pbResult(pbResult)
+    {
+        setAutoDelete(true);
+    }
+    void run()
+    {
+        *m_pbResult = m_cJob();
+    }
+private:
+    std::function<bool()> m_cJob;
+    bool* m_pbResult;
+};
+
+/// open one decoder output file and run the parser on it
+template<typename T>
+static bool xParseTextFile(const QString& strFilename, ComSequence* pcSequence,
+                           bool (T::*pfParse)(IntTokenizer*, ComSequence*))
+{
+    /// category the decoder was told not to write (AnalysisCategories)
+    if( !QFile::exists(strFilename) )
+        return true;
+    IntTokenizer cTokenizer;
+    if( !cTokenizer.openFile(strFilename) )
+    {
+        qCritical() << "Cannot open" << strFilename;
+        return false;
+    }
+    T cParser;
+    return (cParser.*pfParse)(&cTokenizer, pcSequence);
+}
+
+
+ParallelLCUParser::ParallelLCUParser(QObject *parent) :
+    QObject(parent)
+{
+}
+
+bool ParallelLCUParser::parseFolder(const QString& strFolder, ComSequence* pcSequence, int iThreadNum)
+{
+    Q_ASSERT( pcSequence != NULL );
+
+    /// CU&PU skeleton first, every other parser walks it
+    if( !xParseTextFile(strFolder + "/decoder_cupu.txt", pcSequence, &CUPUParser::parseFile) )
+        return false;
+
+    /// independent attributes on the pool
+    enum { TASK_TU = 0, TASK_PRED, TASK_MV, TASK_MERGE, TASK_INTRA, TASK_BIT, TASK_NUM };
+    bool abResult[TASK_NUM];
+    for(int i = 0; i < TASK_NUM; i++)
+        abResult[i] = false;
+
+    QThreadPool cPool;
+    cPool.setMaxThreadCount( iThreadNum > 0 ? iThreadNum : QThread::idealThreadCount() );
+
+    cPool.start(new AttributeParseTask([=]() {
+        return xParseTextFile(strFolder + "/decoder_tu.txt", pcSequence, &TUParser::parseFile);
+    }, &abResult[TASK_TU]));
+    cPool.start(new AttributeParseTask([=]() {
+        return xParseTextFile(strFolder + "/decoder_pred.txt", pcSequence, &PredParser::parseFile);
+    }, &abResult[TASK_PRED]));
+    cPool.start(new AttributeParseTask([=]() {
+        return xParseTextFile(strFolder + "/decoder_mv.txt", pcSequence, &MVParser::parseFile);
+    }, &abResult[TASK_MV]));
+    cPool.start(new AttributeParseTask([=]() {
+        return xParseTextFile(strFolder + "/decoder_merge.txt", pcSequence, &MergeParser::parseFile);
+    }, &abResult[TASK_MERGE]));
+    cPool.start(new AttributeParseTask([=]() {
+        return xParseTextFile(strFolder + "/decoder_intra.txt", pcSequence, &IntraParser::parseFile);
+    }, &abResult[TASK_INTRA]));
+    /// LCU and leaf CU bits share ComCU::m_iBitCount (an LCU can be a leaf), keep their order
+    cPool.start(new AttributeParseTask([=]() {
+        return xParseTextFile(strFolder + "/decoder_bit_lcu.txt", pcSequence, &BitParser::parseLCUBitFile) &&
+               xParseTextFile(strFolder + "/decoder_bit_scu.txt", pcSequence, &BitParser::parseSCUBitFile);
+    }, &abResult[TASK_BIT]));
+
+    /// barrier
+    cPool.waitForDone();
+
+    bool bSuccess = true;
+    for(int i = 0; i < TASK_NUM; i++)
+        bSuccess = bSuccess && abResult[i];
+    return bSuccess;
+}
@@ -0,0 +1,38 @@
+#ifndef PARALLELLCUPARSER_H
+#define PARALLELLCUPARSER_H
+
+#include <QObject>
+#include <QString>
+#include "model/common/comsequence.h"
+
+/*!
+ * \brief The ParallelLCUParser class
+ * this class parses the per-LCU txt files of one decoding folder on a thread pool.
+ * CUPUParser builds the LCU trees first, then TUParser, PredParser, MVParser,
+ * MergeParser, IntraParser and BitParser run concurrently: each of them only reads
+ * the tree and writes its own fields of ComCU/ComPU/ComTU.
+ * A missing file is a category the decoder did not write, it is skipped.
+ * parseFolder() returns after all workers are done.
+ */
+
+class ParallelLCUParser : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ParallelLCUParser(QObject *parent = 0);
+    /*!
+     * \brief parseFolder
+     * \param strFolder decoding folder holding decoder_*.txt
+     * \param pcSequence output sequence (SPS and decoder general info must be parsed already)
+     * \param iThreadNum worker number, <= 0 means QThread::idealThreadCount()
+     * \return
+     */
+    bool parseFolder(const QString& strFolder, ComSequence* pcSequence, int iThreadNum = 0);
+
+signals:
+
+public slots:
+
+};
+
+#endif // PARALLELLCUPARSER_H
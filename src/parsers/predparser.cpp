@@ -1,5 +1,4 @@
 #include "predparser.h"
-#include <QRegExp>
 #include <QDebug>
 
 PredParser::PredParser(QObject *parent) :
@@ -9,59 +8,52 @@ PredParser::PredParser(QObject *parent) :
 
 bool PredParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
 {
-    Q_ASSERT( pcSequence != NULL );
-
-    QString strOneLine;
-    QRegExp cMatchTarget;
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
 
+bool PredParser::parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
 
     /// <1,1> 0 0 1 1 0
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-    QTextStream cPredInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-
-            ///
-            QString strCUInfo = cMatchTarget.cap(3);
-
-            cPredInfoStream.setString(&strCUInfo, QIODevice::ReadOnly );
-
-            xReadPredMode(&cPredInfoStream, pcLCU);
-
+            qCritical() << "PredParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        xReadPredMode(pcTokenizer, pcLCU);
     }
     return true;
 }
 
 
-bool PredParser::xReadPredMode(QTextStream* pcPredInfoStream, ComCU* pcCU)
+bool PredParser::xReadPredMode(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     if( !pcCU->getSCUs().empty() )
     {
         /// non-leaf node : recursive reading for children
-        xReadPredMode(pcPredInfoStream, pcCU->getSCUs().at(0));
-        xReadPredMode(pcPredInfoStream, pcCU->getSCUs().at(1));
-        xReadPredMode(pcPredInfoStream, pcCU->getSCUs().at(2));
-        xReadPredMode(pcPredInfoStream, pcCU->getSCUs().at(3));
+        xReadPredMode(pcTokenizer, pcCU->getSCUs().at(0));
+        xReadPredMode(pcTokenizer, pcCU->getSCUs().at(1));
+        xReadPredMode(pcTokenizer, pcCU->getSCUs().at(2));
+        xReadPredMode(pcTokenizer, pcCU->getSCUs().at(3));
     }
     else
     {
@@ -69,11 +61,8 @@ bool PredParser::xReadPredMode(QTextStream* pcPredInfoStream, ComCU* pcCU)
         int iPredMode;
         for(int i = 0; i < pcCU->getPUs().size(); i++)
         {
-
-
-            Q_ASSERT(pcPredInfoStream->atEnd() == false);
-
-            *pcPredInfoStream >> iPredMode;
+            if( !pcTokenizer->readInt(iPredMode) )
+                return false;
             ComPU* pcPU = pcCU->getPUs().at(i);
             pcPU->setPredMode((PredMode)iPredMode);
         }
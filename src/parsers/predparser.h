@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 
 class PredParser : public QObject
 {
@@ -11,8 +12,9 @@ class PredParser : public QObject
 public:
     explicit PredParser(QObject *parent = 0);
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 protected:
-    bool xReadPredMode(QTextStream* pcPredInfoStream, ComCU* pcCU);
+    bool xReadPredMode(IntTokenizer* pcTokenizer, ComCU* pcCU);
 signals:
 
 public slots:
@@ -0,0 +1,259 @@
+#include "shmringreader.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <atomic>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/// ring layout, see TSysuShmRing.h
+#define SHM_MAGIC               "SYSUSHM"
+#define SHM_VERSION             1
+#define SHM_HEADER_SIZE         64
+#define SHM_OFFSET_WRITE_POS    24
+#define SHM_OFFSET_READ_POS     32
+#define SHM_OFFSET_WRITER_STATE 40
+#define SHM_REC_PICTURE         0x100
+#define SHM_WRITER_NONE         0
+#define SHM_CATEGORY_NUM        10
+
+/// LCUInfoStream of each SysuAnalyzerCategory, -1 for ME (encoder only), LCU_STREAM_NUM for tile
+static const int s_aiStreamOfCategory[SHM_CATEGORY_NUM] =
+{
+    LCU_STREAM_PRED, LCU_STREAM_CUPU, LCU_STREAM_MV, LCU_STREAM_MERGE, LCU_STREAM_INTRA,
+    LCU_STREAM_TU, LCU_STREAM_BIT_LCU, LCU_STREAM_BIT_SCU, -1, LCU_STREAM_NUM
+};
+
+ShmRingReader::ShmRingReader(QObject *parent) :
+    QThread(parent),
+    m_iStop(0)
+{
+    m_iPictureNum = 0;
+    m_puhBase = NULL;
+    m_uiMapSize = 0;
+    m_uiCapacity = 0;
+    m_bUnlinked = false;
+    m_bTakeRecords = false;
+}
+
+ShmRingReader::~ShmRingReader()
+{
+    finish();
+    xRelease();
+}
+
+bool ShmRingReader::isSupported()
+{
+#ifdef Q_OS_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef Q_OS_UNIX
+
+bool ShmRingReader::create(const QString& strOutputPath, bool bTakeRecords, bool bCacheToDisk, qint64 iCapacity)
+{
+    static QAtomicInt s_iSerial(0);
+    m_strName = QString("/gitl_analyzer_%1_%2").arg(QCoreApplication::applicationPid())
+                                               .arg(s_iSerial.fetchAndAddRelaxed(1));
+    QByteArray cName = m_strName.toLatin1();
+
+    int iFd = shm_open(cName.constData(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if( iFd < 0 )
+    {
+        qWarning() << "Cannot create shared memory" << m_strName;
+        return false;
+    }
+    m_uiCapacity = (quint64)iCapacity;
+    m_uiMapSize = SHM_HEADER_SIZE + m_uiCapacity;
+    void* pMap = MAP_FAILED;
+    if( ftruncate(iFd, (off_t)m_uiMapSize) == 0 )
+        pMap = mmap(NULL, m_uiMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+    ::close(iFd);
+    if( pMap == MAP_FAILED )
+    {
+        shm_unlink(cName.constData());
+        qWarning() << "Cannot map shared memory" << m_strName;
+        return false;
+    }
+    m_puhBase = (uchar*)pMap;
+
+    /// header, the decoder checks it when attaching
+    memset(m_puhBase, 0, SHM_HEADER_SIZE);
+    memcpy(m_puhBase, SHM_MAGIC, 8);
+    quint32 uiValue = SHM_VERSION;
+    memcpy(m_puhBase + 8, &uiValue, 4);
+    uiValue = SHM_HEADER_SIZE;
+    memcpy(m_puhBase + 12, &uiValue, 4);
+    memcpy(m_puhBase + 16, &m_uiCapacity, 8);
+
+    m_cYUVFile.setFileName(strOutputPath + "/decoder_yuv.yuv");
+    if( !m_cYUVFile.open(QIODevice::WriteOnly) )
+    {
+        xRelease();
+        return false;
+    }
+    m_bTakeRecords = bTakeRecords;
+    if( !bTakeRecords || bCacheToDisk )
+    {
+        for(int i = 0; i <= LCU_STREAM_NUM; i++)
+        {
+            m_acCacheFile[i].setFileName(strOutputPath + (i < LCU_STREAM_NUM ? g_apchLCUFiles[i] : "/decoder_tile.txt"));
+            if( !m_acCacheFile[i].open(QIODevice::WriteOnly) && !bTakeRecords )
+            {
+                qWarning() << "Cannot create" << m_acCacheFile[i].fileName();
+                xRelease();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ShmRingReader::xRelease()
+{
+    if( m_puhBase == NULL )
+        return;
+    if( !m_bUnlinked )
+        shm_unlink(m_strName.toLatin1().constData());
+    munmap(m_puhBase, m_uiMapSize);
+    m_puhBase = NULL;
+    m_bUnlinked = false;
+}
+
+void ShmRingReader::drain()
+{
+    QMutexLocker cLocker(&m_cMutex);
+    if( m_puhBase == NULL )
+        return;
+
+    volatile quint64* puiWritePos = (volatile quint64*)(m_puhBase + SHM_OFFSET_WRITE_POS);
+    volatile quint64* puiReadPos  = (volatile quint64*)(m_puhBase + SHM_OFFSET_READ_POS);
+    volatile quint32* puiState    = (volatile quint32*)(m_puhBase + SHM_OFFSET_WRITER_STATE);
+
+    /// the decoder holds its own mapping, the name is not needed any more
+    if( !m_bUnlinked && *puiState != SHM_WRITER_NONE )
+    {
+        shm_unlink(m_strName.toLatin1().constData());
+        m_bUnlinked = true;
+    }
+
+    quint64 uiReadPos = *puiReadPos;
+    quint64 uiWritePos = *puiWritePos;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    while( uiReadPos < uiWritePos )
+    {
+        quint32 auiHeader[2];
+        xCopyOut(uiReadPos, (char*)auiHeader, 8);
+        QByteArray cPayload(auiHeader[1], Qt::Uninitialized);
+        xCopyOut(uiReadPos + 8, cPayload.data(), auiHeader[1]);
+        uiReadPos += (8 + (quint64)auiHeader[1] + 7) & ~(quint64)7;
+
+        /// hand the space back to the decoder before the (slow) file writes
+        std::atomic_thread_fence(std::memory_order_release);
+        *puiReadPos = uiReadPos;
+
+        xAppendRecord(auiHeader[0], cPayload);
+    }
+    m_cYUVFile.flush();
+}
+
+void ShmRingReader::xCopyOut(quint64 uiPos, char* pcDst, quint64 uiLength)
+{
+    const uchar* puhData = m_puhBase + SHM_HEADER_SIZE;
+    quint64 uiOffset = uiPos % m_uiCapacity;
+    quint64 uiFirst = qMin(uiLength, m_uiCapacity - uiOffset);
+    memcpy(pcDst, puhData + uiOffset, uiFirst);
+    memcpy(pcDst + uiFirst, puhData, uiLength - uiFirst);     ///< wrap around
+}
+
+#else
+
+bool ShmRingReader::create(const QString& strOutputPath, bool bTakeRecords, bool bCacheToDisk, qint64 iCapacity)
+{
+    Q_UNUSED(strOutputPath); Q_UNUSED(bTakeRecords); Q_UNUSED(bCacheToDisk); Q_UNUSED(iCapacity);
+    return false;
+}
+
+void ShmRingReader::xRelease()
+{
+}
+
+void ShmRingReader::drain()
+{
+}
+
+void ShmRingReader::xCopyOut(quint64 uiPos, char* pcDst, quint64 uiLength)
+{
+    Q_UNUSED(uiPos); Q_UNUSED(pcDst); Q_UNUSED(uiLength);
+}
+
+#endif
+
+void ShmRingReader::xAppendRecord(quint32 uiType, const QByteArray& rcPayload)
+{
+    if( uiType == SHM_REC_PICTURE )
+    {
+        m_cYUVFile.write(rcPayload);
+        m_iPictureNum++;
+        return;
+    }
+    if( uiType >= SHM_CATEGORY_NUM || s_aiStreamOfCategory[uiType] < 0 )
+        return;
+
+    int iStream = s_aiStreamOfCategory[uiType];
+    /// (otherwise on disk only, parsed when the decoder is done)
+    if( m_bTakeRecords )
+    {
+        if( iStream == LCU_STREAM_NUM )
+            m_cTileData.append(rcPayload);
+        else
+            m_acLCUData[iStream].append(rcPayload);
+    }
+    if( m_acCacheFile[iStream].isOpen() )
+        m_acCacheFile[iStream].write(rcPayload);
+}
+
+void ShmRingReader::finish()
+{
+    m_iStop.store(1);
+    wait();
+    drain();
+
+    QMutexLocker cLocker(&m_cMutex);
+    m_cYUVFile.close();
+    for(int i = 0; i <= LCU_STREAM_NUM; i++)
+        m_acCacheFile[i].close();
+}
+
+QByteArray ShmRingReader::takeLCUData(LCUInfoStream eStream)
+{
+    QMutexLocker cLocker(&m_cMutex);
+    QByteArray cData;
+    cData.swap(m_acLCUData[eStream]);
+    return cData;
+}
+
+QByteArray ShmRingReader::takeTileData()
+{
+    QMutexLocker cLocker(&m_cMutex);
+    QByteArray cData;
+    cData.swap(m_cTileData);
+    return cData;
+}
+
+void ShmRingReader::run()
+{
+    while( m_iStop.load() == 0 )
+    {
+        drain();
+        msleep(1);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef SHMRINGREADER_H
+#define SHMRINGREADER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QFile>
+#include "gitldef.h"
+#include "parsers/lcuinfoparser.h"
+
+/*!
+ * \brief The ShmRingReader class
+ * this class is the analyzer end of the shared memory ring buffer written by
+ * TSysuAnalyzerOutput (AnalysisOutputFormat=2), the ring layout is documented in TSysuShmRing.h.
+ * It creates the shared memory object before the decoder starts, and a thread keeps
+ * copying the records out so the decoder never waits for the GUI:
+ * per-LCU text records are written to decoder_*.txt, which are parsed (or indexed) once the decoder
+ * has exited, so the records of a whole bitstream are never held in memory. Only a consumer that takes
+ * them while decoding (see takeLCUData()) has them kept until its next call, and written to the files
+ * only if caching is requested. Reconstructed pictures are appended to decoder_yuv.yuv which is read by the YUV buffer.
+ */
+
+class ShmRingReader : public QThread
+{
+    Q_OBJECT
+public:
+    explicit ShmRingReader(QObject *parent = 0);
+    ~ShmRingReader();
+
+    /// POSIX shared memory available
+    static bool isSupported();
+
+    /*!
+     * \brief create create the shared memory object and the output files in strOutputPath
+     * \param bTakeRecords the per-LCU records are taken by takeLCUData() while decoding, otherwise they
+     * only go to decoder_*.txt
+     * \param bCacheToDisk also write the records taken to decoder_*.txt
+     */
+    bool create(const QString& strOutputPath, bool bTakeRecords, bool bCacheToDisk, qint64 iCapacity = 64*1024*1024);
+
+    /// copy every complete record out of the ring (thread safe)
+    void drain();
+    /// the decoder has exited: stop the thread and drain the rest
+    void finish();
+
+    /// per-LCU text received since the last call, if the records are taken (see create())
+    QByteArray takeLCUData(LCUInfoStream eStream);
+    QByteArray takeTileData();
+
+    ADD_CLASS_FIELD_NOSETTER(QString, strName, getName)             ///< shared memory object name for the decoder
+    ADD_CLASS_FIELD_NOSETTER(qint64, iPictureNum, getPictureNum)    ///< reconstructed pictures received
+
+protected:
+    void run();
+    void xRelease();
+    void xCopyOut(quint64 uiPos, char* pcDst, quint64 uiLength);
+    void xAppendRecord(quint32 uiType, const QByteArray& rcPayload);
+
+    QMutex m_cMutex;
+    QAtomicInt m_iStop;
+    uchar* m_puhBase;                                   ///< mapped header
+    quint64 m_uiMapSize;
+    quint64 m_uiCapacity;
+    bool m_bUnlinked;                                   ///< name removed once the decoder is attached
+    bool m_bTakeRecords;
+
+    QByteArray m_acLCUData[LCU_STREAM_NUM];
+    QByteArray m_cTileData;
+    QFile m_cYUVFile;                                   ///< decoder_yuv.yuv
+    QFile m_acCacheFile[LCU_STREAM_NUM+1];              ///< decoder_*.txt (+ tile), unless only taken
+};
+
+#endif // SHMRINGREADER_H
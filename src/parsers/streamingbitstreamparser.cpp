@@ -0,0 +1,343 @@
+#include "streamingbitstreamparser.h"
+#include "parsers/spsparser.h"
+#include "parsers/decodergeneralparser.h"
+#include "parsers/tileparser.h"
+#include "views/bitstreamversionselector.h"
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDir>
+#include <QDebug>
+#include <QtAlgorithms>
+#include <cstdlib>
+
+StreamingBitstreamParser::StreamingBitstreamParser(QObject *parent) :
+    QObject(parent)
+{
+    m_pcSequence = NULL;
+    m_bFinished = false;
+    m_bDecoderFinished = false;
+    m_bSpsParsed = false;
+    m_iParsedFrames = 0;
+    m_iTileFrames = 0;
+    m_iIDRGroup = 0;
+}
+
+StreamingBitstreamParser::~StreamingBitstreamParser()
+{
+    /// m_cBitstreamParser kills the decoder if it is still running
+}
+
+bool StreamingBitstreamParser::start(QString strDecoderFolder,
+                                     int iEncoderVersion,
+                                     QString strBitstreamFilePath,
+                                     QString strOutputPath,
+                                     ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
+
+    /// only HM writes the per-LCU txt files while decoding
+    if( iEncoderVersion != HM40 && iEncoderVersion != HM52 &&
+        iEncoderVersion != HM100 && iEncoderVersion != HM120 )
+        return false;
+
+    m_pcSequence = pcSequence;
+    m_strFileName = strBitstreamFilePath;
+    m_strOutputPath = strOutputPath;
+
+    /// remove stale output, it would be followed before the decoder truncates it
+    QDir cOutputDir(strOutputPath);
+    QStringList cStaleFiles = cOutputDir.entryList(QStringList() << "decoder_*.txt" << "*.yuv", QDir::Files);
+    foreach(const QString& strStaleFile, cStaleFiles)
+        cOutputDir.remove(strStaleFile);
+
+    if( !m_cBitstreamParser.startDecoding(strDecoderFolder, iEncoderVersion, strBitstreamFilePath, strOutputPath, false) )
+        return false;
+    m_pcSequence->setDecodingFolder(strOutputPath);
+    return true;
+}
+
+bool StreamingBitstreamParser::poll(int iMsecs)
+{
+    if( m_bFinished )
+        return true;
+
+    m_bDecoderFinished = m_cBitstreamParser.waitForDecoding(iMsecs);
+
+    /// YUV frames are counted before the POC lines are read:
+    /// HM prints the POC line of a picture before writing it out
+    qint64 iYUVFrames = xGetYUVFrameNum();
+    if( !m_bDecoderFinished )
+        m_bDecoderFinished = m_cBitstreamParser.waitForDecoding(0);
+
+    /// POC lines first, all the LCU lines of these frames are in the txt files then
+    xParseGeneral();
+
+    if( !m_bSpsParsed )
+        m_bSpsParsed = xParseSps();
+    if( !m_bSpsParsed )
+    {
+        m_bFinished = m_bDecoderFinished;
+        return !m_bFinished;
+    }
+
+    /// the LCU records of the frames above are in the ring now
+    if( m_cBitstreamParser.getShmReader() != NULL )
+        m_cBitstreamParser.getShmReader()->drain();
+
+    if( !xParseLCUs() || !xParseTiles() )
+        return false;
+
+    xPublishFrames(iYUVFrames);
+
+    m_bFinished = m_bDecoderFinished;
+    return true;
+}
+
+bool StreamingBitstreamParser::isSequenceReady() const
+{
+    return m_bSpsParsed && !m_pcSequence->getFramesInDisOrder().empty();
+}
+
+bool StreamingBitstreamParser::xReadNewData(TailFile& rcTail, const QString& strFilename)
+{
+    if( !rcTail.cFile.isOpen() )
+    {
+        /// analysis files are created when the decoder meets the first SPS
+        if( !QFile::exists(strFilename) )
+            return false;
+        rcTail.cFile.setFileName(strFilename);
+        if( !rcTail.cFile.open(QIODevice::ReadOnly) )
+            return false;
+    }
+    rcTail.cData.append(rcTail.cFile.readAll());
+    return true;
+}
+
+bool StreamingBitstreamParser::xReadNewLCUData(int iStream)
+{
+    ShmRingReader* pcShmReader = m_cBitstreamParser.getShmReader();
+    if( pcShmReader == NULL )
+        return xReadNewData(m_acLCUTail[iStream], m_strOutputPath + g_apchLCUFiles[iStream]);
+    m_acLCUTail[iStream].cData.append(pcShmReader->takeLCUData((LCUInfoStream)iStream));
+    return true;
+}
+
+bool StreamingBitstreamParser::xReadNewTileData()
+{
+    ShmRingReader* pcShmReader = m_cBitstreamParser.getShmReader();
+    if( pcShmReader == NULL )
+        return xReadNewData(m_cTileTail, m_strOutputPath + "/decoder_tile.txt");
+    m_cTileTail.cData.append(pcShmReader->takeTileData());
+    return true;
+}
+
+int StreamingBitstreamParser::xCompleteLength(const QByteArray& rcData)
+{
+    /// the last line may be half written
+    return rcData.lastIndexOf('\n') + 1;
+}
+
+void StreamingBitstreamParser::xScanFrames(const QByteArray& rcData, int iLength, QVector<int>& raiFrameStart)
+{
+    /// <poc,addr> ... a new POC starts a new frame (same as the parsers)
+    raiFrameStart.clear();
+    const char* pcData = rcData.constData();
+    int iLastPOC = 0;
+    int iPos = 0;
+    while( iPos < iLength )
+    {
+        if( pcData[iPos] == '<' )
+        {
+            int iPoc = (int)strtol(pcData+iPos+1, NULL, 10);
+            if( raiFrameStart.empty() || iPoc != iLastPOC )
+                raiFrameStart.push_back(iPos);
+            iLastPOC = iPoc;
+        }
+        int iLineEnd = rcData.indexOf('\n', iPos);
+        iPos = (iLineEnd < 0) ? iLength : iLineEnd+1;
+    }
+}
+
+bool StreamingBitstreamParser::xParseSps()
+{
+    /// the last line of decoder_sps.txt is the input bit depth
+    QFile cSPSFile(m_strOutputPath + "/decoder_sps.txt");
+    if( !cSPSFile.open(QIODevice::ReadOnly) )
+        return false;
+    if( !cSPSFile.readAll().contains("Input Bit Depth:") )
+        return false;
+    cSPSFile.seek(0);
+    QTextStream cSPSTextStream(&cSPSFile);
+    SpsParser cSpsParser;
+    bool bSuccess = cSpsParser.parseFile( &cSPSTextStream, m_pcSequence );
+    qDebug() << "SPS file parsing finished";
+    return bSuccess;
+}
+
+void StreamingBitstreamParser::xParseGeneral()
+{
+    if( !xReadNewData(m_cGeneralTail, m_strOutputPath + "/decoder_general.txt") )
+        return;
+    int iLength = xCompleteLength(m_cGeneralTail.cData);
+    if( iLength == 0 )
+        return;
+
+    DecoderGeneralParser cDecoderGeneralParser;
+    QList<QByteArray> cLines = m_cGeneralTail.cData.left(iLength).split('\n');
+    foreach(const QByteArray& cLine, cLines)
+    {
+        QString strOneLine = QString::fromLocal8Bit(cLine);
+        ComFrame* pcFrame = cDecoderGeneralParser.parseFrameLine(strOneLine, m_pcSequence);
+        if( pcFrame == NULL )
+        {
+            cDecoderGeneralParser.parseInfoLine(strOneLine, m_pcSequence);
+            continue;
+        }
+        /// every POC 0 frame (except the first one) starts a new IDR group
+        if( pcFrame->getPOC() == 0 && !m_pcSequence->getFramesInDecOrder().empty() )
+            m_iIDRGroup++;
+        m_aiIDRGroup.push_back(m_iIDRGroup);
+        m_pcSequence->getFramesInDecOrder().push_back(pcFrame);
+    }
+    m_cGeneralTail.cData.remove(0, iLength);
+}
+
+bool StreamingBitstreamParser::xParseLCUs()
+{
+    /// frames whose POC line is known are complete in every file
+    int iNewFrames = m_pcSequence->getFramesInDecOrder().size() - m_iParsedFrames;
+    int aiLength[LCU_STREAM_NUM];
+    QVector<int> aaiFrameStart[LCU_STREAM_NUM];
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        if( !xReadNewLCUData(i) )
+            return true;
+        aiLength[i] = xCompleteLength(m_acLCUTail[i].cData);
+        xScanFrames(m_acLCUTail[i].cData, aiLength[i], aaiFrameStart[i]);
+        iNewFrames = qMin(iNewFrames, aaiFrameStart[i].size());
+    }
+    if( iNewFrames <= 0 )
+        return true;
+
+    /// cut every file right before the first frame which is not known yet
+    QByteArray acFrameData[LCU_STREAM_NUM];
+    IntTokenizer* apcTokenizer[LCU_STREAM_NUM];
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        if( aaiFrameStart[i].size() > iNewFrames )
+            aiLength[i] = aaiFrameStart[i][iNewFrames];
+        acFrameData[i] = QByteArray::fromRawData(m_acLCUTail[i].cData.constData(), aiLength[i]);
+        apcTokenizer[i] = new IntTokenizer(acFrameData[i]);
+    }
+
+    LCUInfoParser cLCUInfoParser;
+    bool bSuccess = cLCUInfoParser.parseFile( apcTokenizer, m_pcSequence, m_iParsedFrames );
+
+    for(int i = 0; i < LCU_STREAM_NUM; i++)
+    {
+        delete apcTokenizer[i];
+        acFrameData[i].clear();
+        m_acLCUTail[i].cData.remove(0, aiLength[i]);
+    }
+    if( !bSuccess )
+        return false;
+
+    for(int i = 0; i < iNewFrames; i++)
+        m_aiPendingFrames.push_back(m_iParsedFrames+i);
+    m_iParsedFrames += iNewFrames;
+    return true;
+}
+
+bool StreamingBitstreamParser::xParseTiles()
+{
+    /// no tile file before HM-5.2
+    if( !xReadNewTileData() )
+        return true;
+
+    int iComplete = xCompleteLength(m_cTileTail.cData);
+    QVector<int> aiFrameStart;
+    xScanFrames(m_cTileTail.cData, iComplete, aiFrameStart);
+
+    /// tile lines are written at the end of a picture, the last frame may be incomplete
+    int iNewFrames = aiFrameStart.size() - (m_bDecoderFinished ? 0 : 1);
+    iNewFrames = qMin(iNewFrames, m_iParsedFrames - m_iTileFrames);
+    if( iNewFrames <= 0 )
+        return true;
+    int iLength = (aiFrameStart.size() > iNewFrames) ? aiFrameStart[iNewFrames] : iComplete;
+
+    QByteArray cFrameData = QByteArray::fromRawData(m_cTileTail.cData.constData(), iLength);
+    bool bSuccess;
+    {
+        IntTokenizer cTileTokenizer(cFrameData);
+        TileParser cTileParser;
+        bSuccess = cTileParser.parseFile( &cTileTokenizer, m_pcSequence, m_iTileFrames );
+    }
+    cFrameData.clear();
+    m_cTileTail.cData.remove(0, iLength);
+    m_iTileFrames += iNewFrames;
+    return bSuccess;
+}
+
+qint64 StreamingBitstreamParser::xGetYUVFrameNum()
+{
+    if( !m_bSpsParsed )
+        return 0;
+    qint64 iFrameSize = (qint64)m_pcSequence->getWidth() * m_pcSequence->getHeight() * 3 / 2;
+    if( m_pcSequence->getInputBitDepth() > 8 )
+        iFrameSize *= 2;
+    if( iFrameSize <= 0 )
+        return 0;
+    return QFileInfo(m_strOutputPath + "/decoder_yuv.yuv").size() / iFrameSize;
+}
+
+bool StreamingBitstreamParser::xDisplayBefore(int iDecOrderFirst, int iDecOrderSecond) const
+{
+    if( m_aiIDRGroup[iDecOrderFirst] != m_aiIDRGroup[iDecOrderSecond] )
+        return m_aiIDRGroup[iDecOrderFirst] < m_aiIDRGroup[iDecOrderSecond];
+    const QVector<ComFrame*>& rcDecOrder = m_pcSequence->getFramesInDecOrder();
+    return rcDecOrder[iDecOrderFirst]->getPOC() < rcDecOrder[iDecOrderSecond]->getPOC();
+}
+
+void StreamingBitstreamParser::xPublishFrames(qint64 iYUVFrames)
+{
+    QVector<ComFrame*>& rcDecOrder = m_pcSequence->getFramesInDecOrder();
+    QVector<ComFrame*>& rcDisOrder = m_pcSequence->getFramesInDisOrder();
+
+    /// frames without LCU info are displayed anyway once the decoder is gone
+    if( m_bDecoderFinished && m_iParsedFrames < rcDecOrder.size() )
+    {
+        qWarning() << "LCU info is missing for" << rcDecOrder.size()-m_iParsedFrames << "frames";
+        for(int i = m_iParsedFrames; i < rcDecOrder.size(); i++)
+            m_aiPendingFrames.push_back(i);
+        m_iParsedFrames = rcDecOrder.size();
+    }
+
+    /// the earliest (in displaying order) frame which is decoded but not parsed yet
+    int iFirstUnparsed = -1;
+    for(int i = m_iParsedFrames; i < rcDecOrder.size(); i++)
+    {
+        if( iFirstUnparsed == -1 || xDisplayBefore(i, iFirstUnparsed) )
+            iFirstUnparsed = i;
+    }
+
+    qSort(m_aiPendingFrames.begin(), m_aiPendingFrames.end(),
+          [this](int iFirst, int iSecond) { return xDisplayBefore(iFirst, iSecond); });
+
+    /// the decoder writes out pictures in displaying order,
+    /// a frame is final once its reconstruction is written
+    int iPublished = 0;
+    while( iPublished < m_aiPendingFrames.size() )
+    {
+        int iDecOrder = m_aiPendingFrames[iPublished];
+        if( !m_bDecoderFinished && rcDisOrder.size() >= iYUVFrames )
+            break;
+        if( iFirstUnparsed != -1 && !xDisplayBefore(iDecOrder, iFirstUnparsed) )
+            break;
+        ComFrame* pcFrame = rcDecOrder[iDecOrder];
+        pcFrame->setFrameCount(rcDisOrder.size());
+        rcDisOrder.push_back(pcFrame);
+        iPublished++;
+    }
+    m_aiPendingFrames.remove(0, iPublished);
+    m_pcSequence->setTotalFrames(rcDisOrder.size());
+}
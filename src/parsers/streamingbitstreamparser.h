@@ -0,0 +1,99 @@
+#ifndef STREAMINGBITSTREAMPARSER_H
+#define STREAMINGBITSTREAMPARSER_H
+
+#include <QObject>
+#include <QFile>
+#include <QByteArray>
+#include <QVector>
+#include "gitldef.h"
+#include "parsers/bitstreamparser.h"
+#include "parsers/lcuinfoparser.h"
+#include "model/common/comsequence.h"
+
+/*!
+ * \brief The StreamingBitstreamParser class
+ * this class decodes a bitstream and builds the sequence while the decoder is still running.
+ * The decoder output files are followed as they grow:
+ * a frame is parsed as soon as its POC line shows up in decoder_general.txt (HM writes
+ * all the LCU lines of a picture before its POC line), and it is appended to the
+ * displaying order once its reconstruction is in decoder_yuv.yuv.
+ * ComSequence::getTotalFrames() is the number of frames that can be displayed so far.
+ * With the shared memory transport the LCU lines come from ShmRingReader instead of the txt files.
+ */
+
+class StreamingBitstreamParser : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StreamingBitstreamParser(QObject *parent = 0);
+    ~StreamingBitstreamParser();
+
+    /// start decoding (HM decoders only), the sequence is filled by poll()
+    bool start(QString strDecoderFolder,
+               int iEncoderVersion,
+               QString strBitstreamFilePath,
+               QString strOutputPath,
+               ComSequence* pcSequence);
+
+    /// see BitstreamParser::setSharedMemoryTransport, call it before start() (the records are taken at each poll())
+    void setSharedMemoryTransport(bool bEnable, bool bCacheToDisk)
+    { m_cBitstreamParser.setSharedMemoryTransport(bEnable, bCacheToDisk, true); }
+
+    /// see BitstreamParser::setFollow, call it before start(); frames keep coming until stopFollowing()
+    void setFollow(bool bFollow) { m_cBitstreamParser.setFollow(bFollow); }
+    void stopFollowing() { m_cBitstreamParser.stopFollowing(); }
+
+    /*!
+     * \brief poll wait for the decoder at most iMsecs, then parse all the complete output
+     * \return false if the decoder output can not be parsed
+     */
+    bool poll(int iMsecs);
+
+    /// SPS is known and at least one frame can be displayed
+    bool isSequenceReady() const;
+    /// decoder exited normally
+    bool isDecodingSuccessful() const { return m_cBitstreamParser.isDecodingSuccessful(); }
+
+    ADD_CLASS_FIELD_NOSETTER(ComSequence*, pcSequence, getSequence)     ///< sequence being built
+    ADD_CLASS_FIELD_NOSETTER(QString, strFileName, getFileName)          ///< bitstream file of the sequence
+    ADD_CLASS_FIELD_NOSETTER(bool, bFinished, isFinished)                ///< decoder exited and all its output is parsed
+
+protected:
+    /// one decoder output file which is still being written
+    struct TailFile
+    {
+        QFile cFile;
+        QByteArray cData;       ///< read but not parsed yet
+    };
+
+    bool xReadNewData(TailFile& rcTail, const QString& strFilename);
+    bool xReadNewLCUData(int iStream);
+    bool xReadNewTileData();
+    static int xCompleteLength(const QByteArray& rcData);
+    static void xScanFrames(const QByteArray& rcData, int iLength, QVector<int>& raiFrameStart);
+
+    bool xParseSps();
+    void xParseGeneral();
+    bool xParseLCUs();
+    bool xParseTiles();
+    void xPublishFrames(qint64 iYUVFrames);
+    qint64 xGetYUVFrameNum();
+    bool xDisplayBefore(int iDecOrderFirst, int iDecOrderSecond) const;
+
+    BitstreamParser m_cBitstreamParser;
+    QString m_strOutputPath;
+    bool m_bDecoderFinished;
+    bool m_bSpsParsed;
+
+    TailFile m_cGeneralTail;                    ///< decoder_general.txt
+    TailFile m_acLCUTail[LCU_STREAM_NUM];       ///< per-LCU txt files
+    TailFile m_cTileTail;                       ///< decoder_tile.txt
+
+    int m_iParsedFrames;                        ///< frames (in decoding order) with LCU info
+    int m_iTileFrames;                          ///< frames (in decoding order) with tile info
+    int m_iIDRGroup;                            ///< current IDR group (frames are displayed in POC order in a group)
+    QVector<int> m_aiIDRGroup;                  ///< IDR group of each frame, in decoding order
+    QVector<int> m_aiPendingFrames;             ///< parsed but not displayed yet, in decoding order
+};
+
+#endif // STREAMINGBITSTREAMPARSER_H
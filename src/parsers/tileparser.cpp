@@ -1,81 +1,58 @@
 #include "tileparser.h"
-#include <QRegExp>
-
+#include <QDebug>
 
 TileParser::TileParser(QObject *parent) :
     QObject(parent)
 {
-
 }
 
 bool TileParser::parseFile(QTextStream *pcInputStream, ComSequence *pcSequence)
 {
-    Q_ASSERT(pcSequence != NULL);
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
 
-    QString strOneLine;
-    QRegExp cMatchTarget;
+bool TileParser::parseFile(IntTokenizer *pcTokenizer, ComSequence *pcSequence, int iFirstDecOrder)
+{
+    Q_ASSERT(pcSequence != NULL);
 
     ///<1,1> 0 4 4
     ///read one tile
     ComFrame * pcFrame = NULL;
-
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-
-    QTextStream cTileInfoStream;
-    int iDecOrder = -1;
+    int iDecOrder = iFirstDecOrder-1;
     int iLastPOC = -1;
-
-
-    while(!pcInputStream->atEnd())
+    int iPoc, iTileNum;
+    while( pcTokenizer->readLCUHeader(iPoc, iTileNum) )
     {
-        strOneLine = pcInputStream->readLine();
-        if(cMatchTarget.indexIn(strOneLine) != -1)
+        ///poc addr and iTileNum
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            ///poc addr and iTileNum
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-
-            int iTileNum = cMatchTarget.cap(2).toInt();
-            //pcFrame->m_iTileNum = iTileNum;
-
-            QString strTileInfo = cMatchTarget.cap(3);
-            cTileInfoStream.setString( &strTileInfo, QIODevice::ReadOnly);
-
-            xReadTile(&cTileInfoStream, pcFrame);
+            qCritical() << "TileParser Error! No frame of POC" << iPoc;
+            return false;
         }
-
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        //pcFrame->m_iTileNum = iTileNum;
+        xReadTile(pcTokenizer, pcFrame);
     }
-
     return true;
 }
 
-
-
-bool TileParser::xReadTile(QTextStream *pcTileInfoStream, ComFrame *pcFrame)
+bool TileParser::xReadTile(IntTokenizer *pcTokenizer, ComFrame *pcFrame)
 {
-
-    int iTempVal = 0;
-    ComTile * pcTile = NULL;
-    pcTile = new ComTile(pcFrame);
-
-    Q_ASSERT( !pcTileInfoStream->atEnd() );
-    *pcTileInfoStream >> iTempVal;
-    pcTile->setFirstCUAddr(iTempVal);
-
-    Q_ASSERT( !pcTileInfoStream->atEnd() );
-    *pcTileInfoStream >> iTempVal;
-    pcTile->setWidth(iTempVal);
-
-    Q_ASSERT( !pcTileInfoStream ->atEnd() );
-    *pcTileInfoStream >> iTempVal;
-    pcTile->setHeight(iTempVal);
-
+    int iFirstCUAddr = 0, iWidth = 0, iHeight = 0;
+    if( !pcTokenizer->readInt(iFirstCUAddr) ||
+        !pcTokenizer->readInt(iWidth) ||
+        !pcTokenizer->readInt(iHeight) )
+        return false;
+
+    ComTile * pcTile = new ComTile(pcFrame);
+    pcTile->setFirstCUAddr(iFirstCUAddr);
+    pcTile->setWidth(iWidth);
+    pcTile->setHeight(iHeight);
     pcFrame->getTiles().push_back(pcTile);
-
     return true;
-
 }
-
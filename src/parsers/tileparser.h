@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTextStream>
 #include"model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 
 class TileParser : public QObject
 {
@@ -12,8 +13,10 @@ public:
     explicit TileParser(QObject *parent = 0);
 
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    /// iFirstDecOrder : decoding order of the first frame in the file
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence, int iFirstDecOrder = 0);
 protected:
-    bool xReadTile(QTextStream* pcTileInfoStream, ComFrame * pcFrame);
+    bool xReadTile(IntTokenizer* pcTokenizer, ComFrame * pcFrame);
 
 signals:
 
@@ -0,0 +1,186 @@
+#include "tsdemuxer.h"
+#include <QDebug>
+
+#define TS_SYNC_BYTE            0x47
+#define TS_PID_PAT              0
+#define TS_STREAM_TYPE_HEVC     0x24
+#define TS_READ_PACKETS         1024            ///< packets read from the file at once
+#define TS_PROBE_SIZE           (8 << 20)       ///< bytes searched for the PAT and the PMT
+
+TSDemuxer::TSDemuxer()
+{
+    m_iPacketSize = TS_PACKET_SIZE;
+    m_iPmtPid = -1;
+    m_iVideoPid = -1;
+    m_iReadPos = 0;
+}
+
+int TSDemuxer::findPacketSize(const uchar* pucData, int iSize)
+{
+    if( iSize > TS_PACKET_SIZE && pucData[0] == TS_SYNC_BYTE && pucData[TS_PACKET_SIZE] == TS_SYNC_BYTE )
+        return TS_PACKET_SIZE;
+    int iOffset = TS_PACKET_SIZE_M2TS - TS_PACKET_SIZE;
+    if( iSize > TS_PACKET_SIZE_M2TS + iOffset &&
+        pucData[iOffset] == TS_SYNC_BYTE && pucData[TS_PACKET_SIZE_M2TS + iOffset] == TS_SYNC_BYTE )
+        return TS_PACKET_SIZE_M2TS;
+    return 0;
+}
+
+bool TSDemuxer::open(const QString& strFilePath)
+{
+    m_cFile.setFileName(strFilePath);
+    if( !m_cFile.open(QIODevice::ReadOnly) )
+        return false;
+    QByteArray cHead = m_cFile.peek(TS_PACKET_SIZE_M2TS*2);
+    m_iPacketSize = findPacketSize((const uchar*)cHead.constData(), cHead.size());
+    if( m_iPacketSize == 0 )
+        return false;
+
+    /// the PIDs from the tables at the start of the stream
+    const uchar* pucPacket;
+    while( m_iVideoPid < 0 && m_cFile.pos() < TS_PROBE_SIZE && (pucPacket = xNextPacket()) != NULL )
+    {
+        int iPid = ((pucPacket[1] & 0x1f) << 8) | pucPacket[2];
+        int iPayload = 4;
+        if( pucPacket[3] & 0x20 )
+            iPayload += 1 + pucPacket[4];
+        if( !(pucPacket[1] & 0x40) || !(pucPacket[3] & 0x10) || iPayload >= TS_PACKET_SIZE )
+            continue;
+        if( iPid == TS_PID_PAT )
+            xParsePAT(pucPacket + iPayload, TS_PACKET_SIZE - iPayload);
+        else if( iPid == m_iPmtPid )
+            xParsePMT(pucPacket + iPayload, TS_PACKET_SIZE - iPayload);
+    }
+    if( m_iVideoPid < 0 )
+    {
+        qCritical() << "No HEVC stream in transport stream" << strFilePath;
+        return false;
+    }
+
+    /// demux from the start
+    m_cFile.seek(0);
+    m_cReadBuffer.clear();
+    m_iReadPos = 0;
+    m_iBytesRead = 0;
+    return true;
+}
+
+bool TSDemuxer::readAccessUnit(QByteArray& rcAnnexB)
+{
+    const uchar* pucPacket;
+    while( (pucPacket = xNextPacket()) != NULL )
+    {
+        int iPid = ((pucPacket[1] & 0x1f) << 8) | pucPacket[2];
+        if( iPid != m_iVideoPid || !(pucPacket[3] & 0x10) )
+            continue;
+        int iPayload = 4;
+        if( pucPacket[3] & 0x20 )
+            iPayload += 1 + pucPacket[4];
+        if( iPayload >= TS_PACKET_SIZE )
+            continue;
+        const char* pchPayload = (const char*)pucPacket + iPayload;
+        int iPayloadSize = TS_PACKET_SIZE - iPayload;
+
+        /// a new PES packet, the last one is complete
+        if( pucPacket[1] & 0x40 )
+        {
+            bool bFinished = xFinishPES(rcAnnexB);
+            m_cPES = QByteArray(pchPayload, iPayloadSize);
+            if( bFinished )
+                return true;
+        }
+        else if( !m_cPES.isEmpty() )
+        {
+            m_cPES.append(pchPayload, iPayloadSize);
+        }
+    }
+    return xFinishPES(rcAnnexB);
+}
+
+const uchar* TSDemuxer::xNextPacket()
+{
+    int iPrefix = m_iPacketSize - TS_PACKET_SIZE;
+    while( true )
+    {
+        if( m_iReadPos + m_iPacketSize > m_cReadBuffer.size() )
+        {
+            m_cReadBuffer = m_cReadBuffer.mid(m_iReadPos) + m_cFile.read(m_iPacketSize * TS_READ_PACKETS);
+            m_iReadPos = 0;
+            if( m_cReadBuffer.size() < m_iPacketSize )
+                return NULL;
+        }
+        const uchar* pucPacket = (const uchar*)m_cReadBuffer.constData() + m_iReadPos + iPrefix;
+        if( pucPacket[0] == TS_SYNC_BYTE )
+        {
+            m_iReadPos += m_iPacketSize;
+            m_iBytesRead = m_cFile.pos() - (m_cReadBuffer.size() - m_iReadPos);
+            return pucPacket;
+        }
+
+        /// lost sync, go on from the next sync byte
+        qWarning() << "Transport stream out of sync at" << m_cFile.pos() - (m_cReadBuffer.size() - m_iReadPos);
+        int iSync = m_cReadBuffer.indexOf(char(TS_SYNC_BYTE), m_iReadPos + iPrefix + 1);
+        m_iReadPos = (iSync < 0) ? m_cReadBuffer.size() : qMax(iSync - iPrefix, m_iReadPos + 1);
+    }
+}
+
+void TSDemuxer::xParsePAT(const uchar* pucPayload, int iSize)
+{
+    /// pointer field, then the section
+    int iSection = 1 + pucPayload[0];
+    if( iSection + 8 > iSize || pucPayload[iSection] != 0x00 )
+        return;
+    const uchar* pucSection = pucPayload + iSection;
+    int iEnd = qMin(3 + (((pucSection[1] & 0x0f) << 8) | pucSection[2]) - 4, iSize - iSection);  ///< CRC excluded
+    for( int i = 8; i + 4 <= iEnd; i += 4 )
+    {
+        int iProgram = (pucSection[i] << 8) | pucSection[i+1];
+        if( iProgram != 0 )     ///< 0 is the network PID
+        {
+            m_iPmtPid = ((pucSection[i+2] & 0x1f) << 8) | pucSection[i+3];
+            return;
+        }
+    }
+}
+
+void TSDemuxer::xParsePMT(const uchar* pucPayload, int iSize)
+{
+    int iSection = 1 + pucPayload[0];
+    if( iSection + 12 > iSize || pucPayload[iSection] != 0x02 )
+        return;
+    const uchar* pucSection = pucPayload + iSection;
+    int iEnd = qMin(3 + (((pucSection[1] & 0x0f) << 8) | pucSection[2]) - 4, iSize - iSection);
+    int i = 12 + (((pucSection[10] & 0x0f) << 8) | pucSection[11]);
+    while( i + 5 <= iEnd )
+    {
+        int iStreamType = pucSection[i];
+        int iPid = ((pucSection[i+1] & 0x1f) << 8) | pucSection[i+2];
+        if( iStreamType == TS_STREAM_TYPE_HEVC )
+        {
+            m_iVideoPid = iPid;
+            return;
+        }
+        i += 5 + (((pucSection[i+3] & 0x0f) << 8) | pucSection[i+4]);
+    }
+}
+
+bool TSDemuxer::xFinishPES(QByteArray& rcAnnexB)
+{
+    if( m_cPES.isEmpty() )
+        return false;
+    QByteArray cPES = m_cPES;
+    m_cPES.clear();
+
+    /// start code prefix, stream id, length, two flag bytes, header data length
+    const uchar* pucPES = (const uchar*)cPES.constData();
+    if( cPES.size() < 9 || pucPES[0] != 0 || pucPES[1] != 0 || pucPES[2] != 1 )
+    {
+        qWarning() << "Broken PES packet before" << m_iBytesRead;
+        return false;
+    }
+    int iHeader = 9 + pucPES[8];
+    if( iHeader >= cPES.size() )
+        return false;
+    rcAnnexB.append(cPES.constData() + iHeader, cPES.size() - iHeader);
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef TSDEMUXER_H
+#define TSDEMUXER_H
+
+#include "parsers/containerdemuxer.h"
+
+#define TS_PACKET_SIZE          188
+#define TS_PACKET_SIZE_M2TS     192     ///< a 4-byte time stamp in front of every packet (Blu-ray, AVCHD)
+
+/*!
+ * \brief The TSDemuxer class
+ * HEVC video (stream type 0x24) of an MPEG-2 transport stream, found through the PAT and the PMT
+ * of the first program. The PES payload of HEVC is Annex-B already, one PES packet is one access unit.
+ */
+
+class TSDemuxer : public ContainerDemuxer
+{
+public:
+    TSDemuxer();
+
+    bool open(const QString& strFilePath);
+    bool readAccessUnit(QByteArray& rcAnnexB);
+
+    /// TS_PACKET_SIZE or TS_PACKET_SIZE_M2TS if the data starts with two packets of that size, 0 otherwise
+    static int findPacketSize(const uchar* pucData, int iSize);
+
+protected:
+    /// next packet of the file (the 188 bytes from the sync byte on), NULL at the end
+    const uchar* xNextPacket();
+    void xParsePAT(const uchar* pucPayload, int iSize);
+    void xParsePMT(const uchar* pucPayload, int iSize);
+    /// append the payload of the PES packet collected so far, false if there is none
+    bool xFinishPES(QByteArray& rcAnnexB);
+
+    int m_iPacketSize;
+    int m_iPmtPid;                  ///< -1 before the PAT
+    int m_iVideoPid;                ///< -1 before the PMT
+    QByteArray m_cPES;              ///< video PES packet being collected
+    QByteArray m_cReadBuffer;
+    int m_iReadPos;
+};
+
+#endif // TSDEMUXER_H
@@ -1,5 +1,4 @@
 #include "tuparser.h"
-#include <QRegExp>
 #include <QDebug>
 
 #define TU_SLIPT_FLAG 99
@@ -12,59 +11,53 @@ TUParser::TUParser(QObject *parent):
 
 bool TUParser::parseFile(QTextStream* pcInputStream, ComSequence* pcSequence)
 {
-    Q_ASSERT( pcSequence != NULL );
+    QByteArray cData = pcInputStream->readAll().toLatin1();
+    IntTokenizer cTokenizer(cData);
+    return parseFile(&cTokenizer, pcSequence);
+}
 
-    QString strOneLine;
-    QRegExp cMatchTarget;
 
+bool TUParser::parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence)
+{
+    Q_ASSERT( pcSequence != NULL );
 
     /// <1,1> 1 -3 0 1 -3 0 1 -3 0 1 1 0 1 -3 0
     /// read one LCU
     ComFrame* pcFrame = NULL;
     ComCU* pcLCU = NULL;
-    cMatchTarget.setPattern("^<(-?[0-9]+),([0-9]+)> (.*)");
-    QTextStream cTUInfoStream;
     int iDecOrder = -1;
     int iLastPOC  = -1;
-    while( !pcInputStream->atEnd() )
+    int iPoc, iAddr;
+    while( pcTokenizer->readLCUHeader(iPoc, iAddr) )
     {
-
-        strOneLine = pcInputStream->readLine();
-        if( cMatchTarget.indexIn(strOneLine) != -1 )
+        /// poc and lcu addr
+        if( pcFrame == NULL || iLastPOC != iPoc )
+            iDecOrder = pcSequence->findDecOrder(iPoc, iDecOrder+1);
+        iLastPOC = iPoc;
+        if( iDecOrder < 0 )
         {
-            /// poc and lcu addr
-            int iPoc = cMatchTarget.cap(1).toInt();
-            iDecOrder += (iLastPOC != iPoc);
-            iLastPOC = iPoc;
-
-            pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
-            int iAddr = cMatchTarget.cap(2).toInt();
-            pcLCU = pcFrame->getLCUs().at(iAddr);
-
-
-            ///
-            QString strTUInfo = cMatchTarget.cap(3);
-            cTUInfoStream.setString( &strTUInfo, QIODevice::ReadOnly );
-
-
-            xReadTU(&cTUInfoStream, pcLCU);
-
+            qCritical() << "TUParser Error! No frame of POC" << iPoc;
+            return false;
         }
 
+        pcFrame = pcSequence->getFramesInDecOrder().at(iDecOrder);
+        pcLCU = pcFrame->getLCUs().at(iAddr);
+
+        xReadTU(pcTokenizer, pcLCU);
     }
     return true;
 }
 
 
-bool TUParser::xReadTU(QTextStream* pcTUInfoStream, ComCU* pcCU)
+bool TUParser::xReadTU(IntTokenizer* pcTokenizer, ComCU* pcCU)
 {
     if( !pcCU->getSCUs().empty() )
     {
         /// non-leaf CU node : continue to leaf CU
-        xReadTU(pcTUInfoStream, pcCU->getSCUs().at(0));
-        xReadTU(pcTUInfoStream, pcCU->getSCUs().at(1));
-        xReadTU(pcTUInfoStream, pcCU->getSCUs().at(2));
-        xReadTU(pcTUInfoStream, pcCU->getSCUs().at(3));
+        xReadTU(pcTokenizer, pcCU->getSCUs().at(0));
+        xReadTU(pcTokenizer, pcCU->getSCUs().at(1));
+        xReadTU(pcTokenizer, pcCU->getSCUs().at(2));
+        xReadTU(pcTokenizer, pcCU->getSCUs().at(3));
     }
     else
     {
@@ -73,35 +66,35 @@ bool TUParser::xReadTU(QTextStream* pcTUInfoStream, ComCU* pcCU)
         pcTURoot->setX(pcCU->getX());
         pcTURoot->setY(pcCU->getY());
         pcTURoot->setSize(pcCU->getSize());
-        xReadTUHelper(pcTUInfoStream, &(pcCU->getTURoot()));
+        xReadTUHelper(pcTokenizer, &pcCU->getFrame()->getArena(), &(pcCU->getTURoot()));
     }
     return true;
 }
 
 
-bool TUParser::xReadTUHelper(QTextStream* pcCUInfoStream, ComTU* pcTU)
+bool TUParser::xReadTUHelper(IntTokenizer* pcTokenizer, ComArena* pcArena, ComTU* pcTU)
 {
     int iTUMode;
-    if( pcCUInfoStream->atEnd() )
+    if( !pcTokenizer->readInt(iTUMode) )
     {
         qCritical() << "TUParser Error! Illegal TU Mode!";
         return false;
     }
-    *pcCUInfoStream >> iTUMode;
 
     if( iTUMode == TU_SLIPT_FLAG )
     {
         /// non-leaf node : add 4 children CUs
+        ComTU* pcChildren = pcArena->newTUs(4);
+        pcTU->setTUs(pcChildren, 4);
         for(int i = 0; i < 4; i++)
         {
-            ComTU* pcChildNode = new ComTU();
+            ComTU* pcChildNode = &pcChildren[i];
             pcChildNode->setSize(pcTU->getSize()/2);
             int iSubCUX = pcTU->getX() + i%2 * (pcTU->getSize()/2);
             int iSubCUY = pcTU->getY() + i/2 * (pcTU->getSize()/2);
             pcChildNode->setX(iSubCUX);
             pcChildNode->setY(iSubCUY);
-            pcTU->getTUs().push_back(pcChildNode);
-            xReadTUHelper(pcCUInfoStream, pcChildNode);
+            xReadTUHelper(pcTokenizer, pcArena, pcChildNode);
         }
     }
     else
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QTextStream>
 #include "model/common/comsequence.h"
+#include "parsers/inttokenizer.h"
 
 class TUParser : public QObject
 {
@@ -10,9 +11,10 @@ class TUParser : public QObject
 public:
     explicit TUParser(QObject *parent = 0);
     bool parseFile(QTextStream* pcInputStream, ComSequence* pcSequence);
+    bool parseFile(IntTokenizer* pcTokenizer, ComSequence* pcSequence);
 protected:
-    bool xReadTU(QTextStream* pcCUInfoStream, ComCU* pcTU);
-    bool xReadTUHelper(QTextStream* pcCUInfoStream, ComTU *pcTU);
+    bool xReadTU(IntTokenizer* pcTokenizer, ComCU* pcTU);
+    bool xReadTUHelper(IntTokenizer* pcTokenizer, ComArena* pcArena, ComTU *pcTU);
 };
 
 #endif // TUPARSER_H
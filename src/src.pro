@@ -75,6 +75,9 @@ SOURCES += main.cpp \
     views/timelineindicatoritem.cpp \
     model/sequencemanager.cpp \
     model/common/comcu.cpp \
+    model/common/comarena.cpp \
+    model/common/comblockgrid.cpp \
+    model/common/comstatistics.cpp \
     views/filterconfigcheckbox.cpp \
     views/filterconfigdialog.cpp \
     views/filterconfigslider.cpp \
@@ -88,6 +91,28 @@ SOURCES += main.cpp \
     model/selectionmanager.cpp \
     commands/cleancachecommand.cpp \
     parsers/tileparser.cpp \
+    parsers/analysisbinparser.cpp \
+    parsers/lcuinfoparser.cpp \
+    parsers/parallellcuparser.cpp \
+    parsers/inttokenizer.cpp \
+    parsers/streamingbitstreamparser.cpp \
+    parsers/shmringreader.cpp \
+    commands/streambitstreamcommand.cpp \
+    model/analysiscache.cpp \
+    parsers/lcuindex.cpp \
+    parsers/parallelbitstreamparser.cpp \
+    parsers/annexbindex.cpp \
+    parsers/decoderoutputparser.cpp \
+    parsers/decodejob.cpp \
+    parsers/containerdemuxer.cpp \
+    parsers/tsdemuxer.cpp \
+    parsers/mp4demuxer.cpp \
+    parsers/growingfilereader.cpp \
+    parsers/annexbrangereader.cpp \
+    commands/decodejobcommand.cpp \
+    commands/canceldecodecommand.cpp \
+    commands/querymemorycommand.cpp \
+    model/memoryfootprint.cpp \
     model/common/comtile.cpp \
     commands/savefilterordercommand.cpp
 
@@ -98,6 +123,10 @@ HEADERS += \
     model/common/commv.h \
     model/common/compu.h \
     model/common/comcu.h \
+    model/common/comarena.h \
+    model/common/comnodelist.h \
+    model/common/comblockgrid.h \
+    model/common/comstatistics.h \
     model/drawengine/drawengine.h \
     views/mainwindow.h \
     model/io/ioyuv.h \
@@ -166,6 +195,29 @@ HEADERS += \
     model/selectionmanager.h \
     commands/cleancachecommand.h \
     parsers/tileparser.h \
+    parsers/analysisbinparser.h \
+    parsers/lcuinfoparser.h \
+    parsers/parallellcuparser.h \
+    parsers/inttokenizer.h \
+    parsers/streamingbitstreamparser.h \
+    parsers/shmringreader.h \
+    commands/streambitstreamcommand.h \
+    model/analysiscache.h \
+    parsers/lcuindex.h \
+    parsers/parallelbitstreamparser.h \
+    parsers/annexbindex.h \
+    parsers/decoderoutputparser.h \
+    parsers/decodejob.h \
+    parsers/containerdemuxer.h \
+    parsers/tsdemuxer.h \
+    parsers/mp4demuxer.h \
+    parsers/growingfilereader.h \
+    parsers/annexbrangereader.h \
+    commands/decodejobcommand.h \
+    commands/canceldecodecommand.h \
+    commands/querymemorycommand.h \
+    model/memoryfootprint.h \
+    model/common/comlculoader.h \
     model/common/comtile.h \
     commands/savefilterordercommand.h
 
@@ -184,6 +236,25 @@ CONFIG(release, debug|release){
     LIBS += -lGitlMVC  -lGitlEvtBus
 }
 
+# shm_open of the decoder shared memory transport
+unix:!macx: LIBS += -lrt
+
+# in-process decoding with the HM-12.0 library (qmake CONFIG+=hm_inprocess),
+# reference_decoders must be built first
+hm_inprocess {
+    DEFINES += HM_INPROCESS_DECODER
+    INCLUDEPATH += ../reference_decoders
+    SOURCES += parsers/inprocessdecoder.cpp
+    HEADERS += parsers/inprocessdecoder.h
+    LIBS += -L$${OUT_PWD}/../reference_decoders/HM-12.0/build
+    CONFIG(debug, debug|release){
+        LIBS += -lTLibSysuAnalyzerd -lTLibDecoderd -lTLibSysuAnalyzerd -lTLibCommond
+    }
+    CONFIG(release, debug|release){
+        LIBS += -lTLibSysuAnalyzer  -lTLibDecoder  -lTLibSysuAnalyzer  -lTLibCommon
+    }
+}
+
 FORMS += \
     views/mainwindow.ui \
     views/bitstreamversionselector.ui \
@@ -3,11 +3,23 @@
 #include "model/common/comrom.h"
 #include <QDebug>
 
+/// names of TSysuAnalyzerOutput::setCategories(), same order as xCategoryBoxes()
+static const char* s_apchCategoryNames[] =
+{
+    "cupu", "tu", "pred", "mv", "merge", "intra", "bit_lcu", "bit_scu", "tile"
+};
+
 BitstreamVersionSelector::BitstreamVersionSelector(QWidget *parent) :
     QDialog(parent),
     ui(new Ui::BitstreamVersionSelector)
 {
     ui->setupUi(this);
+    m_iFirstPOC = 0;
+    m_iLastPOC = -1;
+    m_iFirstFrame = 0;
+    m_iLastFrame = -1;
+    m_bPreScan = false;
+    m_bFollow = false;
 }
 
 BitstreamVersionSelector::~BitstreamVersionSelector()
@@ -66,6 +78,20 @@ void BitstreamVersionSelector::showEvent(QShowEvent * event)
         break;
 
     }
+
+    QStringList astrCategories = g_cAppSetting.value("last_analysis_categories", "").toString().split(',', QString::SkipEmptyParts);
+    QList<QCheckBox*> apcBoxes = xCategoryBoxes();
+    for(int i = 0; i < apcBoxes.size(); i++)
+        apcBoxes[i]->setChecked( astrCategories.empty() || astrCategories.contains(s_apchCategoryNames[i]) );
+    ui->catCUPU->setChecked(true);
+    ui->pocWindow->setChecked(g_cAppSetting.value("last_poc_window", false).toBool());
+    ui->firstPoc->setValue(g_cAppSetting.value("last_first_poc", 0).toInt());
+    ui->lastPoc->setValue(g_cAppSetting.value("last_last_poc", -1).toInt());
+    ui->frameRange->setChecked(g_cAppSetting.value("last_frame_range", false).toBool());
+    ui->firstFrame->setValue(g_cAppSetting.value("last_first_frame", 0).toInt());
+    ui->lastFrame->setValue(g_cAppSetting.value("last_last_frame", -1).toInt());
+    ui->preScan->setChecked(g_cAppSetting.value("last_pre_scan", false).toBool());
+    ui->follow->setChecked(g_cAppSetting.value("last_follow", false).toBool());
     QDialog::showEvent(event);
 }
 
@@ -74,12 +100,23 @@ void BitstreamVersionSelector::hideEvent(QHideEvent * event)
     /// save current selection
     xSetDecoderVersion();
     g_cAppSetting.setValue("last_bitstream_version", m_iBitstreamVersion);
+    xSetAnalysisSelection();
+    g_cAppSetting.setValue("last_analysis_categories", m_strAnalysisCategories);
+    g_cAppSetting.setValue("last_poc_window", ui->pocWindow->isChecked());
+    g_cAppSetting.setValue("last_first_poc", ui->firstPoc->value());
+    g_cAppSetting.setValue("last_last_poc", ui->lastPoc->value());
+    g_cAppSetting.setValue("last_frame_range", ui->frameRange->isChecked());
+    g_cAppSetting.setValue("last_first_frame", ui->firstFrame->value());
+    g_cAppSetting.setValue("last_last_frame", ui->lastFrame->value());
+    g_cAppSetting.setValue("last_pre_scan", ui->preScan->isChecked());
+    g_cAppSetting.setValue("last_follow", ui->follow->isChecked());
     QDialog::hideEvent(event);
 }
 
 void BitstreamVersionSelector::on_buttonBox_accepted()
 {
     xSetDecoderVersion();
+    xSetAnalysisSelection();
 }
 
 void BitstreamVersionSelector::xSetDecoderVersion()
@@ -105,3 +142,41 @@ void BitstreamVersionSelector::xSetDecoderVersion()
         m_iBitstreamVersion = AV1;
     }
 }
+
+QList<QCheckBox*> BitstreamVersionSelector::xCategoryBoxes()
+{
+    return QList<QCheckBox*>() << ui->catCUPU << ui->catTU << ui->catPred << ui->catMV << ui->catMerge
+                               << ui->catIntra << ui->catBitLCU << ui->catBitSCU << ui->catTile;
+}
+
+void BitstreamVersionSelector::xSetAnalysisSelection()
+{
+    /// every category checked is the full analysis (empty list)
+    QStringList astrCategories;
+    QList<QCheckBox*> apcBoxes = xCategoryBoxes();
+    for(int i = 0; i < apcBoxes.size(); i++)
+    {
+        if( apcBoxes[i]->isChecked() )
+            astrCategories << s_apchCategoryNames[i];
+    }
+    m_strAnalysisCategories = ( astrCategories.size() == apcBoxes.size() ) ? QString() : astrCategories.join(",");
+
+    m_iFirstPOC = 0;
+    m_iLastPOC = -1;
+    if( ui->pocWindow->isChecked() )
+    {
+        m_iFirstPOC = ui->firstPoc->value();
+        m_iLastPOC = ui->lastPoc->value();
+    }
+
+    m_iFirstFrame = 0;
+    m_iLastFrame = -1;
+    if( ui->frameRange->isChecked() )
+    {
+        m_iFirstFrame = ui->firstFrame->value();
+        m_iLastFrame = ui->lastFrame->value();
+    }
+
+    m_bPreScan = ui->preScan->isChecked();
+    m_bFollow = ui->follow->isChecked();
+}
@@ -2,6 +2,7 @@
 #define BITSTREAMVERSIONSELECTOR_H
 
 #include <QDialog>
+#include <QCheckBox>
 #include "gitldef.h"
 
 namespace Ui {
@@ -25,6 +26,13 @@ public:
     ~BitstreamVersionSelector();
 
     ADD_CLASS_FIELD(int, iBitstreamVersion, getBitstreamVersion, setBitstreamVersion)
+    ADD_CLASS_FIELD(QString, strAnalysisCategories, getAnalysisCategories, setAnalysisCategories)  ///< see BitstreamParser::setAnalysisSelection, empty for all
+    ADD_CLASS_FIELD(int, iFirstPOC, getFirstPOC, setFirstPOC)
+    ADD_CLASS_FIELD(int, iLastPOC, getLastPOC, setLastPOC)                                          ///< -1 for no upper limit
+    ADD_CLASS_FIELD(int, iFirstFrame, getFirstFrame, setFirstFrame)                                 ///< see DecodeJob::setFrameRange
+    ADD_CLASS_FIELD(int, iLastFrame, getLastFrame, setLastFrame)                                    ///< -1 for no upper limit
+    ADD_CLASS_FIELD(bool, bPreScan, getPreScan, setPreScan)                                         ///< see BitstreamParser::setPreScan
+    ADD_CLASS_FIELD(bool, bFollow, getFollow, setFollow)                                            ///< see BitstreamParser::setFollow
 
     private slots:
     void on_buttonBox_accepted();
@@ -40,6 +48,8 @@ protected:
     virtual void showEvent(QShowEvent * event);
     virtual void hideEvent(QHideEvent * event);
     void xSetDecoderVersion();
+    void xSetAnalysisSelection();
+    QList<QCheckBox*> xCategoryBoxes();
 
 private:
     Ui::BitstreamVersionSelector *ui;
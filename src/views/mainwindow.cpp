@@ -32,6 +32,7 @@ MainWindow::MainWindow(QWidget *parent) :
     listenToParams("snapshot", MAKE_CALLBACK(MainWindow::onSnapshot));
     listenToParams("current_sequence", MAKE_CALLBACK(MainWindow::onSequenceChanged));
     listenToParams("scale", MAKE_CALLBACK(MainWindow::onZooming));
+    listenToParams("decode_job_progress", MAKE_CALLBACK(MainWindow::onDecodeJobProgress));
 
     /// layout hacks
     ui->msgDockWidget->widget()->layout()->setContentsMargins(0,0,0,0);
@@ -126,6 +127,18 @@ void MainWindow::onZooming(GitlUpdateUIEvt &rcEvt)
     this->ui->zoomSpinBox->setValue(iPercent);
 }
 
+void MainWindow::onDecodeJobProgress(GitlUpdateUIEvt &rcEvt)
+{
+    QString strFilename = QFileInfo(rcEvt.getParameter("decode_job_file").toString()).fileName();
+    int iProgress = rcEvt.getParameter("decode_job_progress").toInt();
+    if( iProgress >= 100 )
+        statusBar()->clearMessage();
+    else if( iProgress < 0 )
+        statusBar()->showMessage(QString("Decoding %1... (Esc to cancel)").arg(strFilename));
+    else
+        statusBar()->showMessage(QString("Decoding %1... %2% (Esc to cancel)").arg(strFilename).arg(iProgress));
+}
+
 /// Keyboard Event
 void MainWindow::keyPressEvent ( QKeyEvent * event )
 {
@@ -139,6 +152,12 @@ void MainWindow::keyPressEvent ( QKeyEvent * event )
         /// Previous Frame
         on_nextFrame_clicked();
     }
+    else if(event->key() == Qt::Key_Escape )
+    {
+        /// Stop background decoding
+        GitlIvkCmdEvt cEvt("cancel_decode");
+        cEvt.dispatch();
+    }
 
 }
 
@@ -219,7 +238,15 @@ void MainWindow::on_actionOpen_bitstream_triggered()
     GitlIvkCmdEvt cEvt("open_bitstream");
     cEvt.setParameter("filename", strFilename);
     cEvt.setParameter("skip_decode", false);
+    cEvt.setParameter("streaming", true);
     cEvt.setParameter("version", cBitstreamDig.getBitstreamVersion());
+    cEvt.setParameter("analysis_categories", cBitstreamDig.getAnalysisCategories());
+    cEvt.setParameter("first_poc", cBitstreamDig.getFirstPOC());
+    cEvt.setParameter("last_poc", cBitstreamDig.getLastPOC());
+    cEvt.setParameter("first_frame", cBitstreamDig.getFirstFrame());
+    cEvt.setParameter("last_frame", cBitstreamDig.getLastFrame());
+    cEvt.setParameter("pre_scan", cBitstreamDig.getPreScan());
+    cEvt.setParameter("follow", cBitstreamDig.getFollow());
     cEvt.dispatch();
 
 }
@@ -312,7 +339,15 @@ void MainWindow::dropEvent(QDropEvent *event)
     GitlIvkCmdEvt cEvt("open_bitstream");
     cEvt.setParameter("filename", strFilename);
     cEvt.setParameter("skip_decode", false);
+    cEvt.setParameter("streaming", true);
     cEvt.setParameter("version", cBitstreamDig.getBitstreamVersion());
+    cEvt.setParameter("analysis_categories", cBitstreamDig.getAnalysisCategories());
+    cEvt.setParameter("first_poc", cBitstreamDig.getFirstPOC());
+    cEvt.setParameter("last_poc", cBitstreamDig.getLastPOC());
+    cEvt.setParameter("first_frame", cBitstreamDig.getFirstFrame());
+    cEvt.setParameter("last_frame", cBitstreamDig.getLastFrame());
+    cEvt.setParameter("pre_scan", cBitstreamDig.getPreScan());
+    cEvt.setParameter("follow", cBitstreamDig.getFollow());
     cEvt.dispatch();
 }
 
@@ -29,6 +29,7 @@ public:
     void onSnapshot(GitlUpdateUIEvt& rcEvt);
     void onSequenceChanged(GitlUpdateUIEvt& rcEvt);
     void onZooming(GitlUpdateUIEvt& rcEvt);
+    void onDecodeJobProgress(GitlUpdateUIEvt& rcEvt);
 
 protected:
     virtual void keyPressEvent ( QKeyEvent * event );
@@ -3,6 +3,8 @@
 #include "model/common/comsequence.h"
 #include "gitlivkcmdevt.h"
 #include <QFileInfo>
+#include <QHelpEvent>
+#include <QToolTip>
 
 
 SequenceList::SequenceList(QWidget *parent) :
@@ -15,6 +17,7 @@ SequenceList::SequenceList(QWidget *parent) :
     ///set listener
     listenToParams(QStringList()<<"sequences"<<"current_sequence",
                    MAKE_CALLBACK(SequenceList::onSequenceChanged) );
+    listenToParams("memory_footprint", MAKE_CALLBACK(SequenceList::onMemoryFootprint) );
 
     ///
     addNoSquenceRadioBtn();
@@ -64,7 +67,12 @@ void SequenceList::onSequenceChanged(GitlUpdateUIEvt &rcEvt)
             this->addItem(pcItem);
             ComSequence* pcSequence = ppcSequences->at(i);
             QFileInfo cFileInfo(pcSequence->getFileName());
-            SequenceListItem* seqRadioBtn = new SequenceListItem(cFileInfo.fileName(), m_cButtonGroup);
+            QString strName = cFileInfo.fileName();
+            if( pcSequence->getPreScan() )
+                strName += tr(" (pre-scan)");
+            if( pcSequence->getFollowing() )
+                strName += tr(" (live)");
+            SequenceListItem* seqRadioBtn = new SequenceListItem(strName, m_cButtonGroup);
             seqRadioBtn->setSequence(pcSequence);
             seqRadioBtn->setYUVSelectorStatus(pcSequence->getYUVRole());
             seqRadioBtn->setChecked(pcCurrentSequence == pcSequence);
@@ -88,6 +96,45 @@ void SequenceList::onSequenceChanged(GitlUpdateUIEvt &rcEvt)
 
 }
 
+void SequenceList::onMemoryFootprint(GitlUpdateUIEvt &rcEvt)
+{
+    QVariantList cFootprints = rcEvt.getParameter("memory_footprint").toList();
+    foreach(const QVariant& rcFootprint, cFootprints)
+    {
+        QVariantMap cMap = rcFootprint.toMap();
+        ComSequence* pcSequence = (ComSequence*)cMap.value("sequence").value<void*>();
+        m_cFootprintTexts.insert(pcSequence, cMap.value("text").toString());
+    }
+}
+
+bool SequenceList::viewportEvent(QEvent* pcEvent)
+{
+    if( pcEvent->type() != QEvent::ToolTip )
+        return QListWidget::viewportEvent(pcEvent);
+
+    QHelpEvent* pcHelpEvent = static_cast<QHelpEvent*>(pcEvent);
+    QListWidgetItem* pcItem = itemAt(pcHelpEvent->pos());
+    SequenceListItem* pcSeqItem = pcItem ? qobject_cast<SequenceListItem*>(itemWidget(pcItem)) : NULL;
+    ComSequence* pcSequence = pcSeqItem ? pcSeqItem->getSequence() : NULL;
+    if( pcSequence == NULL )
+    {
+        QToolTip::hideText();
+        return true;
+    }
+
+    /// measured on every show, CU trees are loaded and released while browsing
+    m_cFootprintTexts.remove(pcSequence);
+    GitlIvkCmdEvt cRequest("query_memory");
+    cRequest.setParameter("sequence", QVariant::fromValue((void*)pcSequence));
+    cRequest.dispatch();
+    QString strText = m_cFootprintTexts.value(pcSequence);
+    if( strText.isEmpty() )
+        QToolTip::hideText();
+    else
+        QToolTip::showText(pcHelpEvent->globalPos(), strText, viewport());
+    return true;
+}
+
 void SequenceList::sequenceRadioButtonClicked(ComSequence* pcSequence)
 {
     GitlIvkCmdEvt cRequest("switch_sequence");
@@ -107,5 +154,6 @@ void SequenceList::closeSequenceButtonClicked(ComSequence *pcSequence)
 {
     GitlIvkCmdEvt cRequest("close_bitstream");
     cRequest.setParameter("sequence_path", QVariant::fromValue(pcSequence->getFileName()));
+    cRequest.setParameter("sequence", QVariant::fromValue((void*)pcSequence));
     cRequest.dispatch();
 }
@@ -5,6 +5,7 @@
 #include <QListWidget>
 #include <QButtonGroup>
 #include <QListWidgetItem>
+#include <QHash>
 #include "gitlview.h"
 #include "model/common/comsequence.h"
 #include "sequencelistitem.h"
@@ -21,10 +22,15 @@ class SequenceList : public QListWidget, public GitlView
 public:
     explicit SequenceList(QWidget *parent = 0);
     void onSequenceChanged(GitlUpdateUIEvt &rcEvt);
+    void onMemoryFootprint(GitlUpdateUIEvt &rcEvt);
     ~SequenceList();
 
     void addNoSquenceRadioBtn();
     void clearAllRadioBtn();
+
+protected:
+    /// the tooltip of a sequence is its memory footprint, queried when it is shown
+    bool viewportEvent(QEvent* pcEvent);
     
 private slots:
     void sequenceRadioButtonClicked(ComSequence* pcSequence);
@@ -33,6 +39,7 @@ private slots:
 private:
     Ui::SequenceList *ui;
     ADD_CLASS_FIELD_PRIVATE(QButtonGroup, cButtonGroup)
+    ADD_CLASS_FIELD_PRIVATE(QHash<ComSequence*, QString>, cFootprintTexts)    ///< last reported by query_memory
 };
 
 #endif // SEQUENCELIST_H
@@ -35,13 +35,29 @@ void TimeLineView::onSequenceChanged(GitlUpdateUIEvt &rcEvt)
 {
     /// Get current sequence
     ComSequence* pcCurSequence = (ComSequence*)(rcEvt.getParameter("current_sequence").value<void*>());
-    if(m_pcCurDrawnSeq!=pcCurSequence)  /// if sequence changed, clear and release all item on stage
+    int iTotalFrames = pcCurSequence->getFramesInDisOrder().size();
+    if( m_pcCurDrawnSeq == pcCurSequence && m_cFrameBars.size() < iTotalFrames )
+    {
+        /// a streamed (or followed) sequence got more frames, only their bars are added
+        /// as long as the bar height scale is still about right
+        int iLastMaxBit = m_iMaxBitForFrame;
+        xCalMaxBitForFrame(pcCurSequence);
+        if( m_iMaxBitForFrame <= iLastMaxBit*2 && m_iMaxBitForFrame*2 >= iLastMaxBit )
+        {
+            m_iMaxBitForFrame = iLastMaxBit;
+            xDrawFrameBars(pcCurSequence, m_cFrameBars.size());
+            return;
+        }
+    }
+    /// if sequence changed (or the scale of the streamed one), clear and release all item on stage
+    if( m_pcCurDrawnSeq != pcCurSequence ||
+        m_cFrameBars.size() != iTotalFrames )
     {
         m_pcCurDrawnSeq = pcCurSequence;
         xClearAllDrawing();
         xCalMaxBitForFrame(pcCurSequence);
         /// Draw bars
-        xDrawFrameBars(pcCurSequence);
+        xDrawFrameBars(pcCurSequence, 0);
     }
 
 }
@@ -96,14 +112,16 @@ void TimeLineView::wheelEvent(QWheelEvent * event)
     }
 }
 
-void TimeLineView::xDrawFrameBars(ComSequence* pcSequence)
+void TimeLineView::xDrawFrameBars(ComSequence* pcSequence, int iFirstFrame)
 {
     QRectF cRect(0,0,20,50);
-    int iCounter = 0;
+    int iCounter = iFirstFrame;
     int iGap = 2;
 
-    foreach(ComFrame* pcFrame, pcSequence->getFramesInDisOrder())
+    const QVector<ComFrame*>& rcFrames = pcSequence->getFramesInDisOrder();
+    for(int i = iFirstFrame; i < rcFrames.size(); i++)
     {
+        ComFrame* pcFrame = rcFrames[i];
         int iPercent = pcFrame->getBitCount()*100/m_iMaxBitForFrame;
         iPercent = VALUE_CLIP(0, 100, iPercent);
         TimeLineFrameItem* pRectItem = new TimeLineFrameItem(iPercent, pcFrame->getFrameCount());
@@ -130,11 +148,7 @@ void TimeLineView::xClearAllDrawing()
 void TimeLineView::xCalMaxBitForFrame(ComSequence* pcSequence)
 {
     // TODO not the real bit of frame (only the sum of LCUS)
-    int iTotalBit = 0;
-    foreach(ComFrame* pcFrame, pcSequence->getFramesInDisOrder())
-            iTotalBit += pcFrame->getBitCount();
-    int iTotalFrames = pcSequence->getFramesInDisOrder().size();
-    m_iMaxBitForFrame = iTotalBit/iTotalFrames;
+    m_iMaxBitForFrame = (int)pcSequence->getStatistics().dAvgFrameBits;
     if(m_iMaxBitForFrame == 0)  ///< avoid divide zero error
         ++m_iMaxBitForFrame;
     m_iMaxBitForFrame *= 5; ///< max bit is 5 times of avg bit
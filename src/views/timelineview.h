@@ -27,7 +27,8 @@ protected:
     void wheelEvent(QWheelEvent * event);
 
 private:
-    void xDrawFrameBars(ComSequence* pcSequence);
+    /// bars of the frames from iFirstFrame (displaying order) on
+    void xDrawFrameBars(ComSequence* pcSequence, int iFirstFrame);
     void xClearAllDrawing();
     void xCalMaxBitForFrame(ComSequence* pcSequence);
 